@@ -158,6 +158,12 @@ Matrix4 GenerateInverseView(const Camera &c) {
 }
 
 Vector3 CollisionDetection::Unproject(const Vector3& screenPos, const Camera& cam) {
+	Vector3 worldPos;
+	Unproject(&screenPos, &worldPos, 1, cam);
+	return worldPos;
+}
+
+void CollisionDetection::Unproject(const Vector3* screenPos, Vector3* worldPos, int count, const Camera& cam) {
 	Vector2 screenSize = Window::GetWindow()->GetScreenSize();
 
 	float aspect	= screenSize.x / screenSize.y;
@@ -166,27 +172,34 @@ Vector3 CollisionDetection::Unproject(const Vector3& screenPos, const Camera& ca
 	float farPlane  = cam.GetFarPlane();
 
 	//Create our inverted matrix! Note how that to get a correct inverse matrix,
-	//the order of matrices used to form it are inverted, too.
-	Matrix4 invVP = GenerateInverseView(cam) * GenerateInverseProjection(aspect, fov, nearPlane, farPlane);
+	//the order of matrices used to form it are inverted, too. The view matrix
+	//only rotates and moves things, so it can be flipped round directly.
+	Matrix4 invVP = cam.BuildViewMatrix().RigidInverse() * GenerateInverseProjection(aspect, fov, nearPlane, farPlane);
 
 	//Our mouse position x and y values are in 0 to screen dimensions range,
 	//so we need to turn them into the -1 to 1 axis range of clip space.
 	//We can do that by dividing the mouse values by the width and height of the
 	//screen (giving us a range of 0.0 to 1.0), multiplying by 2 (0.0 to 2.0)
 	//and then subtracting 1 (-1.0 to 1.0).
-	Vector4 clipSpace = Vector4(
-		(screenPos.x / (float)screenSize.x) * 2.0f - 1.0f,
-		(screenPos.y / (float)screenSize.y) * 2.0f - 1.0f,
-		(screenPos.z),
-		1.0f
-	);
+	std::vector<Vector4> clipSpace(count);
+	for (int i = 0; i < count; ++i) {
+		clipSpace[i] = Vector4(
+			(screenPos[i].x / (float)screenSize.x) * 2.0f - 1.0f,
+			(screenPos[i].y / (float)screenSize.y) * 2.0f - 1.0f,
+			(screenPos[i].z),
+			1.0f
+		);
+	}
 
-	//Then, we multiply our clipspace coordinate by our inverted matrix
-	Vector4 transformed = invVP * clipSpace;
+	//Then, we multiply our clipspace coordinates by our inverted matrix
+	invVP.TransformPoints(clipSpace.data(), clipSpace.data(), count);
 
 	//our transformed w coordinate is now the 'inverse' perspective divide, so
 	//we can reconstruct the final world space by dividing x,y,and z by w.
-	return Vector3(transformed.x / transformed.w, transformed.y / transformed.w, transformed.z / transformed.w);
+	for (int i = 0; i < count; ++i) {
+		const Vector4& transformed = clipSpace[i];
+		worldPos[i] = Vector3(transformed.x / transformed.w, transformed.y / transformed.w, transformed.z / transformed.w);
+	}
 }
 
 Ray CollisionDetection::BuildRayFromMouse(const Camera& cam) {
@@ -195,21 +208,22 @@ Ray CollisionDetection::BuildRayFromMouse(const Camera& cam) {
 
 	//We remove the y axis mouse position from height as OpenGL is 'upside down',
 	//and thinks the bottom left is the origin, instead of the top left!
-	Vector3 nearPos = Vector3(screenMouse.x,
+	Vector3 screenPos[2];
+	screenPos[0] = Vector3(screenMouse.x,
 		screenSize.y - screenMouse.y,
 		-0.99999f
 	);
 
 	//We also don't use exactly 1.0 (the normalised 'end' of the far plane) as this
 	//causes the unproject function to go a bit weird. 
-	Vector3 farPos = Vector3(screenMouse.x,
+	screenPos[1] = Vector3(screenMouse.x,
 		screenSize.y - screenMouse.y,
 		0.99999f
 	);
 
-	Vector3 a = Unproject(nearPos, cam);
-	Vector3 b = Unproject(farPos, cam);
-	Vector3 c = b - a;
+	Vector3 worldPos[2];
+	Unproject(screenPos, worldPos, 2, cam);
+	Vector3 c = worldPos[1] - worldPos[0];
 
 	c.Normalise();
 
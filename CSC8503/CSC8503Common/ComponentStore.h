@@ -0,0 +1,144 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		class GameObject;
+
+		/*
+		One type of component for every object in the world that has one,
+		packed together so that a system can run through them all without
+		hopping around the heap - a sparse set, indexed by the object's
+		handle slot.
+
+		The components move about as the store grows, and when one is
+		removed (the last one is moved into its place), so each owner's
+		pointer to its component is kept up to date through the setter the
+		store is given - that way GameObject::GetPhysicsObject and friends
+		keep working. Anything else holding on to component pointers should
+		check GetRevision, which changes whenever any component moves.
+		*/
+		template<typename T>
+		class ComponentStore {
+		public:
+			typedef void (GameObject::*OwnerSetter)(T*);
+
+			ComponentStore(OwnerSetter setter) : setter(setter), revision(0) {}
+			~ComponentStore() {}
+
+			bool Has(uint32_t slot) const {
+				return slot < sparse.size() && sparse[slot] >= 0;
+			}
+
+			T* Get(uint32_t slot) {
+				return Has(slot) ? &components[sparse[slot]] : nullptr;
+			}
+
+			T* Add(uint32_t slot, GameObject* owner, const T& component) {
+				if (slot >= sparse.size()) {
+					sparse.resize(slot + 1, -1);
+				}
+				const T* oldData = components.data();
+				sparse[slot] = (int)components.size();
+				components.emplace_back(component);
+				owners.emplace_back(owner);
+				slots.emplace_back(slot);
+
+				if (components.data() != oldData) {
+					RepointOwners();
+				}
+				else {
+					(owner->*setter)(&components.back());
+				}
+				return &components.back();
+			}
+
+			//Doesn't touch the removed component's owner - that's up to the caller
+			void Remove(uint32_t slot) {
+				if (!Has(slot)) {
+					return;
+				}
+				int index	= sparse[slot];
+				int last	= (int)components.size() - 1;
+				if (index != last) {
+					components[index]	= std::move(components[last]);
+					owners[index]		= owners[last];
+					slots[index]		= slots[last];
+					sparse[slots[index]] = index;
+					(owners[index]->*setter)(&components[index]);
+				}
+				components.pop_back();
+				owners.pop_back();
+				slots.pop_back();
+				sparse[slot] = -1;
+				revision++;
+			}
+
+			void Clear() {
+				components.clear();
+				owners.clear();
+				slots.clear();
+				sparse.clear();
+				revision++;
+			}
+
+			void Reserve(size_t count) {
+				const T* oldData = components.data();
+				components.reserve(count);
+				owners.reserve(count);
+				slots.reserve(count);
+				if (components.data() != oldData) {
+					RepointOwners();
+				}
+			}
+
+			size_t Size() const {
+				return components.size();
+			}
+
+			T& operator[](size_t i) {
+				return components[i];
+			}
+			const T& operator[](size_t i) const {
+				return components[i];
+			}
+
+			GameObject* GetOwner(size_t i) const {
+				return owners[i];
+			}
+
+			T* Data() {
+				return components.data();
+			}
+			GameObject* const* Owners() const {
+				return owners.data();
+			}
+
+			unsigned int GetRevision() const {
+				return revision;
+			}
+
+		protected:
+			ComponentStore(const ComponentStore&) = delete;
+			ComponentStore& operator=(const ComponentStore&) = delete;
+
+			//Everything has moved
+			void RepointOwners() {
+				for (size_t i = 0; i < components.size(); ++i) {
+					(owners[i]->*setter)(&components[i]);
+				}
+				revision++;
+			}
+
+			std::vector<T>				components;
+			std::vector<GameObject*>	owners;
+			std::vector<uint32_t>		slots;	//The handle slot of each component
+			std::vector<int>			sparse;	//Where each slot's component is, or -1
+
+			OwnerSetter		setter;
+			unsigned int	revision;
+		};
+	}
+}
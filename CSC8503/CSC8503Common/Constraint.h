@@ -2,12 +2,26 @@
 
 namespace NCL {
 	namespace CSC8503 {
+		enum class ConstraintType {
+			Generic,	//only solvable through UpdateConstraint
+			Position
+		};
+
 		class Constraint	{
 		public:
-			Constraint() {}
+			Constraint() {
+				type = ConstraintType::Generic;
+			}
 			virtual ~Constraint() {}
 
 			virtual void UpdateConstraint(float dt) = 0;
+
+			ConstraintType GetType() const {
+				return type;
+			}
+
+		protected:
+			ConstraintType type;
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "ConstraintSolver.h"
+#include "PositionConstraint.h"
+#include "GameWorld.h"
+#include "GameObject.h"
+#include "../../Common/JobSystem.h"
+#include "../../Common/Profiler.h"
+
+#include <unordered_map>
+#include <cstdint>
+
+using namespace NCL;
+using namespace CSC8503;
+
+//Each body keeps a bitmask of the batches it is already in
+const int maxColouredBatches = 64;
+
+//Below this, handing a batch out to other threads costs more than it saves
+const int minParallelBatchSize = 256;
+
+ConstraintSolver::ConstraintSolver()	{
+	worldRevision	= -1;
+	bodyRevision	= 0;
+	lastBatchSerial = false;
+	positionBatchStarts.emplace_back(0);
+}
+
+ConstraintSolver::~ConstraintSolver()	{
+}
+
+void ConstraintSolver::Clear() {
+	bodies.clear();
+	bodyPositions.clear();
+	bodyVelocities.clear();
+	bodyInverseMasses.clear();
+
+	positionConstraints.clear();
+	positionBatchStarts.clear();
+	positionBatchStarts.emplace_back(0);
+	genericConstraints.clear();
+
+	worldRevision	= -1;
+	lastBatchSerial = false;
+}
+
+/*
+
+A greedy colouring - each constraint goes into the first batch that neither
+of its bodies are in yet. The rare constraint whose bodies are already in all
+64 batches goes into one last batch, which is solved on a single thread.
+
+*/
+void ConstraintSolver::BuildBatches(const GameWorld& world) {
+	NCL_PROFILE_SCOPE("ConstraintSolver::BuildBatches");
+	Clear();
+	worldRevision	= world.GetConstraintRevision();
+	bodyRevision	= world.GetPhysicsObjects().GetRevision();
+
+	std::vector<Constraint*>::const_iterator first;
+	std::vector<Constraint*>::const_iterator last;
+	world.GetConstraintIterators(first, last);
+
+	std::unordered_map<const PhysicsObject*, int> bodyIndices;
+	std::vector<uint64_t> bodyBatches;
+
+	auto GetBodyIndex = [&](GameObject* o) {
+		auto i = bodyIndices.find(o->GetPhysicsObject());
+		if (i != bodyIndices.end()) {
+			return i->second;
+		}
+		SolverBody b;
+		b.transform = &o->GetTransform();
+		b.object	= o->GetPhysicsObject();
+		b.moveable	= b.object->GetInverseMass() > 0.0f;
+
+		int index = (int)bodies.size();
+		bodies.emplace_back(b);
+		bodyBatches.emplace_back(0);
+		bodyIndices.insert({ b.object, index });
+		return index;
+	};
+
+	std::vector<PositionConstraintData>	unsorted;
+	std::vector<int>					colours;
+
+	int batchSizes[maxColouredBatches + 1] = { 0 };
+
+	for (auto i = first; i != last; ++i) {
+		if ((*i)->GetType() != ConstraintType::Position) {
+			genericConstraints.emplace_back(*i);
+			continue;
+		}
+		PositionConstraint* c = (PositionConstraint*)(*i);
+
+		PositionConstraintData d;
+		d.bodyA		= GetBodyIndex(c->GetObjectA());
+		d.bodyB		= GetBodyIndex(c->GetObjectB());
+		d.distance	= c->GetDistance();
+
+		bool moveA = bodies[d.bodyA].moveable;
+		bool moveB = bodies[d.bodyB].moveable;
+
+		uint64_t used = (moveA ? bodyBatches[d.bodyA] : 0) | (moveB ? bodyBatches[d.bodyB] : 0);
+
+		int colour = 0;
+		while (colour < maxColouredBatches && (used & ((uint64_t)1 << colour))) {
+			colour++;
+		}
+		if (colour < maxColouredBatches) {
+			if (moveA) {
+				bodyBatches[d.bodyA] |= (uint64_t)1 << colour;
+			}
+			if (moveB) {
+				bodyBatches[d.bodyB] |= (uint64_t)1 << colour;
+			}
+		}
+		unsorted.emplace_back(d);
+		colours.emplace_back(colour);
+		batchSizes[colour]++;
+	}
+
+	//Counting sort the constraints into their batches
+	int batchStarts[maxColouredBatches + 1];
+	int offset = 0;
+	for (int i = 0; i <= maxColouredBatches; ++i) {
+		batchStarts[i] = offset;
+		offset += batchSizes[i];
+		if (batchSizes[i] > 0) {
+			positionBatchStarts.emplace_back(offset);
+		}
+	}
+	lastBatchSerial = batchSizes[maxColouredBatches] > 0;
+
+	positionConstraints.resize(unsorted.size());
+	for (size_t i = 0; i < unsorted.size(); ++i) {
+		positionConstraints[batchStarts[colours[i]]++] = unsorted[i];
+	}
+
+	bodyPositions.resize(bodies.size());
+	bodyVelocities.resize(bodies.size());
+	bodyInverseMasses.resize(bodies.size());
+}
+
+/*
+Positions don't change while the constraints are being solved, only
+velocities, so everything can be read in once per substep. If a body has
+become static (or stopped being static) since the batches were built,
+the colouring is no longer safe and has to be rebuilt.
+*/
+bool ConstraintSolver::GatherBodies() {
+	for (size_t i = 0; i < bodies.size(); ++i) {
+		const SolverBody& b = bodies[i];
+		float inverseMass = b.object->GetInverseMass();
+		if ((inverseMass > 0.0f) != b.moveable) {
+			return false;
+		}
+		bodyPositions[i]		= b.transform->GetPosition();
+		bodyVelocities[i]		= b.object->GetLinearVelocity();
+		bodyInverseMasses[i]	= inverseMass;
+	}
+	return true;
+}
+
+void ConstraintSolver::ScatterBodies() {
+	for (size_t i = 0; i < bodies.size(); ++i) {
+		if (bodies[i].moveable) {
+			bodies[i].object->SetLinearVelocity(bodyVelocities[i]);
+		}
+	}
+}
+
+void ConstraintSolver::SolvePositionBatch(const PositionConstraintData* constraints, int start, int end,
+	const Vector3* positions, Vector3* velocities, const float* inverseMasses, float dt) {
+	for (int i = start; i < end; ++i) {
+		const PositionConstraintData& c = constraints[i];
+		PositionConstraint::SolveDistance(
+			positions[c.bodyA], velocities[c.bodyA], inverseMasses[c.bodyA],
+			positions[c.bodyB], velocities[c.bodyB], inverseMasses[c.bodyB], c.distance, dt);
+	}
+}
+
+void ConstraintSolver::SolveConstraints(const GameWorld& world, float dt, int iterations) {
+	NCL_PROFILE_SCOPE("ConstraintSolver::SolveConstraints");
+	//The bodies' physics objects move about in the world's store as objects come and go
+	if (world.GetConstraintRevision() != worldRevision || world.GetPhysicsObjects().GetRevision() != bodyRevision) {
+		BuildBatches(world);
+	}
+	if (!GatherBodies()) {
+		BuildBatches(world);
+		GatherBodies();
+	}
+
+	int batchCount = GetBatchCount();
+	int numThreads = JobSystem::GetThreadCount();
+
+	const PositionConstraintData* constraints = positionConstraints.data();
+	const Vector3*	positions		= bodyPositions.data();
+	Vector3*		velocities		= bodyVelocities.data();
+	const float*	inverseMasses	= bodyInverseMasses.data();
+
+	for (int iteration = 0; iteration < iterations; ++iteration) {
+		for (int b = 0; b < batchCount; ++b) {
+			int start	= positionBatchStarts[b];
+			int end		= positionBatchStarts[b + 1];
+			bool serial = lastBatchSerial && b == batchCount - 1;
+
+			if (serial || numThreads < 2 || end - start < minParallelBatchSize) {
+				SolvePositionBatch(constraints, start, end, positions, velocities, inverseMasses, dt);
+				continue;
+			}
+			JobSystem::ParallelFor(start, end, minParallelBatchSize / 2,
+				[&](int chunkStart, int chunkEnd) {
+					SolvePositionBatch(constraints, chunkStart, chunkEnd, positions, velocities, inverseMasses, dt);
+				}
+			);
+		}
+		if (!genericConstraints.empty()) {
+			//These work directly on the objects, so they need to see (and keep) the latest velocities
+			ScatterBodies();
+			for (Constraint* c : genericConstraints) {
+				c->UpdateConstraint(dt);
+			}
+			GatherBodies();
+		}
+	}
+	ScatterBodies();
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+#include "../../Common/Vector3.h"
+#include <vector>
+
+using namespace NCL::Maths;
+
+namespace NCL {
+	namespace CSC8503 {
+		class GameWorld;
+		class Constraint;
+		class PhysicsObject;
+		class Transform;
+
+		/*
+		Solves the world's constraints in batches rather than one virtual call at
+		a time. Constraints are copied into flat arrays by type, and the bodies they
+		connect are gathered into flat position / velocity arrays once per substep,
+		so the solver iterations never have to chase pointers around the heap.
+
+		The constraints are then graph coloured so that no two constraints in the
+		same batch write to the same body - each batch can be spread across threads
+		without any locking. Static bodies are never written to, so they don't
+		count towards the colouring.
+		*/
+		class ConstraintSolver	{
+		public:
+			ConstraintSolver();
+			~ConstraintSolver();
+
+			void Clear();
+
+			//Runs 'iterations' passes over every constraint in the world
+			void SolveConstraints(const GameWorld& world, float dt, int iterations);
+
+			int GetBatchCount() const {
+				return (int)positionBatchStarts.size() - 1;
+			}
+
+		protected:
+			struct SolverBody {
+				const Transform*	transform;
+				PhysicsObject*		object;
+				bool				moveable;
+			};
+
+			struct PositionConstraintData {
+				int		bodyA;
+				int		bodyB;
+				float	distance;
+			};
+
+			void BuildBatches(const GameWorld& world);
+			bool GatherBodies();
+			void ScatterBodies();
+
+			static void SolvePositionBatch(const PositionConstraintData* constraints, int start, int end,
+				const Vector3* positions, Vector3* velocities, const float* inverseMasses, float dt);
+
+			std::vector<SolverBody>	bodies;
+			std::vector<Vector3>	bodyPositions;
+			std::vector<Vector3>	bodyVelocities;
+			std::vector<float>		bodyInverseMasses;
+
+			std::vector<PositionConstraintData> positionConstraints;	//sorted by batch
+			std::vector<int>					positionBatchStarts;	//one past the end is the final entry
+			std::vector<Constraint*>			genericConstraints;		//anything we don't have a batched solver for
+
+			int				worldRevision;
+			unsigned int	bodyRevision;
+			bool			lastBatchSerial;
+		};
+	}
+}
\ No newline at end of file
@@ -1,11 +1,16 @@
 #include "Debug.h"
 #include "../../Common/Matrix4.h"
+#include "../../Common/Profiler.h"
+#include <iomanip>
+#include <sstream>
 using namespace NCL;
 
-OGLRenderer* Debug::renderer = nullptr;
+RendererBase* Debug::renderer = nullptr;
 
-std::vector<Debug::DebugStringEntry>	Debug::stringEntries;
-std::vector<Debug::DebugLineEntry>		Debug::lineEntries;
+namespace {
+	Debug::Context	gameContext;
+	thread_local Debug::Context* threadContext = nullptr;
+}
 
 const Vector4 Debug::RED	= Vector4(1, 0, 0, 1);
 const Vector4 Debug::GREEN	= Vector4(0, 1, 0, 1);
@@ -22,11 +27,11 @@ const Vector4 Debug::CYAN		= Vector4(0, 1, 1, 1);
 void Debug::Print(const std::string& text, const Vector2&pos, const Vector4& colour) {
 	DebugStringEntry newEntry;
 
-	newEntry.data		= text;
+	newEntry.data.assign(text.c_str(), text.length());
 	newEntry.position	= pos;
 	newEntry.colour		= colour;
 
-	stringEntries.emplace_back(newEntry);
+	GetContext().stringEntries.Get().emplace_back(std::move(newEntry));
 }
 
 void Debug::DrawLine(const Vector3& startpoint, const Vector3& endpoint, const Vector4& colour, float time) {
@@ -37,7 +42,7 @@ void Debug::DrawLine(const Vector3& startpoint, const Vector3& endpoint, const V
 	newEntry.colour = colour;
 	newEntry.time	= time;
 
-	lineEntries.emplace_back(newEntry);
+	GetContext().lineEntries.emplace_back(newEntry);
 }
 
 void Debug::DrawAxisLines(const Matrix4& modelMatrix, float scaleBoost, float time) {
@@ -55,18 +60,64 @@ void Debug::DrawAxisLines(const Matrix4& modelMatrix, float scaleBoost, float ti
 	DrawLine(worldPos, worldPos + (fwd * scaleBoost)	, Debug::BLUE, time);
 }
 
+void Debug::PrintProfile(const Vector2& pos, int maxLines, const Vector4& colour) {
+	const float lineHeight = 3.0f;
 
-void Debug::FlushRenderables(float dt) {
-	if (!renderer) {
-		return;
+	std::stringstream text;
+	text << std::fixed << std::setprecision(2) << "Frame: " << Profiler::GetFrameTimeMS() << "ms";
+	Print(text.str(), pos, colour);
+
+	const std::vector<ProfileSummaryEntry>& entries = Profiler::GetFrameSummary();
+	int line	= 1;
+	int thread	= Profiler::GetMainThread();
+	for (const ProfileSummaryEntry& e : entries) {
+		if (line >= maxLines) {
+			break;
+		}
+		if (e.thread != thread) {
+			thread = e.thread;
+			Print("Thread " + std::to_string(thread) + ":", Vector2(pos.x, pos.y + lineHeight * line++), colour);
+			if (line >= maxLines) {
+				break;
+			}
+		}
+		text.str("");
+		text << std::string(e.depth * 2, ' ') << e.name << " " << e.totalMS << "ms";
+		if (e.calls > 1) {
+			text << " (x" << e.calls << ")";
+		}
+		Print(text.str(), Vector2(pos.x, pos.y + lineHeight * line++), colour);
 	}
-	for (const auto& i : stringEntries) {
-		renderer->DrawString(i.data, i.position);
+}
+
+Debug::Context* Debug::SetContext(Context* c) {
+	Context* previous = threadContext;
+	threadContext = c;
+	return previous;
+}
+
+Debug::Context& Debug::GetContext() {
+	return threadContext ? *threadContext : gameContext;
+}
+
+void Debug::FlushRenderables(float dt) {
+	Context& context = GetContext();
+	auto& stringEntries	= context.stringEntries.Get();
+	auto& lineEntries	= context.lineEntries;
+	//With no renderer set the entries are still aged out, so they can't pile up.
+	//Only the game's own are ever drawn, as any other is being flushed by a job
+	bool draw = renderer && &context == &gameContext;
+	if (draw) {
+		for (const auto& i : stringEntries) {
+			renderer->DrawString(i.data, i.position);
+		}
 	}
 	int trim = 0;
 	for (int i = 0; i < lineEntries.size(); ) {
 		DebugLineEntry* e = &lineEntries[i]; 
-		renderer->DrawLine(e->start, e->end, e->colour);
+		if (draw) {
+			renderer->DrawLine(e->start, e->end, e->colour);
+		}
 		e->time -= dt;
 		if (e->time < 0) {			
 			trim++;				
@@ -1,5 +1,6 @@
 #pragma once
-#include "../../Plugins/OpenGLRendering/OGLRenderer.h"
+#include "../../Common/RendererBase.h"
+#include "../../Common/Matrix4.h"
 #include <vector>
 #include <string>
 
@@ -12,12 +13,22 @@ namespace NCL {
 
 		static void DrawAxisLines(const Matrix4 &modelMatrix, float scaleBoost = 1.0f, float time = 0.0f);
 
-		static void SetRenderer(OGLRenderer* r) {
+		//Prints the Profiler's summary of the last frame, a line per scope, down from pos
+		static void PrintProfile(const Vector2& pos, int maxLines = 25, const Vector4& colour = Vector4(1, 1, 1, 1));
+
+		static void SetRenderer(RendererBase* r) {
 			renderer = r;
 		}
 
+		//Draws and ages out the lines and text of this thread's context
 		static void FlushRenderables(float dt);
 
+		class Context;
+		class ContextScope;
+
+		//Returns the context that was in use before - nullptr is the game's own
+		static Context* SetContext(Context* c);
+
 
 		static const Vector4 RED;
 		static const Vector4 GREEN;
@@ -32,7 +43,7 @@ namespace NCL {
 
 	protected:
 		struct DebugStringEntry {
-			std::string	data;
+			FrameString	data;
 			Vector2 position;
 			Vector4 colour;
 		};
@@ -47,10 +58,44 @@ namespace NCL {
 		Debug() {}
 		~Debug() {}
 
-		static std::vector<DebugStringEntry>	stringEntries;
-		static std::vector<DebugLineEntry>	lineEntries;
+		static Context& GetContext();
+
+		static RendererBase* renderer;
+	};
+
+	/*
+	Where the lines and text drawn on a thread go. Every thread uses the game's
+	own context unless it's given another, so a job stepping a world of its own
+	(see WorldBatch) swaps in that world's context for as long as it's working
+	on it, and nothing it draws ends up mixed in with another world's.
+	*/
+	class Debug::Context {
+	public:
+		Context()	{}
+		~Context()	{}
+
+	protected:
+		friend class Debug;
+
+		FrameLocal<FrameVector<DebugStringEntry>>	stringEntries;	//Only kept until the next flush
+		std::vector<DebugLineEntry>	lineEntries;
+	};
+
+	//Uses a context until it goes out of scope, and then whatever was in use before
+	class Debug::ContextScope {
+	public:
+		ContextScope(Context& c) {
+			previous = SetContext(&c);
+		}
+		~ContextScope() {
+			SetContext(previous);
+		}
+
+	protected:
+		ContextScope(const ContextScope&) = delete;
+		ContextScope& operator=(const ContextScope&) = delete;
 
-		static OGLRenderer* renderer;
+		Context* previous;
 	};
 }
 
@@ -1,5 +1,6 @@
 #include "GameObject.h"
 #include "CollisionDetection.h"
+#include "GameWorld.h"
 
 using namespace NCL::CSC8503;
 
@@ -11,6 +12,8 @@ GameObject::GameObject(string objectName)	{
 	physicsObject	= nullptr;
 	renderObject	= nullptr;
 	gOType			= GameObjectType::_NULL;
+	tags			= 0;
+	world			= nullptr;
 }
 
 GameObject::~GameObject()	{
@@ -51,6 +54,36 @@ void GameObject::UpdateBroadphaseAABB() {
 	}
 }
 
+void GameObject::SetType(GameObjectType type) {
+	if (type == gOType) {
+		return;
+	}
+	gOType = type;
+	if (world) {
+		world->ObjectTypeChanged(this);
+	}
+}
+
+void GameObject::AddTag(GameObjectTag tag) {
+	if (HasTag(tag)) {
+		return;
+	}
+	tags |= (1u << (int)tag);
+	if (world) {
+		world->ObjectTagsChanged(this);
+	}
+}
+
+void GameObject::RemoveTag(GameObjectTag tag) {
+	if (!HasTag(tag)) {
+		return;
+	}
+	tags &= ~(1u << (int)tag);
+	if (world) {
+		world->ObjectTagsChanged(this);
+	}
+}
+
 void GameObject::InitObjType() {
 	switch (gOType)
 	{
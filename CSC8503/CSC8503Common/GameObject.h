@@ -4,6 +4,7 @@
 
 #include "PhysicsObject.h"
 #include "RenderObject.h"
+#include "GameObjectHandle.h"
 
 #include <vector>
 
@@ -30,11 +31,23 @@ namespace NCL {
 			_AI,
 			_RESET_AI
 		};
+		const int NUM_GAME_OBJECT_TYPES = (int)GameObjectType::_RESET_AI + 1;
+
+		//Groups an object can be put in on top of its type, which collisions
+		//keep changing - a tag stays until it's taken off
+		enum class GameObjectTag
+		{
+			_PUSH_BLOCK = 0,
+			_BUMPER
+		};
+		const int MAX_GAME_OBJECT_TAGS = 32;
+
+		class GameWorld;
 
 		class GameObject	{
 		public:
 			GameObject(string name = "");
-			~GameObject();
+			virtual ~GameObject();
 
 			void SetBoundingVolume(CollisionVolume* vol) {
 				boundingVolume = vol;
@@ -72,7 +85,7 @@ namespace NCL {
 				return name;
 			}
 			
-			void SetName(string& str) {
+			void SetName(const string& str) {
 				this->name = str;
 			}
 
@@ -96,9 +109,45 @@ namespace NCL {
 				return worldID;
 			}
 
+			//Null while the object isn't in a world
+			GameObjectHandle GetHandle() const {
+				return handle;
+			}
+
+			void SetHandle(GameObjectHandle newHandle) {
+				handle = newHandle;
+			}
+
 			void InitObjType();
 
-			GameObjectType gOType;
+			GameObjectType GetType() const {
+				return gOType;
+			}
+
+			//Lets the world know, so its lists of each type stay right
+			void SetType(GameObjectType type);
+
+			bool HasTag(GameObjectTag tag) const {
+				return (tags & (1u << (int)tag)) != 0;
+			}
+
+			uint32_t GetTags() const {
+				return tags;
+			}
+
+			void AddTag(GameObjectTag tag);
+			void RemoveTag(GameObjectTag tag);
+
+			//Set by the world the object is in, so it can be told of changes
+			void SetWorld(GameWorld* newWorld) {
+				world = newWorld;
+			}
+
+			//Stays set while a removal is waiting to be applied, even though the handle doesn't
+			GameWorld* GetWorld() const {
+				return world;
+			}
+
 			bool springFired;
 		protected:
 			Transform			transform;
@@ -111,6 +160,12 @@ namespace NCL {
 			int		worldID;
 			string	name;
 
+			GameObjectHandle handle;
+			GameWorld*		 world;
+
+			GameObjectType	gOType;
+			uint32_t		tags;
+
 			Vector3 broadphaseAABB;
 		};
 	}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		A safe way to hang on to a GameObject - the world hands one out when
+		an object is added, and GameWorld::GetGameObject turns it back into a
+		pointer, or nullptr once the object has been removed. Each slot in the
+		world's table has a generation that goes up whenever its object is
+		removed, so an old handle can't pick up whatever gets the slot next.
+		*/
+		struct GameObjectHandle {
+			uint32_t index;
+			uint32_t generation;	//0 is never handed out, so means 'nothing'
+
+			GameObjectHandle() : index(0), generation(0) {}
+			GameObjectHandle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+
+			bool IsNull() const {
+				return generation == 0;
+			}
+
+			bool operator==(const GameObjectHandle& other) const {
+				return index == other.index && generation == other.generation;
+			}
+			bool operator!=(const GameObjectHandle& other) const {
+				return !(*this == other);
+			}
+		};
+	}
+}
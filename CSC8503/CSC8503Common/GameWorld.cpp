@@ -3,54 +3,530 @@
 #include "Constraint.h"
 #include "CollisionDetection.h"
 #include "../../Common/Camera.h"
+#include "../../Common/JobSystem.h"
+#include "../../Common/Profiler.h"
 #include <algorithm>
+#include <cfloat>
 
 using namespace NCL;
 using namespace NCL::CSC8503;
 
-GameWorld::GameWorld()	{
+namespace {
+	//Skips 0 on the way round, as no handle ever has that
+	uint32_t NextGeneration(uint32_t generation) {
+		return (generation == UINT32_MAX) ? 1 : generation + 1;
+	}
+}
+
+GameWorld::GameWorld() : physicsStore(&GameObject::SetPhysicsObject), renderStore(&GameObject::SetRenderObject) {
 	mainCamera = new Camera();
 
 	shuffleConstraints	= false;
 	shuffleObjects		= false;
 	worldIDCounter		= 0;
+	constraintRevision	= 0;
+	freeSlot			= UINT32_MAX;
+	deferDepth			= 0;
 }
 
+//The objects come out of the world's own pools, so they have to go before the pools do
 GameWorld::~GameWorld()	{
+	ClearAndErase();
+	delete mainCamera;
 }
 
 void GameWorld::Clear() {
-	gameObjects.clear();
+	ClearObjects(true);
 	constraints.clear();
+	constraintRevision++;
+	hierarchy.Clear();
 }
 
 void GameWorld::ClearAndErase() {
-	for (auto& i : gameObjects) {
-		delete i;
+	ApplyChanges();
+	std::vector<GameObject*> objects(gameObjects);
+	std::vector<Constraint*> oldConstraints(constraints);
+	ClearObjects(false); //No point copying the components out just to delete them
+	constraints.clear();
+	constraintRevision++;
+	hierarchy.Clear();
+	for (auto& i : objects) {
+		DestroyGameObject(i);
 	}
-	for (auto& i : constraints) {
+	for (auto& i : oldConstraints) {
 		delete i;
 	}
-	Clear();
+}
+
+void GameWorld::ClearObjects(bool keepComponents) {
+	ApplyChanges();
+	for (auto& l : removalListeners) {
+		l.second(gameObjects);
+	}
+	if (keepComponents) {
+		for (size_t i = 0; i < physicsStore.Size(); ++i) {
+			physicsStore.GetOwner(i)->SetPhysicsObject(physicsPool.New(physicsStore[i]));
+		}
+		for (size_t i = 0; i < renderStore.Size(); ++i) {
+			renderStore.GetOwner(i)->SetRenderObject(renderPool.New(renderStore[i]));
+		}
+	}
+	else {
+		for (GameObject* o : gameObjects) {
+			o->SetPhysicsObject(nullptr);
+			o->SetRenderObject(nullptr);
+		}
+	}
+	physicsStore.Clear();
+	renderStore.Clear();
+
+	//Every slot is retired rather than the table being emptied, so that
+	//handles from before the clear can't match anything added after it
+	for (uint32_t i = 0; i < objectSlots.size(); ++i) {
+		if (objectSlots[i].object) {
+			objectSlots[i].object->SetHandle(GameObjectHandle());
+			objectSlots[i].generation = NextGeneration(objectSlots[i].generation);
+			FreeSlot(i);
+		}
+	}
+	gameObjects.clear();
+	gameObjectSlots.clear();
+	for (ObjectGroup& g : typeGroups) {
+		g.Clear();
+	}
+	for (ObjectGroup& g : tagGroups) {
+		g.Clear();
+	}
 }
 
 void GameWorld::ClearForces() {
-	for (auto& i : gameObjects) {
-		i->GetPhysicsObject()->ClearForces();
-		i->GetPhysicsObject()->SetLinearVelocity(Vector3(0,0,0));
+	for (size_t i = 0; i < physicsStore.Size(); ++i) {
+		physicsStore[i].ClearForces();
+		physicsStore[i].SetLinearVelocity(Vector3(0,0,0));
 	}
 }
 
-void GameWorld::AddGameObject(GameObject* o) {
-	gameObjects.emplace_back(o);
+GameObjectHandle GameWorld::AddGameObject(GameObject* o) {
+	if (!o->GetHandle().IsNull()) {
+		return o->GetHandle(); //Already in here
+	}
+	if (o->GetWorld() == this) {
+		GameObjectHandle h = CancelRemoval(o);
+		if (!h.IsNull()) {
+			return h;
+		}
+	}
+	uint32_t slot = freeSlot;
+	if (slot != UINT32_MAX) {
+		freeSlot = objectSlots[slot].nextFree;
+	}
+	else {
+		slot = (uint32_t)objectSlots.size();
+		objectSlots.emplace_back();
+	}
+	objectSlots[slot].object = o;
+
+	GameObjectHandle h(slot, objectSlots[slot].generation);
+	o->SetHandle(h);
+	o->SetWorld(this);
 	o->SetWorldID(worldIDCounter++);
+
+	if (deferDepth > 0) {
+		pendingAdds.emplace_back(slot);
+	}
+	else {
+		AddToList(slot);
+	}
+	return h;
 }
 
 void GameWorld::RemoveGameObject(GameObject* o, bool andDelete) {
-	gameObjects.erase(std::remove(gameObjects.begin(), gameObjects.end(), o), gameObjects.end());
-	if (andDelete) {
-		delete o;
+	GameObjectHandle h = o->GetHandle();
+	if (h.IsNull() || GetGameObject(h) != o) {
+		//Already on its way out, so it's deleted then, along with the rest
+		PendingRemoval* r = (o->GetWorld() == this) ? FindPendingRemoval(o) : nullptr;
+		if (r) {
+			r->andDelete |= andDelete;
+			return;
+		}
+		if (andDelete) { //Never added, or already removed
+			DestroyGameObject(o);
+		}
+		return;
+	}
+	//The handle dies now, but the slot is kept until the object is out of
+	//the list, as that's how we find where it is in the list
+	objectSlots[h.index].generation = NextGeneration(h.generation);
+	o->SetHandle(GameObjectHandle());
+
+	pendingRemovals.push_back({ h.index, h.generation, o, andDelete });
+	if (deferDepth == 0) {
+		ApplyChanges();
+	}
+}
+
+/*
+Taken out and put back before the changes were applied, so it never really
+left - it keeps its slot, its place in the list and its components, and
+handles to it from before it was taken out work again.
+*/
+GameObjectHandle GameWorld::CancelRemoval(GameObject* o) {
+	PendingRemoval* r = FindPendingRemoval(o);
+	if (!r) {
+		return GameObjectHandle();
+	}
+	GameObjectHandle h(r->slot, r->generation);
+	objectSlots[r->slot].generation = r->generation;
+	o->SetHandle(h);
+	pendingRemovals.erase(pendingRemovals.begin() + (r - pendingRemovals.data()));
+	return h;
+}
+
+//The newest first, as it's most likely to be the one just removed
+GameWorld::PendingRemoval* GameWorld::FindPendingRemoval(GameObject* o) {
+	for (size_t i = pendingRemovals.size(); i > 0; --i) {
+		if (pendingRemovals[i - 1].object == o) {
+			return &pendingRemovals[i - 1];
+		}
 	}
+	return nullptr;
+}
+
+void GameWorld::RemoveGameObject(GameObjectHandle h, bool andDelete) {
+	GameObject* o = GetGameObject(h);
+	if (o) {
+		RemoveGameObject(o, andDelete);
+	}
+}
+
+void GameWorld::BeginDeferringChanges() {
+	deferDepth++;
+}
+
+void GameWorld::EndDeferringChanges() {
+	if (--deferDepth == 0) {
+		ApplyChanges();
+	}
+}
+
+/*
+Adds go first, so that something added and then removed before the changes
+are applied still gets a list entry to be swapped out of.
+*/
+void GameWorld::ApplyChanges() {
+	if (pendingAdds.empty() && pendingRemovals.empty()) {
+		return;
+	}
+	for (uint32_t slot : pendingAdds) {
+		AddToList(slot);
+	}
+	pendingAdds.clear();
+
+	removedObjects.clear();
+	for (const PendingRemoval& r : pendingRemovals) {
+		RemoveFromList(r.slot, !r.andDelete);
+		FreeSlot(r.slot);
+		hierarchy.Remove(&r.object->GetTransform());
+		removedObjects.emplace_back(r.object);
+	}
+	for (auto& l : removalListeners) {
+		l.second(removedObjects);
+	}
+	for (const PendingRemoval& r : pendingRemovals) {
+		if (r.andDelete) {
+			DestroyGameObject(r.object);
+		}
+	}
+	pendingRemovals.clear();
+	removedObjects.clear();
+}
+
+void GameWorld::AddRemovalListener(const void* owner, const GameObjectListFunc& f) {
+	removalListeners.emplace_back(owner, f);
+}
+
+void GameWorld::RemoveRemovalListeners(const void* owner) {
+	removalListeners.erase(std::remove_if(removalListeners.begin(), removalListeners.end(),
+		[owner](const std::pair<const void*, GameObjectListFunc>& l) { return l.first == owner; }),
+		removalListeners.end());
+}
+
+namespace {
+	template<typename T, typename P>
+	void DeletePooled(T* t, P& pool) {
+		if (pool.Owns(t)) {
+			pool.Delete(t);
+		}
+		else {
+			delete t;
+		}
+	}
+}
+
+//The object's components are moved into the stores, and the originals freed
+void GameWorld::AddToList(uint32_t slot) {
+	GameObject* o = objectSlots[slot].object;
+	objectSlots[slot].listIndex = (int)gameObjects.size();
+	gameObjects.emplace_back(o);
+	gameObjectSlots.emplace_back(slot);
+	AddToGroups(slot);
+
+	if (PhysicsObject* p = o->GetPhysicsObject()) {
+		physicsStore.Add(slot, o, *p);
+		DeletePooled(p, physicsPool);
+	}
+	if (RenderObject* r = o->GetRenderObject()) {
+		renderStore.Add(slot, o, *r);
+		DeletePooled(r, renderPool);
+	}
+}
+
+//Swap and pop - the last object fills the gap. The object gets its own
+//copies of its components back, unless it's about to be deleted anyway
+void GameWorld::RemoveFromList(uint32_t slot, bool keepComponents) {
+	int index = objectSlots[slot].listIndex;
+	if (index < 0) {
+		return;
+	}
+	GameObject* o = gameObjects[index];
+	RemoveFromGroups(slot);
+	if (PhysicsObject* p = physicsStore.Get(slot)) {
+		o->SetPhysicsObject(keepComponents ? physicsPool.New(*p) : nullptr);
+		physicsStore.Remove(slot);
+	}
+	if (RenderObject* r = renderStore.Get(slot)) {
+		o->SetRenderObject(keepComponents ? renderPool.New(*r) : nullptr);
+		renderStore.Remove(slot);
+	}
+	SwapInList(index, (int)gameObjects.size() - 1);
+	gameObjects.pop_back();
+	gameObjectSlots.pop_back();
+	objectSlots[slot].listIndex = -1;
+}
+
+void GameWorld::SwapInList(int a, int b) {
+	std::swap(gameObjects[a], gameObjects[b]);
+	std::swap(gameObjectSlots[a], gameObjectSlots[b]);
+	objectSlots[gameObjectSlots[a]].listIndex = a;
+	objectSlots[gameObjectSlots[b]].listIndex = b;
+}
+
+void GameWorld::FreeSlot(uint32_t slot) {
+	ObjectSlot& s = objectSlots[slot];
+	s.object->SetWorld(nullptr);
+	s.object	= nullptr;
+	s.listIndex	= -1;
+	s.nextFree	= freeSlot;
+	freeSlot	= slot;
+}
+
+/*
+The groups an object is in are remembered in its slot, as they're what it
+has to be taken out of - the object's type may well have changed since
+*/
+void GameWorld::AddToGroups(uint32_t slot) {
+	ObjectSlot& s = objectSlots[slot];
+	s.listedType = s.object->GetType();
+	s.listedTags = s.object->GetTags();
+	typeGroups[(int)s.listedType].Add(slot, s.object);
+	for (int i = 0; i < MAX_GAME_OBJECT_TAGS; ++i) {
+		if (s.listedTags & (1u << i)) {
+			tagGroups[i].Add(slot, s.object);
+		}
+	}
+}
+
+void GameWorld::RemoveFromGroups(uint32_t slot) {
+	ObjectSlot& s = objectSlots[slot];
+	typeGroups[(int)s.listedType].Remove(slot);
+	for (int i = 0; i < MAX_GAME_OBJECT_TAGS; ++i) {
+		if (s.listedTags & (1u << i)) {
+			tagGroups[i].Remove(slot);
+		}
+	}
+	s.listedTags = 0;
+}
+
+//Objects not in the list yet get put in their groups when they go in, and
+//ones on their way out are left where they are until they're gone
+void GameWorld::ObjectTypeChanged(GameObject* o) {
+	GameObjectHandle h = o->GetHandle();
+	if (GetGameObject(h) != o || objectSlots[h.index].listIndex < 0) {
+		return;
+	}
+	ObjectSlot& s = objectSlots[h.index];
+	typeGroups[(int)s.listedType].Remove(h.index);
+	s.listedType = o->GetType();
+	typeGroups[(int)s.listedType].Add(h.index, o);
+}
+
+void GameWorld::ObjectTagsChanged(GameObject* o) {
+	GameObjectHandle h = o->GetHandle();
+	if (GetGameObject(h) != o || objectSlots[h.index].listIndex < 0) {
+		return;
+	}
+	ObjectSlot& s = objectSlots[h.index];
+	uint32_t changed = s.listedTags ^ o->GetTags();
+	for (int i = 0; i < MAX_GAME_OBJECT_TAGS; ++i) {
+		if (changed & (1u << i)) {
+			if (s.listedTags & (1u << i)) {
+				tagGroups[i].Remove(h.index);
+			}
+			else {
+				tagGroups[i].Add(h.index, o);
+			}
+		}
+	}
+	s.listedTags = o->GetTags();
+}
+
+void GameWorld::ObjectGroup::Add(uint32_t slot, GameObject* o) {
+	if (slot >= sparse.size()) {
+		sparse.resize(slot + 1, -1);
+	}
+	sparse[slot] = (int)objects.size();
+	objects.emplace_back(o);
+	slots.emplace_back(slot);
+}
+
+void GameWorld::ObjectGroup::Remove(uint32_t slot) {
+	if (slot >= sparse.size() || sparse[slot] < 0) {
+		return;
+	}
+	int index	= sparse[slot];
+	int last	= (int)objects.size() - 1;
+	if (index != last) {
+		objects[index]	= objects[last];
+		slots[index]	= slots[last];
+		sparse[slots[index]] = index;
+	}
+	objects.pop_back();
+	slots.pop_back();
+	sparse[slot] = -1;
+}
+
+void GameWorld::ObjectGroup::Clear() {
+	objects.clear();
+	slots.clear();
+	sparse.clear();
+}
+
+GameObject* GameWorld::CreateGameObject(const string& name) {
+	return objectPool.New(name);
+}
+
+SphereVolume* GameWorld::CreateSphereVolume(float radius) {
+	return spherePool.New(radius);
+}
+
+AABBVolume* GameWorld::CreateAABBVolume(const Vector3& halfDims) {
+	return aabbPool.New(halfDims);
+}
+
+OBBVolume* GameWorld::CreateOBBVolume(const Vector3& halfDims) {
+	return obbPool.New(halfDims);
+}
+
+CapsuleVolume* GameWorld::CreateCapsuleVolume(float halfHeight, float radius) {
+	return capsulePool.New(halfHeight, radius);
+}
+
+/*
+Objects already in the list get theirs straight in the store - replacing
+one that's already there
+*/
+PhysicsObject* GameWorld::CreatePhysicsObject(GameObject* o) {
+	PhysicsObject p(&o->GetTransform(), o->GetBoundingVolume());
+	GameObjectHandle h = o->GetHandle();
+	if (GetGameObject(h) == o && objectSlots[h.index].listIndex >= 0) {
+		if (PhysicsObject* old = physicsStore.Get(h.index)) {
+			*old = p;
+			return old;
+		}
+		return physicsStore.Add(h.index, o, p);
+	}
+	PhysicsObject* pooled = physicsPool.New(p);
+	o->SetPhysicsObject(pooled);
+	return pooled;
+}
+
+RenderObject* GameWorld::CreateRenderObject(GameObject* o, MeshGeometry* mesh, TextureBase* texture, ShaderBase* shader) {
+	RenderObject r(&o->GetTransform(), mesh, texture, shader);
+	GameObjectHandle h = o->GetHandle();
+	if (GetGameObject(h) == o && objectSlots[h.index].listIndex >= 0) {
+		if (RenderObject* old = renderStore.Get(h.index)) {
+			*old = r;
+			return old;
+		}
+		return renderStore.Add(h.index, o, r);
+	}
+	RenderObject* pooled = renderPool.New(r);
+	o->SetRenderObject(pooled);
+	return pooled;
+}
+
+GameObject* GameWorld::CreateObject(const string& name, CollisionVolume* volume,
+	MeshGeometry* mesh, TextureBase* texture, ShaderBase* shader) {
+	GameObject* o = CreateGameObject(name);
+	o->SetBoundingVolume(volume);
+	CreatePhysicsObject(o);
+	if (mesh) {
+		CreateRenderObject(o, mesh, texture, shader);
+	}
+	return o;
+}
+
+/*
+The parts are taken off the object before it goes, so that the GameObject
+destructor only ever deletes things that weren't from a pool.
+*/
+void GameWorld::DestroyGameObject(GameObject* o) {
+	if (!o) {
+		return;
+	}
+	if (GetGameObject(o->GetHandle()) == o) {
+		RemoveGameObject(o, true); //Still in here, so it has to come out first
+		return;
+	}
+	CollisionVolume* volume = const_cast<CollisionVolume*>(o->GetBoundingVolume());
+	if (volume) {
+		switch (volume->type) {
+			case VolumeType::Sphere:	DeletePooled((SphereVolume*)volume, spherePool);	break;
+			case VolumeType::AABB:		DeletePooled((AABBVolume*)volume, aabbPool);		break;
+			case VolumeType::OBB:		DeletePooled((OBBVolume*)volume, obbPool);			break;
+			case VolumeType::Capsule:	DeletePooled((CapsuleVolume*)volume, capsulePool);	break;
+			default:					delete volume;										break;
+		}
+		o->SetBoundingVolume(nullptr);
+	}
+	DeletePooled(o->GetPhysicsObject(), physicsPool);
+	o->SetPhysicsObject(nullptr);
+	DeletePooled(o->GetRenderObject(), renderPool);
+	o->SetRenderObject(nullptr);
+
+	DeletePooled(o, objectPool);
+}
+
+void GameWorld::ReservePools(size_t objectCount) {
+	ReserveObjects(objectCount);
+	physicsPool.Reserve(objectCount);
+	renderPool.Reserve(objectCount);
+}
+
+void GameWorld::ReserveObjects(size_t objectCount) {
+	objectSlots.reserve(objectSlots.size() + objectCount);
+	gameObjects.reserve(gameObjects.size() + objectCount);
+	gameObjectSlots.reserve(gameObjectSlots.size() + objectCount);
+	objectPool.Reserve(objectCount);
+	physicsStore.Reserve(physicsStore.Size() + objectCount);
+	renderStore.Reserve(renderStore.Size() + objectCount);
+}
+
+void GameWorld::ReserveVolumePools(size_t spheres, size_t aabbs, size_t obbs, size_t capsules) {
+	spherePool.Reserve(spheres);
+	aabbPool.Reserve(aabbs);
+	obbPool.Reserve(obbs);
+	capsulePool.Reserve(capsules);
 }
 
 void GameWorld::GetObjectIterators(
@@ -62,29 +538,110 @@ void GameWorld::GetObjectIterators(
 }
 
 void GameWorld::OperateOnContents(GameObjectFunc f) {
+	DeferScope defer(*this);
 	for (GameObject* g : gameObjects) {
 		f(g);
 	}
 }
 
+void GameWorld::UpdateTransforms() {
+	NCL_PROFILE_SCOPE("GameWorld::UpdateTransforms");
+	dirtyTransforms.clear();
+	for (GameObject* g : gameObjects) {
+		Transform& t = g->GetTransform();
+		if (t.IsMatrixDirty()) {
+			dirtyTransforms.emplace_back(&t);
+		}
+	}
+	//Chunks are kept to a multiple of 4, so that every group of 4 is the same
+	//however many threads there are
+	Transform* const* transforms = dirtyTransforms.data();
+	JobSystem::ParallelFor(0, (int)dirtyTransforms.size(), 512,
+		[transforms](int start, int end) {
+			Transform::UpdateMatrices(transforms + start, end - start);
+		}
+	);
+}
+
+bool GameWorld::AttachToParent(GameObject* child, GameObject* parent, const Vector3& localPosition,
+	const Quaternion& localOrientation, bool inheritOrientation) {
+	return hierarchy.Attach(&child->GetTransform(), &parent->GetTransform(), localPosition, localOrientation, inheritOrientation);
+}
+
+void GameWorld::DetachFromParent(GameObject* child) {
+	hierarchy.Detach(&child->GetTransform());
+}
+
+void GameWorld::UpdateHierarchy() {
+	NCL_PROFILE_SCOPE("GameWorld::UpdateHierarchy");
+	hierarchy.Update();
+}
+
 void GameWorld::UpdateWorld(float dt) {
 	if (shuffleObjects) {
-		std::random_shuffle(gameObjects.begin(), gameObjects.end());
+		//Same as std::shuffle, but keeping the slots in step
+		for (int i = (int)gameObjects.size() - 1; i > 0; --i) {
+			SwapInList(i, (int)(shuffleRandom() % (i + 1)));
+		}
 	}
 
 	if (shuffleConstraints) {
-		std::random_shuffle(constraints.begin(), constraints.end());
+		std::shuffle(constraints.begin(), constraints.end(), shuffleRandom);
 	}
 }
 
-bool GameWorld::Raycast(Ray& r, RayCollision& closestCollision, bool closestObject) const {
-	//The simplest raycast just goes through each object and sees if there's a collision
-	RayCollision collision;
+namespace {
+	//A box that the volume fits inside whichever way round it's turned, with a
+	//bit of room to spare so the exact tests' own leeway can't poke out of it
+	Vector3 GetRayBounds(const CollisionVolume& volume) {
+		const float padding = 0.01f;
+		switch (volume.type) {
+			case VolumeType::AABB:
+				return ((const AABBVolume&)volume).GetHalfDimensions() + Vector3(padding, padding, padding);
+			case VolumeType::OBB: {
+				float r = ((const OBBVolume&)volume).GetHalfDimensions().Length() + padding;
+				return Vector3(r, r, r);
+			}
+			case VolumeType::Sphere: {
+				float r = ((const SphereVolume&)volume).GetRadius() + padding;
+				return Vector3(r, r, r);
+			}
+			case VolumeType::Capsule: {
+				float r = ((const CapsuleVolume&)volume).GetRadius() + ((const CapsuleVolume&)volume).GetHalfHeight() + padding;
+				return Vector3(r, r, r);
+			}
+			default:
+				//Meshes and compounds have no cheap bound, so the box lets the
+				//ray through everywhere, and the exact test decides
+				return Vector3(1e30f, 1e30f, 1e30f);
+		}
+	}
+}
 
+bool GameWorld::Raycast(Ray& r, RayCollision& closestCollision, bool closestObject) const {
+	NCL_PROFILE_SCOPE("GameWorld::Raycast");
+	//The simplest raycast just goes through each object and sees if there's a collision -
+	//but first the SIMD kernel slab tests a box around every object, so that only
+	//objects the ray might actually touch get the proper test
+	rayBoxes.Clear();
+	rayObjects.clear();
 	for (auto& i : gameObjects) {
 		if (!i->GetBoundingVolume()) { //objects might not be collideable etc...
 			continue;
 		}
+		rayBoxes.Add(i->GetTransform().GetPosition(), GetRayBounds(*i->GetBoundingVolume()));
+		rayObjects.emplace_back(i);
+	}
+	rayHits.resize(rayObjects.size());
+	rayHitDistances.resize(rayObjects.size());
+	size_t hitCount = SIMD::RayAABBs(r.GetPosition(), r.GetDirection(), FLT_MAX, rayBoxes, rayHits.data(), rayHitDistances.data());
+
+	RayCollision collision;
+
+	//The hits come back in the same order as the objects, so the first hit is
+	//still the first object in the world that the ray touches
+	for (size_t h = 0; h < hitCount; ++h) {
+		GameObject* i = rayObjects[rayHits[h]];
 		RayCollision thisCollision;
 		if (CollisionDetection::RayIntersection(r, *i, thisCollision)) {
 				
@@ -116,10 +673,12 @@ Constraint Tutorial Stuff
 
 void GameWorld::AddConstraint(Constraint* c) {
 	constraints.emplace_back(c);
+	constraintRevision++;
 }
 
 void GameWorld::RemoveConstraint(Constraint* c, bool andDelete) {
 	constraints.erase(std::remove(constraints.begin(), constraints.end(), c), constraints.end());
+	constraintRevision++;
 	if (andDelete) {
 		delete c;
 	}
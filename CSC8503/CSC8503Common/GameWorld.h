@@ -1,8 +1,15 @@
 #pragma once
 #include <vector>
+#include <random>
 #include "Ray.h"
 #include "CollisionDetection.h"
 #include "QuadTree.h"
+#include "TransformHierarchy.h"
+#include "GameObject.h"
+#include "GameObjectHandle.h"
+#include "ComponentStore.h"
+#include "../../Common/SIMDKernels.h"
+#include "../../Common/ObjectPool.h"
 namespace NCL {
 		class Camera;
 		using Maths::Ray;
@@ -11,6 +18,7 @@ namespace NCL {
 		class Constraint;
 
 		typedef std::function<void(GameObject*)> GameObjectFunc;
+		typedef std::function<void(const std::vector<GameObject*>&)> GameObjectListFunc;
 		typedef std::vector<GameObject*>::const_iterator GameObjectIterator;
 
 		class GameWorld	{
@@ -22,8 +30,113 @@ namespace NCL {
 			void ClearAndErase();
 			void ClearForces();
 
-			void AddGameObject(GameObject* o);
+			/*
+			Both are O(1). While changes are being deferred (see below), an added
+			object can be found from its handle straight away but isn't in the
+			object list until the changes are applied, and a removed object's
+			handle stops working straight away, but it stays in the list (and
+			alive) until then. Adding it back before then cancels the removal
+			(even one that would have deleted it), and its old handle works
+			again, and removing it again only adds the delete, if asked for -
+			those two cases search the held back removals.
+			*/
+			GameObjectHandle AddGameObject(GameObject* o);
 			void RemoveGameObject(GameObject* o, bool andDelete = false);
+			void RemoveGameObject(GameObjectHandle h, bool andDelete = false);
+
+			//nullptr if the object has been removed since the handle was made
+			GameObject* GetGameObject(GameObjectHandle h) const {
+				if (h.index >= objectSlots.size() || objectSlots[h.index].generation != h.generation) {
+					return nullptr;
+				}
+				return objectSlots[h.index].object;
+			}
+
+			/*
+			Between these, adds and removes are held back, so that anything
+			going through the object list - the physics, the renderer, or
+			gameplay code - can add and remove objects without pulling the
+			list out from under itself. They nest, and the outermost End
+			applies the changes.
+			*/
+			void BeginDeferringChanges();
+			void EndDeferringChanges();
+
+			bool IsDeferringChanges() const {
+				return deferDepth > 0;
+			}
+
+			//Applies any held back adds and removes right now
+			void ApplyChanges();
+
+			//Told about each batch of removed objects, before any are deleted.
+			//The owner is just so they can be taken away again
+			void AddRemovalListener(const void* owner, const GameObjectListFunc& f);
+			void RemoveRemovalListeners(const void* owner);
+
+			struct DeferScope {
+				DeferScope(GameWorld& world) : world(world) {
+					world.BeginDeferringChanges();
+				}
+				~DeferScope() {
+					world.EndDeferringChanges();
+				}
+				GameWorld& world;
+			};
+
+			/*
+			Object building from the world's pools, instead of new - once the
+			pools have grown to fit, spawning and despawning things doesn't
+			touch the heap. Objects made this way still need AddGameObject, and
+			must be deleted by the world (RemoveGameObject with andDelete, or
+			DestroyGameObject), never with delete.
+			*/
+			GameObject*		CreateGameObject(const string& name = "");
+			SphereVolume*	CreateSphereVolume(float radius);
+			AABBVolume*		CreateAABBVolume(const Vector3& halfDims);
+			OBBVolume*		CreateOBBVolume(const Vector3& halfDims);
+			CapsuleVolume*	CreateCapsuleVolume(float halfHeight, float radius);
+
+			//Sets the object's physics / render object to a new pooled one
+			PhysicsObject*	CreatePhysicsObject(GameObject* o);
+			RenderObject*	CreateRenderObject(GameObject* o, MeshGeometry* mesh, TextureBase* texture, ShaderBase* shader);
+
+			//An object along with its volume, physics object and (if given a
+			//mesh) render object, all in one go
+			GameObject* CreateObject(const string& name, CollisionVolume* volume,
+				MeshGeometry* mesh = nullptr, TextureBase* texture = nullptr, ShaderBase* shader = nullptr);
+
+			//Deletes an object that isn't in the world - its parts go back to
+			//their pools, or are deleted if they didn't come from one
+			void DestroyGameObject(GameObject* o);
+
+			//Gets the pools ready for this many more objects
+			void ReservePools(size_t objectCount);
+			//Just the objects and the component stores, for objects that go in
+			//the world before their components are made, so never use the
+			//physics and render object pools
+			void ReserveObjects(size_t objectCount);
+			//And for this many more of each volume
+			void ReserveVolumePools(size_t spheres, size_t aabbs, size_t obbs, size_t capsules);
+
+			/*
+			The physics and render objects of everything in the world's object
+			list, packed together for the systems that run over all of them.
+			Objects get moved in here when they go in the list, and back out to
+			the pools when they leave it, so an object's component pointer is
+			only good until the next add or remove is applied. Components given
+			to an object already in the world must come from CreatePhysicsObject
+			and CreateRenderObject, or they won't end up in here.
+			*/
+			ComponentStore<PhysicsObject>& GetPhysicsObjects() {
+				return physicsStore;
+			}
+			const ComponentStore<PhysicsObject>& GetPhysicsObjects() const {
+				return physicsStore;
+			}
+			const ComponentStore<RenderObject>& GetRenderObjects() const {
+				return renderStore;
+			}
 
 			void AddConstraint(Constraint* c);
 			void RemoveConstraint(Constraint* c, bool andDelete = false);
@@ -32,10 +145,48 @@ namespace NCL {
 				return mainCamera;
 			}
 
-			std::vector<GameObject*> GetGameObjects() {
+			const std::vector<GameObject*>& GetGameObjects() const {
 				return gameObjects;
 			}
 
+			/*
+			Everything in the object list, grouped by type and by tag. The
+			groups are kept up to date as objects go in and out of the list,
+			and as their types and tags change, so there's no need to go
+			through every object to find one kind. Nothing is copied, and the
+			order within a group isn't fixed.
+			*/
+			const std::vector<GameObject*>& GetObjectsOfType(GameObjectType type) const {
+				return typeGroups[(int)type].objects;
+			}
+			const std::vector<GameObject*>& GetObjectsWithTag(GameObjectTag tag) const {
+				return tagGroups[(int)tag].objects;
+			}
+
+			size_t CountOfType(GameObjectType type) const {
+				return GetObjectsOfType(type).size();
+			}
+
+			size_t CountWithTag(GameObjectTag tag) const {
+				return GetObjectsWithTag(tag).size();
+			}
+
+			//f can change the type of the object it's given, but not of the
+			//others, as that moves them around in the group
+			template<typename F>
+			void ForEachOfType(GameObjectType type, const F& f) const {
+				ForEachInGroup(GetObjectsOfType(type), f);
+			}
+
+			template<typename F>
+			void ForEachWithTag(GameObjectTag tag, const F& f) const {
+				ForEachInGroup(GetObjectsWithTag(tag), f);
+			}
+
+			//Called by GameObject when its type or tags change
+			void ObjectTypeChanged(GameObject* o);
+			void ObjectTagsChanged(GameObject* o);
+
 			void ShuffleConstraints(bool state) {
 				shuffleConstraints = state;
 			}
@@ -44,6 +195,12 @@ namespace NCL {
 				shuffleObjects = state;
 			}
 
+			//Each world shuffles with its own generator, so worlds stepped
+			//side by side don't share (or fight over) rand's state
+			void SetShuffleSeed(unsigned int seed) {
+				shuffleRandom.seed(seed);
+			}
+
 			bool Raycast(Ray& r, RayCollision& closestCollision, bool closestObject = false) const;
 
 			virtual void UpdateWorld(float dt);
@@ -58,21 +215,127 @@ namespace NCL {
 				std::vector<Constraint*>::const_iterator& first,
 				std::vector<Constraint*>::const_iterator& last) const;
 
+			//Changes whenever a constraint is added or removed
+			int GetConstraintRevision() const {
+				return constraintRevision;
+			}
+
 
 			bool GetBroadphaseAABB(Vector3& outsize) const;
 			void UpdateBroadphaseAABB();
 
+			//Rebuilds every out of date transform matrix in one go - call
+			//before rendering, so the renderer doesn't rebuild them one by one
+			void UpdateTransforms();
+
+			//Makes 'child' follow 'parent' around, at an offset in the parent's space
+			bool AttachToParent(GameObject* child, GameObject* parent, const Vector3& localPosition,
+				const Quaternion& localOrientation = Quaternion(), bool inheritOrientation = true);
+			void DetachFromParent(GameObject* child);
+
+			TransformHierarchy& GetTransformHierarchy() {
+				return hierarchy;
+			}
+
+			//Moves every attached object to follow its parent - call after
+			//anything that moves objects, such as the physics update
+			void UpdateHierarchy();
+
 		protected:
+			struct ObjectSlot {
+				GameObject*	object		= nullptr;
+				uint32_t	generation	= 1;
+				int			listIndex	= -1;	//Where it is in gameObjects, if it's there yet
+				uint32_t	nextFree	= 0;
+				GameObjectType	listedType	= GameObjectType::_NULL; //Which groups it's in, while it's in the list
+				uint32_t		listedTags	= 0;
+			};
+
+			//Same idea as a ComponentStore, but just the objects
+			struct ObjectGroup {
+				std::vector<GameObject*>	objects;
+				std::vector<uint32_t>		slots;
+				std::vector<int>			sparse;
+
+				void Add(uint32_t slot, GameObject* o);
+				void Remove(uint32_t slot);
+				void Clear();
+			};
+
+			//Backwards, so that the object being visited can leave the group
+			//without anything being skipped
+			template<typename F>
+			static void ForEachInGroup(const std::vector<GameObject*>& objects, const F& f) {
+				for (size_t i = objects.size(); i > 0; --i) {
+					if (i <= objects.size()) {
+						f(objects[i - 1]);
+					}
+				}
+			}
+
+			void AddToGroups(uint32_t slot);
+			void RemoveFromGroups(uint32_t slot);
+
+			struct PendingRemoval {
+				uint32_t	slot;
+				uint32_t	generation;	//Of the handle it had, for if it's put back
+				GameObject*	object;
+				bool		andDelete;
+			};
+
+			PendingRemoval* FindPendingRemoval(GameObject* o);
+			GameObjectHandle CancelRemoval(GameObject* o);
+			void AddToList(uint32_t slot);
+			void RemoveFromList(uint32_t slot, bool keepComponents);
+			void ClearObjects(bool keepComponents);
+			void SwapInList(int a, int b);
+			void FreeSlot(uint32_t slot);
+
 			std::vector<GameObject*> gameObjects;
+			std::vector<uint32_t>	 gameObjectSlots;	//The slot of each of gameObjects
 			std::vector<Constraint*> constraints;
 
 			Camera* mainCamera;
 
 			bool	shuffleConstraints;
 			bool	shuffleObjects;
+			std::minstd_rand shuffleRandom;
 			int		worldIDCounter;
+			int		constraintRevision;
 
 			Vector3 broadphaseAABB;
+
+			std::vector<Transform*> dirtyTransforms;
+
+			TransformHierarchy hierarchy;
+
+			//Scratch space for Raycast, kept around to save reallocating it every call
+			mutable SIMD::AABBArray				rayBoxes;
+			mutable std::vector<GameObject*>	rayObjects;
+			mutable std::vector<int>			rayHits;
+			mutable std::vector<float>			rayHitDistances;
+
+			std::vector<ObjectSlot>		objectSlots;
+			uint32_t					freeSlot;
+			int							deferDepth;
+			std::vector<uint32_t>		pendingAdds;
+			std::vector<PendingRemoval>	pendingRemovals;
+			std::vector<GameObject*>	removedObjects;
+			std::vector<std::pair<const void*, GameObjectListFunc>> removalListeners;
+
+			ObjectGroup	typeGroups[NUM_GAME_OBJECT_TYPES];
+			ObjectGroup	tagGroups[MAX_GAME_OBJECT_TAGS];
+
+			ComponentStore<PhysicsObject>	physicsStore;
+			ComponentStore<RenderObject>	renderStore;
+
+			ObjectPool<GameObject>		objectPool;
+			ObjectPool<PhysicsObject>	physicsPool;
+			ObjectPool<RenderObject>	renderPool;
+			ObjectPool<SphereVolume>	spherePool;
+			ObjectPool<AABBVolume>		aabbPool;
+			ObjectPool<OBBVolume>		obbPool;
+			ObjectPool<CapsuleVolume>	capsulePool;
 		};
 	}
 }
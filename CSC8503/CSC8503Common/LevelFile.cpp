@@ -0,0 +1,378 @@
+#include "LevelFile.h"
+#include "GameWorld.h"
+#include "../../Common/ByteStream.h"
+#include <fstream>
+#include <map>
+#include <type_traits>
+
+using namespace NCL;
+using namespace CSC8503;
+
+namespace {
+	const uint32_t levelMagic	= 0x4c564c4e; //"NLVL"
+	const uint32_t levelVersion	= 2;
+
+	struct LevelHeader {
+		uint32_t	magic;
+		uint32_t	version;
+		uint32_t	objectCount;
+		uint32_t	tableCount;
+		uint32_t	nameCount;
+		uint32_t	nameBytes;	//Each name ends with a 0
+	};
+
+	//The tables and names are copied whole, and the objects field by field
+	template<typename T>
+	void WriteArray(ByteWriter& writer, const std::vector<T>& v) {
+		static_assert(std::is_trivially_copyable<T>::value, "Rows copied whole have to be trivially copyable");
+		writer.WriteBytes(v.data(), v.size() * sizeof(T));
+	}
+
+	template<typename T>
+	bool ReadArray(ByteReader& reader, uint32_t count, std::vector<T>& v) {
+		static_assert(std::is_trivially_copyable<T>::value, "Rows copied whole have to be trivially copyable");
+		if (reader.GetRemaining() < count * sizeof(T)) {
+			return false;
+		}
+		v.resize(count);
+		return reader.ReadBytes(v.data(), count * sizeof(T));
+	}
+
+	const size_t objectBytes = 24 * sizeof(float) + 2 * sizeof(int32_t) + 4 * sizeof(int16_t) + 2 * sizeof(uint8_t);
+
+	void WriteObject(ByteWriter& writer, const LevelFile::Object& o) {
+		writer.Write(o.position);
+		writer.Write(o.orientation);
+		writer.Write(o.scale);
+		writer.Write(o.volumeSize);
+		writer.Write(o.colour);
+		writer.Write(o.classData);
+		writer.Write(o.inverseMass);
+		writer.Write(o.elasticity);
+		writer.Write(o.friction);
+		writer.Write(o.tags);
+		writer.Write(o.name);
+		writer.Write(o.mesh);
+		writer.Write(o.texture);
+		writer.Write(o.shader);
+		writer.Write(o.volume);
+		writer.Write(o.objectClass);
+		writer.Write(o.hasRenderObject);
+	}
+
+	void ReadObject(ByteReader& reader, LevelFile::Object& o) {
+		reader.Read(o.position);
+		reader.Read(o.orientation);
+		reader.Read(o.scale);
+		reader.Read(o.volumeSize);
+		reader.Read(o.colour);
+		reader.Read(o.classData);
+		reader.Read(o.inverseMass);
+		reader.Read(o.elasticity);
+		reader.Read(o.friction);
+		reader.Read(o.tags);
+		reader.Read(o.name);
+		reader.Read(o.mesh);
+		reader.Read(o.texture);
+		reader.Read(o.shader);
+		reader.Read(o.volume);
+		reader.Read(o.objectClass);
+		reader.Read(o.hasRenderObject);
+	}
+
+	template<typename T>
+	int16_t FindID(const std::vector<T*>& list, const T* item) {
+		if (!item) {
+			return -1;
+		}
+		for (size_t i = 0; i < list.size(); ++i) {
+			if (list[i] == item) {
+				return (int16_t)i;
+			}
+		}
+		return -1;
+	}
+
+	template<typename T>
+	T* FromID(const std::vector<T*>& list, int16_t id) {
+		return (id >= 0 && id < (int)list.size()) ? list[id] : nullptr;
+	}
+
+	CollisionVolume* CreateVolume(GameWorld& world, const LevelFile::Object& o) {
+		switch ((VolumeType)o.volume) {
+			case VolumeType::Sphere:	return (CollisionVolume*)world.CreateSphereVolume(o.volumeSize.x);
+			case VolumeType::AABB:		return (CollisionVolume*)world.CreateAABBVolume(o.volumeSize);
+			case VolumeType::OBB:		return (CollisionVolume*)world.CreateOBBVolume(o.volumeSize);
+			case VolumeType::Capsule:	return (CollisionVolume*)world.CreateCapsuleVolume(o.volumeSize.x, o.volumeSize.y);
+			default:					return nullptr;
+		}
+	}
+}
+
+void LevelFile::Clear() {
+	objects.clear();
+	tables.clear();
+	names.clear();
+	sphereCount		= 0;
+	aabbCount		= 0;
+	obbCount		= 0;
+	capsuleCount	= 0;
+}
+
+void LevelFile::CountVolumes() {
+	sphereCount		= 0;
+	aabbCount		= 0;
+	obbCount		= 0;
+	capsuleCount	= 0;
+	for (const Object& o : objects) {
+		switch ((VolumeType)o.volume) {
+			case VolumeType::Sphere:	sphereCount++;	break;
+			case VolumeType::AABB:		aabbCount++;	break;
+			case VolumeType::OBB:		obbCount++;		break;
+			case VolumeType::Capsule:	capsuleCount++;	break;
+			default:									break;
+		}
+	}
+}
+
+size_t LevelFile::Capture(const GameWorld& world, const Bindings& bindings) {
+	return Capture(world.GetGameObjects(), bindings);
+}
+
+/*
+Objects are sorted into their tables as they're captured, so each table
+keeps them in the order they were given in.
+*/
+size_t LevelFile::Capture(const std::vector<GameObject*>& worldObjects, const Bindings& bindings) {
+	Clear();
+	std::vector<Object> byType[NUM_GAME_OBJECT_TYPES];
+	std::map<std::string, int32_t> nameIDs;
+
+	for (GameObject* g : worldObjects) {
+		const CollisionVolume* volume = g->GetBoundingVolume();
+		if (volume && volume->type != VolumeType::Sphere && volume->type != VolumeType::AABB &&
+			volume->type != VolumeType::OBB && volume->type != VolumeType::Capsule) {
+			continue;
+		}
+		Object o = {};
+		Transform& transform = g->GetTransform();
+		o.position		= transform.GetPosition();
+		o.orientation	= transform.GetOrientation();
+		o.scale			= transform.GetScale();
+		o.tags			= g->GetTags();
+		o.mesh			= -1;
+		o.texture		= -1;
+		o.shader		= -1;
+		o.volume		= volume ? (uint16_t)volume->type : 0;
+
+		if (volume) {
+			switch (volume->type) {
+				case VolumeType::Sphere:	o.volumeSize = Vector3(((const SphereVolume*)volume)->GetRadius(), 0, 0);	break;
+				case VolumeType::AABB:		o.volumeSize = ((const AABBVolume*)volume)->GetHalfDimensions();			break;
+				case VolumeType::OBB:		o.volumeSize = ((const OBBVolume*)volume)->GetHalfDimensions();				break;
+				default:
+					o.volumeSize = Vector3(((const CapsuleVolume*)volume)->GetHalfHeight(), ((const CapsuleVolume*)volume)->GetRadius(), 0);
+					break;
+			}
+		}
+		if (const PhysicsObject* p = g->GetPhysicsObject()) {
+			o.inverseMass	= p->GetInverseMass();
+			o.elasticity	= p->GetElasticity();
+			o.friction		= p->GetFriction();
+		}
+		if (const RenderObject* r = g->GetRenderObject()) {
+			o.hasRenderObject	= 1;
+			o.colour			= r->GetColour();
+			o.mesh				= FindID(bindings.meshes, r->GetMesh());
+			o.texture			= FindID(bindings.textures, r->GetDefaultTexture());
+			o.shader			= FindID(bindings.shaders, r->GetShader());
+		}
+		if (bindings.describe) {
+			bindings.describe(*g, o);
+		}
+		auto name = nameIDs.find(g->GetName());
+		if (name == nameIDs.end()) {
+			name = nameIDs.emplace(g->GetName(), (int32_t)names.size()).first;
+			names.emplace_back(g->GetName());
+		}
+		o.name = name->second;
+
+		byType[(int)g->GetType()].emplace_back(o);
+	}
+	for (int i = 0; i < NUM_GAME_OBJECT_TYPES; ++i) {
+		if (byType[i].empty()) {
+			continue;
+		}
+		Table t;
+		t.type	= (GameObjectType)i;
+		t.first	= (uint32_t)objects.size();
+		t.count	= (uint32_t)byType[i].size();
+		tables.emplace_back(t);
+		objects.insert(objects.end(), byType[i].begin(), byType[i].end());
+	}
+	CountVolumes();
+	return objects.size();
+}
+
+/*
+The pools and stores are grown to fit first, so nothing is allocated a
+piece at a time. Each object goes into the world before its components are
+made, so they're made straight into the world's component stores, rather
+than from the pools and then moved into the stores.
+*/
+size_t LevelFile::AddToWorld(GameWorld& world, const Bindings& bindings, std::vector<GameObject*>* added) const {
+	world.ReserveObjects(objects.size());
+	world.ReserveVolumePools(sphereCount, aabbCount, obbCount, capsuleCount);
+	if (added) {
+		added->reserve(added->size() + objects.size());
+	}
+	const std::string noName;
+
+	for (const Table& t : tables) {
+		for (uint32_t i = t.first; i < t.first + t.count; ++i) {
+			const Object& o = objects[i];
+			const std::string& name = (o.name >= 0 && o.name < (int32_t)names.size()) ? names[o.name] : noName;
+
+			GameObject* g = nullptr;
+			if (o.objectClass != 0 && bindings.create) {
+				g = bindings.create(o, name);
+			}
+			if (!g) {
+				g = world.CreateGameObject(name);
+			}
+			g->SetBoundingVolume(CreateVolume(world, o));
+			g->GetTransform()
+				.SetPosition(o.position)
+				.SetScale(o.scale)
+				.SetOrientation(o.orientation);
+
+			g->SetType(t.type);
+			for (uint32_t tags = o.tags; tags != 0; tags &= tags - 1) {
+				int bit = 0;
+				while (!(tags & (1u << bit))) {
+					bit++;
+				}
+				g->AddTag((GameObjectTag)bit);
+			}
+			world.AddGameObject(g);
+
+			if (o.hasRenderObject) {
+				RenderObject* r = world.CreateRenderObject(g, FromID(bindings.meshes, o.mesh),
+					FromID(bindings.textures, o.texture), FromID(bindings.shaders, o.shader));
+				r->SetColour(o.colour);
+			}
+			PhysicsObject* p = world.CreatePhysicsObject(g);
+			p->SetInverseMass(o.inverseMass);
+			p->SetElasticity(o.elasticity);
+			p->SetFriction(o.friction);
+			if ((VolumeType)o.volume == VolumeType::Sphere) {
+				p->InitSphereInertia();
+			}
+			else {
+				p->InitCubeInertia();
+			}
+
+			if (added) {
+				added->emplace_back(g);
+			}
+		}
+	}
+	return objects.size();
+}
+
+size_t LevelFile::GetByteSize() const {
+	size_t nameBytes = 0;
+	for (const std::string& n : names) {
+		nameBytes += n.size() + 1;
+	}
+	return sizeof(LevelHeader) + tables.size() * sizeof(Table) + nameBytes + objects.size() * objectBytes;
+}
+
+//Written in the machine's own byte order, so it's only for reading back on the same kind of machine
+void LevelFile::Write(std::vector<char>& out) const {
+	std::vector<char> nameData;
+	for (const std::string& n : names) {
+		nameData.insert(nameData.end(), n.c_str(), n.c_str() + n.size() + 1);
+	}
+	LevelHeader header;
+	header.magic		= levelMagic;
+	header.version		= levelVersion;
+	header.objectCount	= (uint32_t)objects.size();
+	header.tableCount	= (uint32_t)tables.size();
+	header.nameCount	= (uint32_t)names.size();
+	header.nameBytes	= (uint32_t)nameData.size();
+
+	out.reserve(out.size() + GetByteSize());
+	ByteWriter writer(out);
+	writer.Write(header);
+	WriteArray(writer, tables);
+	WriteArray(writer, nameData);
+	for (const Object& o : objects) {
+		WriteObject(writer, o);
+	}
+}
+
+bool LevelFile::Read(const char* data, size_t size) {
+	Clear();
+	ByteReader reader(data, size);
+	LevelHeader header;
+	if (!reader.Read(header) || header.magic != levelMagic || header.version != levelVersion) {
+		return false;
+	}
+	std::vector<char> nameData;
+	if (!ReadArray(reader, header.tableCount, tables) ||
+		!ReadArray(reader, header.nameBytes, nameData) ||
+		reader.GetRemaining() < header.objectCount * objectBytes) {
+		Clear();
+		return false;
+	}
+	objects.resize(header.objectCount);
+	for (Object& o : objects) {
+		ReadObject(reader, o);
+	}
+	for (const Table& t : tables) {
+		if ((int)t.type < 0 || (int)t.type >= NUM_GAME_OBJECT_TYPES || t.first > header.objectCount || t.count > header.objectCount - t.first) {
+			Clear();
+			return false;
+		}
+	}
+	names.reserve(header.nameCount);
+	size_t start = 0;
+	for (size_t i = 0; i < nameData.size() && names.size() < header.nameCount; ++i) {
+		if (nameData[i] == 0) {
+			names.emplace_back(&nameData[start], i - start);
+			start = i + 1;
+		}
+	}
+	CountVolumes();
+	return true;
+}
+
+bool LevelFile::Save(const std::string& filename) const {
+	std::ofstream file(filename, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	std::vector<char> data;
+	Write(data);
+	file.write(data.data(), data.size());
+	return file.good();
+}
+
+//The whole file is read in one go, and then unpacked into the tables
+bool LevelFile::Load(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	std::streamoff size = file.tellg();
+	if (size <= 0) {
+		return false;
+	}
+	std::vector<char> data((size_t)size);
+	file.seekg(0, std::ios::beg);
+	if (!file.read(data.data(), size)) {
+		return false;
+	}
+	return Read(data.data(), data.size());
+}
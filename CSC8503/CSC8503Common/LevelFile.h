@@ -0,0 +1,118 @@
+#pragma once
+#include "GameObject.h"
+#include "../../Common/Quaternion.h"
+#include "../../Common/Vector4.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace NCL {
+	class MeshGeometry;
+	namespace CSC8503 {
+		class GameWorld;
+
+		/*
+		A level saved as flat tables of objects, one per GameObjectType, so
+		that it can be read in with a single read, and built with one pass
+		over each table - the world is grown to fit up front, and
+		each object's components are made straight into the world's stores -
+		rather than one Add*ToWorld call at a time.
+
+		Meshes, textures and shaders are saved as IDs, which are just where
+		they are in the Bindings given to Capture and AddToWorld, so the same
+		file loads headless with no meshes at all. Objects that are more than
+		a plain GameObject (spring blocks, the AI) are saved with a class ID
+		and a Vector4 of data, which the Bindings' functions make sense of.
+		*/
+		class LevelFile {
+		public:
+			struct Object {
+				Vector3		position;
+				Quaternion	orientation;
+				Vector3		scale;
+				Vector3		volumeSize;	//Half dimensions, or the radius in x, or a capsule's half height and radius in x and y
+				Vector4		colour;
+				Vector4		classData;	//Whatever the object's class needs
+				float		inverseMass;
+				float		elasticity;
+				float		friction;
+				uint32_t	tags;
+				int32_t		name;		//Into the level's names
+				int16_t		mesh;		//-1 for none
+				int16_t		texture;
+				int16_t		shader;
+				uint16_t	volume;		//A VolumeType, or 0 for none
+				uint8_t		objectClass; //0 for a plain GameObject
+				uint8_t		hasRenderObject;
+			};
+
+			//All the objects of one type, which are together in the level's objects
+			struct Table {
+				GameObjectType	type;
+				uint32_t		first;
+				uint32_t		count;
+			};
+
+			struct Bindings {
+				std::vector<MeshGeometry*>	meshes;
+				std::vector<TextureBase*>	textures;
+				std::vector<ShaderBase*>	shaders;
+
+				//Fills in the class ID and data of an object that isn't a plain GameObject
+				std::function<void(const GameObject&, Object&)> describe;
+				//Makes an object of a class ID other than 0 - its volume, transform
+				//and components are all filled in after, same as a plain one
+				std::function<GameObject*(const Object&, const std::string& name)> create;
+			};
+
+			void Clear();
+
+			/*
+			Everything in the world's object list, as it is right now. Meshes,
+			textures and shaders not in the bindings are saved as none, and
+			objects with a mesh or compound volume are left out. Returns how
+			many objects were saved.
+			*/
+			size_t Capture(const GameWorld& world, const Bindings& bindings);
+			//Just these objects, rather than the whole world
+			size_t Capture(const std::vector<GameObject*>& worldObjects, const Bindings& bindings);
+
+			/*
+			Adds everything in the level to the world, and into added if it's
+			given, in the order they're in the level - by type, and then in the
+			order they were captured. Returns how many were added.
+			*/
+			size_t AddToWorld(GameWorld& world, const Bindings& bindings, std::vector<GameObject*>* added = nullptr) const;
+
+			size_t GetObjectCount() const {
+				return objects.size();
+			}
+
+			const std::vector<Table>& GetTables() const {
+				return tables;
+			}
+
+			size_t GetByteSize() const;
+
+			//Appends the level to out
+			void Write(std::vector<char>& out) const;
+			//False if data doesn't hold a whole level
+			bool Read(const char* data, size_t size);
+
+			bool Save(const std::string& filename) const;
+			bool Load(const std::string& filename);
+
+		protected:
+			void CountVolumes();
+
+			std::vector<Object>			objects;
+			std::vector<Table>			tables;
+			std::vector<std::string>	names;
+			//How many of each volume there are, to grow the world's pools by
+			uint32_t	sphereCount		= 0;
+			uint32_t	aabbCount		= 0;
+			uint32_t	obbCount		= 0;
+			uint32_t	capsuleCount	= 0;
+		};
+	}
+}
@@ -10,6 +10,14 @@ namespace NCL {
 	namespace CSC8503 {
 		class Transform;
 
+		//How often a body is stepped, decided by its distance from the camera
+		enum class PhysicsLOD {
+			Full = 0,	//every substep
+			Half,		//every 2nd substep, with twice the timestep
+			Quarter,	//every 4th substep, with four times the timestep
+			Frozen		//not moved at all until the camera gets closer
+		};
+
 		class PhysicsObject	{
 		public:
 			PhysicsObject(Transform* parentTransform, const CollisionVolume* parentVolume);
@@ -84,6 +92,14 @@ namespace NCL {
 				return inverseInteriaTensor;
 			}
 
+			PhysicsLOD GetLOD() const {
+				return lod;
+			}
+
+			void SetLOD(PhysicsLOD l) {
+				lod = l;
+			}
+
 		protected:
 			const CollisionVolume* volume;
 			Transform*		transform;
@@ -92,6 +108,8 @@ namespace NCL {
 			float elasticity;
 			float friction;
 
+			PhysicsLOD lod;
+
 			//linear stuff
 			Vector3 linearVelocity;
 			Vector3 force;
@@ -0,0 +1,125 @@
+#include "PhysicsSnapshot.h"
+#include "../../Common/ByteStream.h"
+
+using namespace NCL;
+using namespace CSC8503;
+
+namespace {
+	const uint32_t snapshotMagic = 0x50534e50; //"PNSP"
+
+	struct SnapshotHeader {
+		uint32_t	magic;
+		uint32_t	bodyCount;
+		uint32_t	contactCount;
+		uint32_t	particleCount;
+		float		timeOffset;
+		float		fixedDT;
+		int32_t		lodSubstep;
+		uint32_t	isDelta;
+	};
+
+	//Each record's size once written - field by field, so without any padding
+	const size_t handleBytes	= 2 * sizeof(uint32_t);
+	const size_t bodyBytes		= handleBytes + 13 * sizeof(float) + sizeof(int32_t);
+	const size_t contactBytes	= 2 * handleBytes + sizeof(int32_t) + 10 * sizeof(float);
+	const size_t particleBytes	= 6 * sizeof(float);
+}
+
+void PhysicsSnapshot::Clear() {
+	bodies.clear();
+	contacts.clear();
+	particles.clear();
+	timeOffset	= 0.0f;
+	fixedDT		= 0.0f;
+	lodSubstep	= 0;
+	isDelta		= false;
+}
+
+size_t PhysicsSnapshot::GetByteSize() const {
+	return sizeof(SnapshotHeader) + bodies.size() * bodyBytes + contacts.size() * contactBytes + particles.size() * particleBytes;
+}
+
+//Written in the machine's own byte order, so it's only for reading back on the same kind of machine
+void PhysicsSnapshot::Write(std::vector<char>& out) const {
+	SnapshotHeader header;
+	header.magic			= snapshotMagic;
+	header.bodyCount		= (uint32_t)bodies.size();
+	header.contactCount		= (uint32_t)contacts.size();
+	header.particleCount	= (uint32_t)particles.size();
+	header.timeOffset		= timeOffset;
+	header.fixedDT			= fixedDT;
+	header.lodSubstep		= lodSubstep;
+	header.isDelta			= isDelta ? 1 : 0;
+
+	out.reserve(out.size() + GetByteSize());
+	ByteWriter writer(out);
+	writer.Write(header);
+	for (const Body& b : bodies) {
+		writer.Write(b.object);
+		writer.Write(b.position);
+		writer.Write(b.orientation);
+		writer.Write(b.linearVelocity);
+		writer.Write(b.angularVelocity);
+		writer.Write((int32_t)b.lod);
+	}
+	for (const Contact& c : contacts) {
+		writer.Write(c.a);
+		writer.Write(c.b);
+		writer.Write((int32_t)c.framesLeft);
+		writer.Write(c.point.localA);
+		writer.Write(c.point.localB);
+		writer.Write(c.point.normal);
+		writer.Write(c.point.penetration);
+	}
+	for (const Particle& p : particles) {
+		writer.Write(p.position);
+		writer.Write(p.velocity);
+	}
+}
+
+bool PhysicsSnapshot::Read(const char* data, size_t size) {
+	ByteReader reader(data, size);
+	SnapshotHeader header;
+	if (!reader.Read(header) || header.magic != snapshotMagic) {
+		return false;
+	}
+	//Checked up front, so the records can be read without checking each
+	size_t needed = (size_t)header.bodyCount * bodyBytes + (size_t)header.contactCount * contactBytes + (size_t)header.particleCount * particleBytes;
+	if (reader.GetRemaining() < needed) {
+		return false;
+	}
+
+	bodies.resize(header.bodyCount);
+	for (Body& b : bodies) {
+		int32_t lod = 0;
+		reader.Read(b.object);
+		reader.Read(b.position);
+		reader.Read(b.orientation);
+		reader.Read(b.linearVelocity);
+		reader.Read(b.angularVelocity);
+		reader.Read(lod);
+		b.lod = (PhysicsLOD)lod;
+	}
+	contacts.resize(header.contactCount);
+	for (Contact& c : contacts) {
+		int32_t framesLeft = 0;
+		reader.Read(c.a);
+		reader.Read(c.b);
+		reader.Read(framesLeft);
+		reader.Read(c.point.localA);
+		reader.Read(c.point.localB);
+		reader.Read(c.point.normal);
+		reader.Read(c.point.penetration);
+		c.framesLeft = framesLeft;
+	}
+	particles.resize(header.particleCount);
+	for (Particle& p : particles) {
+		reader.Read(p.position);
+		reader.Read(p.velocity);
+	}
+	timeOffset	= header.timeOffset;
+	fixedDT		= header.fixedDT;
+	lodSubstep	= header.lodSubstep;
+	isDelta		= header.isDelta != 0;
+	return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "GameObjectHandle.h"
+#include "CollisionDetection.h"
+#include "PhysicsObject.h"
+#include "../../Common/Quaternion.h"
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Everything the physics carries from one Update to the next - where
+		each body is and how it's moving, the contacts it's keeping track of,
+		and the XPBD particles - so that PhysicsSystem::RestoreSnapshot can
+		roll the simulation back to it. Running the same Updates again from a
+		restored snapshot gives exactly the same results as the first time.
+
+		Take them between Updates, when there are no forces left to keep.
+		Only what state objects are in is saved, not which objects there are -
+		bodies removed since are skipped, and ones added since are left alone.
+		It's all flat arrays, so reusing a snapshot doesn't reallocate once
+		it's big enough, and Write / Read turn it into one block of bytes.
+		*/
+		struct PhysicsSnapshot {
+			struct Body {
+				GameObjectHandle	object;
+				Vector3				position;
+				Quaternion			orientation;
+				Vector3				linearVelocity;
+				Vector3				angularVelocity;
+				PhysicsLOD			lod;
+			};
+
+			struct Contact {
+				GameObjectHandle	a;
+				GameObjectHandle	b;
+				int					framesLeft;
+				CollisionDetection::ContactPoint point;
+			};
+
+			struct Particle {
+				Vector3 position;
+				Vector3 velocity;
+			};
+
+			std::vector<Body>		bodies;
+			std::vector<Contact>	contacts;
+			std::vector<Particle>	particles;
+
+			float	timeOffset	= 0.0f;	//Time left over from the last Update
+			float	fixedDT		= 0.0f;
+			int		lodSubstep	= 0;
+			bool	isDelta		= false; //Only holds the bodies that changed since another snapshot
+
+			void Clear();
+
+			size_t GetByteSize() const;
+
+			//Appends the snapshot to out
+			void Write(std::vector<char>& out) const;
+			//False if data doesn't hold a whole snapshot
+			bool Read(const char* data, size_t size);
+		};
+	}
+}
@@ -9,10 +9,25 @@
 
 #include "Debug.h"
 
+#include "../../Common/JobSystem.h"
+#include "../../Common/Profiler.h"
+
+#include <algorithm>
 #include <functional>
+#include <cmath>
+#include <atomic>
+#include <cstring>
 using namespace NCL;
 using namespace CSC8503;
 
+//How many bodies each integration job gets - much less and the threads spend
+//more time handing out work than doing it
+const int integrationGrainSize = 256;
+
+//This is the fixed timestep we'd LIKE to have
+const int   idealHZ = 120;
+const float idealDT = 1.0f / idealHZ;
+
 /*
 
 These two variables help define the relationship between positions
@@ -25,10 +40,19 @@ PhysicsSystem::PhysicsSystem(GameWorld& g) : gameWorld(g)	{
 	useBroadPhase	= true;	
 	dTOffset		= 0.0f;
 	globalDamping	= 0.995f;
+	realHZ			= idealHZ;
+	realDT			= idealDT;
 	SetGravity(Vector3(0.0f, -9.8f, 0.0f));
+
+	gameWorld.AddRemovalListener(this,
+		[this](const std::vector<GameObject*>& removed) {
+			ForgetObjects(removed);
+		}
+	);
 }
 
 PhysicsSystem::~PhysicsSystem()	{
+	gameWorld.RemoveRemovalListeners(this);
 }
 
 void PhysicsSystem::SetGravity(const Vector3& g) {
@@ -47,79 +71,153 @@ any collisions they are in.
 */
 void PhysicsSystem::Clear() {
 	allCollisions.clear();
+	broadphaseCollisions.Get().clear();
+	sweptBodies.clear();
+	broadphaseTree = nullptr;
+	constraintSolver.Clear();
+	xpbd.Clear();
 }
 
 /*
-
-This is the core of the physics engine update
-
+Anything removed from the world has to be taken out of the collision list
+before it's deleted. Removals are applied in batches, so this is one pass
+over the list however many objects have gone.
 */
-int constraintIterationCount = 10;
-
-//This is the fixed timestep we'd LIKE to have
-const int   idealHZ = 120;
-const float idealDT = 1.0f / idealHZ;
+void PhysicsSystem::ForgetObjects(const std::vector<GameObject*>& removed) {
+	if (removed.empty()) {
+		return;
+	}
+	FrameVector<GameObject*> sorted(removed.begin(), removed.end());
+	std::sort(sorted.begin(), sorted.end());
+	auto isRemoved = [&](GameObject* o) {
+		return std::binary_search(sorted.begin(), sorted.end(), o);
+	};
+	for (auto i = allCollisions.begin(); i != allCollisions.end(); ) {
+		if (isRemoved(i->a) || isRemoved(i->b)) {
+			i = allCollisions.erase(i);
+		}
+		else {
+			++i;
+		}
+	}
+	sweptBodies.clear(); //The broadphase is rebuilt at the start of the next update anyway
+}
 
 /*
-This is the fixed update we actually have...
-If physics takes too long it starts to kill the framerate, it'll drop the 
-iteration count down until the FPS stabilises, even if that ends up
-being at a low rate. 
-*/
-int realHZ		= idealHZ;
-float realDT	= idealDT;
 
+This is the core of the physics engine update
+
+*/
 void PhysicsSystem::Update(float dt) {	
-	if (Window::GetKeyboard()->KeyPressed(KeyboardKeys::B)) {
-		useBroadPhase = !useBroadPhase;
-		std::cout << "Setting broadphase to " << useBroadPhase << std::endl;
-	}
-	if (Window::GetKeyboard()->KeyPressed(KeyboardKeys::I)) {
-		constraintIterationCount--;
-		std::cout << "Setting constraint iterations to " << constraintIterationCount << std::endl;
-	}
-	if (Window::GetKeyboard()->KeyPressed(KeyboardKeys::O)) {
-		constraintIterationCount++;
-		std::cout << "Setting constraint iterations to " << constraintIterationCount << std::endl;
+	NCL_PROFILE_SCOPE("PhysicsSystem::Update");
+	//Collision callbacks can add and remove objects - they're held back
+	//until the update's finished with the object list
+	GameWorld::DeferScope defer(gameWorld);
+	const Keyboard* keyboard = Window::GetKeyboard();
+	if (keyboard) { //There's no keyboard when running headless
+		if (keyboard->KeyPressed(KeyboardKeys::B)) {
+			useBroadPhase = !useBroadPhase;
+			std::cout << "Setting broadphase to " << useBroadPhase << std::endl;
+		}
+		if (keyboard->KeyPressed(KeyboardKeys::I)) {
+			constraintIterationCount--;
+			std::cout << "Setting constraint iterations to " << constraintIterationCount << std::endl;
+		}
+		if (keyboard->KeyPressed(KeyboardKeys::O)) {
+			constraintIterationCount++;
+			std::cout << "Setting constraint iterations to " << constraintIterationCount << std::endl;
+		}
 	}
 
 	dTOffset += dt; //We accumulate time delta here - there might be remainders from previous frame!
 
+	timings = PhysicsTimings();
+
 	GameTimer t;
 	t.GetTimeDeltaSeconds();
 
+	GameTimer phaseTimer;
+
 	if (useBroadPhase) {
 		UpdateObjectAABBs();
 	}
+	if (useLOD) {
+		UpdateLODTiers();
+	}
+	phaseTimer.Tick();
+	timings.broadPhase += phaseTimer.GetTimeDeltaSeconds();
 
+	int substep = 0;
 	while(dTOffset >= realDT) {
 		IntegrateAccel(realDT); //Update accelerations from external forces
+		phaseTimer.Tick();
+		timings.integrateAccel += phaseTimer.GetTimeDeltaSeconds();
+
 		if (useBroadPhase) {
-			BroadPhase();
+			//The pairs are found once, covering every substep left this frame,
+			//and are only topped up if something changes course along the way
+			float sweepTime = std::floor(dTOffset / realDT) * realDT;
+			if (substep == 0) {
+				BroadPhase(sweepTime);
+			}
+			else {
+				UpdateSweptPairs(sweepTime);
+			}
+			phaseTimer.Tick();
+			timings.broadPhase += phaseTimer.GetTimeDeltaSeconds();
 			NarrowPhase();
 		}
 		else {
 			BasicCollisionDetection();
 		}
+		phaseTimer.Tick();
+		timings.narrowPhase += phaseTimer.GetTimeDeltaSeconds();
 
 		//This is our simple iterative solver - 
 		//we just run things multiple times, slowly moving things forward
 		//and then rechecking that the constraints have been met		
 		float constraintDt = realDT /  (float)constraintIterationCount;
-		for (int i = 0; i < constraintIterationCount; ++i) {
-			UpdateConstraints(constraintDt);	
+		if (batchedConstraints) {
+			constraintSolver.SolveConstraints(gameWorld, constraintDt, constraintIterationCount);
+		}
+		else {
+			for (int i = 0; i < constraintIterationCount; ++i) {
+				UpdateConstraints(constraintDt);
+			}
 		}
+		phaseTimer.Tick();
+		timings.constraints += phaseTimer.GetTimeDeltaSeconds();
+
 		IntegrateVelocity(realDT); //update positions from new velocity changes
+		phaseTimer.Tick();
+		timings.integrateVelocity += phaseTimer.GetTimeDeltaSeconds();
+
+		if (useXPBD) {
+			xpbd.Update(realDT, applyGravity ? gravity : Vector3());
+			timings.particleSteps += xpbd.GetParticleCount() * xpbd.GetSubsteps();
+		}
+		phaseTimer.Tick();
+		timings.xpbd += phaseTimer.GetTimeDeltaSeconds();
 
 		dTOffset -= realDT;
+		timings.substeps++;
+		lodSubstep++;
+		substep++;
 	}
 
 	ClearForces();	//Once we've finished with the forces, reset them to zero
 
 UpdateCollisionList(); //Remove any old collisions
+phaseTimer.Tick();
+timings.collisionList += phaseTimer.GetTimeDeltaSeconds();
 
 t.Tick();
 float updateTime = t.GetTimeDeltaSeconds();
+timings.total = updateTime;
+
+if (!adaptiveTimestep) {
+	return;
+}
 
 //Uh oh, physics is taking too long...
 if (updateTime > realDT) {
@@ -154,6 +252,7 @@ OnCollisionBegin / OnCollisionEnd functions (removing health when hit by a
 rocket launcher, gaining a point when the player hits the gold coin, and so on).
 */
 void PhysicsSystem::UpdateCollisionList() {
+	NCL_PROFILE_SCOPE("PhysicsSystem::UpdateCollisionList");
 	for (std::set <CollisionDetection::CollisionInfo >::iterator i = allCollisions.begin(); i != allCollisions.end(); ) {
 		if ((*i).framesLeft == numCollisionFrames) {
 			i->a->OnCollisionBegin(i->b);
@@ -172,6 +271,7 @@ void PhysicsSystem::UpdateCollisionList() {
 }
 
 void PhysicsSystem::UpdateObjectAABBs() {
+	NCL_PROFILE_SCOPE("PhysicsSystem::UpdateObjectAABBs");
 	gameWorld.OperateOnContents(
 		[](GameObject* g) {
 			g->UpdateBroadphaseAABB();
@@ -181,6 +281,77 @@ void PhysicsSystem::UpdateObjectAABBs() {
 
 /*
 
+Physics level of detail - bodies far enough away from the camera that nobody
+will notice are stepped less often, with a correspondingly larger timestep,
+and the furthest bodies aren't stepped at all. This only has to be worked out
+once a frame, and is just a distance check per body.
+
+A body that's moving fast enough to pass through more than its own half size
+in one of its larger steps could tunnel straight through things, so it is kept
+at a finer tier instead - a cheap stand in for continuous collision detection.
+
+*/
+void PhysicsSystem::UpdateLODTiers() {
+	NCL_PROFILE_SCOPE("PhysicsSystem::UpdateLODTiers");
+	Vector3 cameraPos = gameWorld.GetMainCamera()->GetPosition();
+
+	float halfSq	= lodDistances[0] * lodDistances[0];
+	float quarterSq = lodDistances[1] * lodDistances[1];
+	float freezeSq	= lodDistances[2] * lodDistances[2];
+
+	ComponentStore<PhysicsObject>& bodies = gameWorld.GetPhysicsObjects();
+	for (size_t b = 0; b < bodies.Size(); ++b) {
+		PhysicsObject* object	= &bodies[b];
+		GameObject* owner		= bodies.GetOwner(b);
+		float distSq = (owner->GetTransform().GetPosition() - cameraPos).LengthSquared();
+
+		PhysicsLOD tier = PhysicsLOD::Full;
+		if (distSq > freezeSq) {
+			tier = PhysicsLOD::Frozen;
+		}
+		else if (distSq > quarterSq) {
+			tier = PhysicsLOD::Quarter;
+		}
+		else if (distSq > halfSq) {
+			tier = PhysicsLOD::Half;
+		}
+
+		Vector3 halfSizes;
+		if (tier != PhysicsLOD::Full && tier != PhysicsLOD::Frozen && owner->GetBroadphaseAABB(halfSizes)) {
+			float minHalfSize	= std::min(halfSizes.x, std::min(halfSizes.y, halfSizes.z));
+			float speed			= object->GetLinearVelocity().Length();
+
+			while (tier != PhysicsLOD::Full && speed * realDT * (1 << (int)tier) > minHalfSize) {
+				tier = (PhysicsLOD)((int)tier - 1);
+			}
+		}
+		object->SetLOD(tier);
+	}
+}
+
+/*
+How many substeps' worth of time a body should be stepped by this substep,
+or 0 if it should be left alone. Bodies on the same tier are spread out over
+the substeps by their world ID, so the cost stays even from step to step.
+*/
+int PhysicsSystem::GetLODStepMultiplier(const GameObject& o) const {
+	if (!useLOD) {
+		return 1;
+	}
+	PhysicsLOD tier = o.GetPhysicsObject()->GetLOD();
+	if (tier == PhysicsLOD::Frozen) {
+		return 0;
+	}
+	int stride = 1 << (int)tier;
+	return ((lodSubstep + o.GetWorldID()) % stride) == 0 ? stride : 0;
+}
+
+bool PhysicsSystem::IsSteppedThisSubstep(const GameObject& o) const {
+	return o.GetPhysicsObject()->GetInverseMass() > 0.0f && GetLODStepMultiplier(o) > 0;
+}
+
+/*
+
 This is how we'll be doing collision detection in tutorial 4.
 We step thorugh every pair of objects once (the inner for loop offset
 ensures this), and determine whether they collide, and if so, add them
@@ -189,6 +360,7 @@ a particular pair will only be added once, so objects colliding for
 multiple frames won't flood the set with duplicates.
 */
 void PhysicsSystem::BasicCollisionDetection() {
+	NCL_PROFILE_SCOPE("PhysicsSystem::BasicCollisionDetection");
 	std::vector <GameObject*>::const_iterator first;
 	std::vector <GameObject*>::const_iterator last;
 	gameWorld.GetObjectIterators(first, last);
@@ -207,28 +379,28 @@ void PhysicsSystem::BasicCollisionDetection() {
 			}
 			CollisionDetection::CollisionInfo info;
 			if (CollisionDetection::ObjectIntersection(*i, *j, info)) {
-				if ((*i)->gOType == GameObjectType::_RESET || (*j)->gOType == GameObjectType::_RESET) {
-					(*i)->gOType = GameObjectType::_RESET;
-					(*j)->gOType = GameObjectType::_RESET;
+				if ((*i)->GetType() == GameObjectType::_RESET || (*j)->GetType() == GameObjectType::_RESET) {
+					(*i)->SetType(GameObjectType::_RESET);
+					(*j)->SetType(GameObjectType::_RESET);
 				}
-				if ((*i)->gOType == GameObjectType::_GOAL || (*j)->gOType == GameObjectType::_GOAL) {
-					(*i)->gOType = GameObjectType::_GOAL;
-					(*j)->gOType = GameObjectType::_GOAL;
+				if ((*i)->GetType() == GameObjectType::_GOAL || (*j)->GetType() == GameObjectType::_GOAL) {
+					(*i)->SetType(GameObjectType::_GOAL);
+					(*j)->SetType(GameObjectType::_GOAL);
 				}
-				if ((*j)->gOType == GameObjectType::_NULL && (*i)->gOType == GameObjectType::_COIN) {
-					(*i)->gOType = GameObjectType::_COIN_COLLECTED;
+				if ((*j)->GetType() == GameObjectType::_NULL && (*i)->GetType() == GameObjectType::_COIN) {
+					(*i)->SetType(GameObjectType::_COIN_COLLECTED);
 					continue;
 				}
-				if ((*j)->gOType == GameObjectType::_COIN && (*i)->gOType == GameObjectType::_NULL) {
-					(*j)->gOType = GameObjectType::_COIN_COLLECTED;
+				if ((*j)->GetType() == GameObjectType::_COIN && (*i)->GetType() == GameObjectType::_NULL) {
+					(*j)->SetType(GameObjectType::_COIN_COLLECTED);
 					continue;
 				}
-				if ((info.b)->gOType == GameObjectType::_NULL && (info.a)->gOType == GameObjectType::_AI) {
-					(info.b)->gOType = GameObjectType::_AI;
+				if ((info.b)->GetType() == GameObjectType::_NULL && (info.a)->GetType() == GameObjectType::_AI) {
+					(info.b)->SetType(GameObjectType::_AI);
 					continue;
 				}
-				if ((info.b)->gOType == GameObjectType::_AI && (info.a)->gOType == GameObjectType::_NULL) {
-					(info.a)->gOType = GameObjectType::_AI;
+				if ((info.b)->GetType() == GameObjectType::_AI && (info.a)->GetType() == GameObjectType::_NULL) {
+					(info.a)->SetType(GameObjectType::_AI);
 					continue;
 				}
 
@@ -319,40 +491,135 @@ compare the collisions that we absolutely need to.
 
 */
 
-void PhysicsSystem::BroadPhase() {
-	broadphaseCollisions.clear();
-	QuadTree <GameObject*> tree(Vector2(1024, 1024), 7, 6);
+bool PhysicsSystem::GetSweptAABB(GameObject& o, float sweepTime, Vector3& outPos, Vector3& outSize) const {
+	Vector3 halfSizes;
+	if (!o.GetBroadphaseAABB(halfSizes)) {
+		return false;
+	}
+	outPos	= o.GetTransform().GetPosition();
+	outSize = halfSizes;
+
+	PhysicsObject* object = o.GetPhysicsObject();
+	if (object == nullptr || object->GetInverseMass() == 0.0f) {
+		return true;
+	}
+	//Anything spinning might end up with any orientation by the end of the sweep
+	if (o.GetBoundingVolume()->type == VolumeType::OBB && object->GetAngularVelocity().LengthSquared() > 0.0f) {
+		float r = halfSizes.Length();
+		outSize = Vector3(r, r, r);
+	}
+	Vector3 motion = object->GetLinearVelocity() * sweepTime;
+	outPos += motion * 0.5f;
+	outSize += Vector3(std::abs(motion.x), std::abs(motion.y), std::abs(motion.z)) * 0.5f;
+
+	//Allow for however far gravity could pull it in that time, too
+	if (applyGravity) {
+		float drop = 0.5f * gravity.Length() * sweepTime * sweepTime;
+		outSize += Vector3(drop, drop, drop);
+	}
+	return true;
+}
+
+/*
+
+Rather than rebuilding the pairs every substep, each body's AABB is stretched
+to cover everywhere it could get to over the rest of the frame, and the pairs
+are found for all of the substeps at once. Only pairs whose stretched boxes
+actually overlap are kept, as the quadtree's leaves can be quite large.
+
+*/
+void PhysicsSystem::BroadPhase(float sweepTime) {
+	NCL_PROFILE_SCOPE("PhysicsSystem::BroadPhase");
+	FrameSet<CollisionDetection::CollisionInfo>& pairs = broadphaseCollisions.Get();
+	pairs.clear();
+	sweptBodies.clear();
+	//The tree lives in the frame arena, so last frame's just gets dropped
+	broadphaseTree = new (FrameArena::Allocate<QuadTree<GameObject*>>(1)) QuadTree <GameObject*>(Vector2(1024, 1024), 7, 6);
 
 	std::vector <GameObject*>::const_iterator first;
 	std::vector <GameObject*>::const_iterator last;
 	gameWorld.GetObjectIterators(first, last);
 	for (auto i = first; i != last; ++i) {
+		Vector3 pos;
 		Vector3 halfSizes;
-		if (!(*i)->GetBroadphaseAABB(halfSizes)) {
+		if (!GetSweptAABB(**i, sweepTime, pos, halfSizes)) {
 			continue;
 		}
-		Vector3 pos = (*i)->GetTransform().GetPosition();
-		if ((*i)->GetBoundingVolume()->type == VolumeType::Capsule) {
-			tree.Insert(*i, pos, halfSizes);
-		} else
+		broadphaseTree->Insert(*i, pos, halfSizes);
 
-			tree.Insert(*i, pos, halfSizes);
+		PhysicsObject* object = (*i)->GetPhysicsObject();
+		if (object && object->GetInverseMass() > 0.0f) {
+			sweptBodies.push_back({ *i, object->GetLinearVelocity() });
+		}
 	}
 
-	tree.OperateOnContents(
-		[&](std::list <QuadTreeEntry <GameObject*>>& data) {
+	//Each node's boxes are copied out into arrays, so that each one can be
+	//tested against all of the ones after it with the SIMD kernel
+	broadphaseTree->OperateOnContents(
+		[&](QuadTreeEntryList<GameObject*>& data) {
+			leafBoxes.Clear();
+			leafObjects.clear();
+			for (const auto& entry : data) {
+				leafBoxes.Add(entry.pos, entry.size);
+				leafObjects.emplace_back(entry.object);
+			}
+			leafOverlaps.resize(leafObjects.size());
+
 			CollisionDetection::CollisionInfo info;
-			for (auto i = data.begin(); i != data.end(); ++i) {
-				for (auto j = std::next(i); j != data.end(); ++j) {
+			auto i = data.begin();
+			for (size_t a = 0; a < leafObjects.size(); ++a, ++i) {
+				size_t count = SIMD::OverlapAABBs((*i).pos, (*i).size, leafBoxes, a + 1, leafOverlaps.data());
+				for (size_t j = 0; j < count; ++j) {
+					GameObject* other = leafObjects[leafOverlaps[j]];
 					//is this pair of items already in the collision set -
 					//if the same pair is in another quadtree node together etc
-					info.a = min((*i).object, (*j).object);
-					info.b = max((*i).object, (*j).object);
-					broadphaseCollisions.insert(info);
+					info.a = std::min((*i).object, other);
+					info.b = std::max((*i).object, other);
+					pairs.insert(info);
 				}
 			}
 		});
-	tree.DebugDraw();
+	broadphaseTree->DebugDraw();
+}
+
+/*
+
+If a body's velocity has changed enough since its swept AABB was made (it's
+bounced off something, or been hit) that it could now end up further than
+requeryDistance from where we expected, it gets a new swept AABB for the rest
+of the frame, and just that box is checked against the tree. The new box is
+added to the tree as well, so that later queries see where it's going now.
+
+*/
+void PhysicsSystem::UpdateSweptPairs(float sweepTime) {
+	NCL_PROFILE_SCOPE("PhysicsSystem::UpdateSweptPairs");
+	FrameSet<CollisionDetection::CollisionInfo>& pairs = broadphaseCollisions.Get();
+	for (SweptBody& b : sweptBodies) {
+		Vector3 velocity = b.object->GetPhysicsObject()->GetLinearVelocity();
+		if ((velocity - b.velocity).Length() * sweepTime <= requeryDistance) {
+			continue;
+		}
+		b.velocity = velocity;
+
+		Vector3 pos;
+		Vector3 halfSizes;
+		GetSweptAABB(*b.object, sweepTime, pos, halfSizes);
+
+		GameObject* object = b.object;
+		broadphaseTree->OperateOnOverlaps(pos, halfSizes,
+			[&](QuadTreeEntryList<GameObject*>& data) {
+				CollisionDetection::CollisionInfo info;
+				for (auto i = data.begin(); i != data.end(); ++i) {
+					if ((*i).object == object || !CollisionDetection::AABBTest(pos, (*i).pos, halfSizes, (*i).size)) {
+						continue;
+					}
+					info.a = std::min(object, (*i).object);
+					info.b = std::max(object, (*i).object);
+					pairs.insert(info);
+				}
+			});
+		broadphaseTree->Insert(object, pos, halfSizes);
+	}
 }
 
 /*
@@ -361,56 +628,61 @@ The broadphase will now only give us likely collisions, so we can now go through
 and work out if they are truly colliding, and if so, add them into the main collision list
 */
 void PhysicsSystem::NarrowPhase() {
-	for (std::set <CollisionDetection::CollisionInfo >::iterator
-		i = broadphaseCollisions.begin();
-		i != broadphaseCollisions.end(); ++i) {
+	NCL_PROFILE_SCOPE("PhysicsSystem::NarrowPhase");
+	FrameSet<CollisionDetection::CollisionInfo>& pairs = broadphaseCollisions.Get();
+	for (auto i = pairs.begin(); i != pairs.end(); ++i) {
 		CollisionDetection::CollisionInfo info = *i;
 		if ((info.a)->GetPhysicsObject()->GetInverseMass() == 0.0f && (info.b)->GetPhysicsObject()->GetInverseMass() == 0.0f)
 		{
 			continue;
 		}
+		//Neither body is being stepped this substep, so they can't have moved since the last check
+		if (useLOD && !IsSteppedThisSubstep(*info.a) && !IsSteppedThisSubstep(*info.b))
+		{
+			continue;
+		}
 
 		//std::cout << "Collision between " << info.a->GetName() << " and " << info.b->GetName() << std::endl;
 
 		if (CollisionDetection::ObjectIntersection(info.a, info.b, info)) {
-			if ((info.a)->gOType == GameObjectType::_RESET || (info.b)->gOType == GameObjectType::_RESET) {
-				(info.a)->gOType = GameObjectType::_RESET;
-				(info.b)->gOType = GameObjectType::_RESET;
+			if ((info.a)->GetType() == GameObjectType::_RESET || (info.b)->GetType() == GameObjectType::_RESET) {
+				(info.a)->SetType(GameObjectType::_RESET);
+				(info.b)->SetType(GameObjectType::_RESET);
 			}
-			if ((info.a)->gOType == GameObjectType::_GOAL || (info.b)->gOType == GameObjectType::_GOAL) {
-				(info.a)->gOType = GameObjectType::_GOAL;
-				(info.b)->gOType = GameObjectType::_GOAL;
+			if ((info.a)->GetType() == GameObjectType::_GOAL || (info.b)->GetType() == GameObjectType::_GOAL) {
+				(info.a)->SetType(GameObjectType::_GOAL);
+				(info.b)->SetType(GameObjectType::_GOAL);
 			}
-			if ((info.b)->gOType == GameObjectType::_NULL && (info.a)->gOType == GameObjectType::_COIN) {
-				(info.a)->gOType = GameObjectType::_COIN_COLLECTED;
+			if ((info.b)->GetType() == GameObjectType::_NULL && (info.a)->GetType() == GameObjectType::_COIN) {
+				(info.a)->SetType(GameObjectType::_COIN_COLLECTED);
 				continue;
 			}
-			if ((info.b)->gOType == GameObjectType::_COIN && (info.a)->gOType == GameObjectType::_NULL) {
-				(info.b)->gOType = GameObjectType::_COIN_COLLECTED;
+			if ((info.b)->GetType() == GameObjectType::_COIN && (info.a)->GetType() == GameObjectType::_NULL) {
+				(info.b)->SetType(GameObjectType::_COIN_COLLECTED);
 				continue;
 			}
-			if ((info.b)->gOType == GameObjectType::_AI && (info.a)->gOType == GameObjectType::_COIN) {
-				(info.a)->gOType = GameObjectType::_COIN_COLLECTED_AI;
+			if ((info.b)->GetType() == GameObjectType::_AI && (info.a)->GetType() == GameObjectType::_COIN) {
+				(info.a)->SetType(GameObjectType::_COIN_COLLECTED_AI);
 					continue;
 			}
-			if ((info.b)->gOType == GameObjectType::_COIN && (info.a)->gOType == GameObjectType::_AI) {
-				(info.b)->gOType = GameObjectType::_COIN_COLLECTED_AI;
+			if ((info.b)->GetType() == GameObjectType::_COIN && (info.a)->GetType() == GameObjectType::_AI) {
+				(info.b)->SetType(GameObjectType::_COIN_COLLECTED_AI);
 					continue;
 			}
-			if ((info.b)->gOType == GameObjectType::_NULL && (info.a)->gOType == GameObjectType::_AI) {
-				(info.b)->gOType = GameObjectType::_AI;
+			if ((info.b)->GetType() == GameObjectType::_NULL && (info.a)->GetType() == GameObjectType::_AI) {
+				(info.b)->SetType(GameObjectType::_AI);
 				continue;
 			}
-			if ((info.b)->gOType == GameObjectType::_AI && (info.a)->gOType == GameObjectType::_NULL) {
-				(info.a)->gOType = GameObjectType::_AI;
+			if ((info.b)->GetType() == GameObjectType::_AI && (info.a)->GetType() == GameObjectType::_NULL) {
+				(info.a)->SetType(GameObjectType::_AI);
 				continue;
 			}
-			if ((info.b)->gOType == GameObjectType::_SLIME && (info.a)->gOType == GameObjectType::_AI) {
-				(info.a)->gOType = GameObjectType::_RESET_AI;
+			if ((info.b)->GetType() == GameObjectType::_SLIME && (info.a)->GetType() == GameObjectType::_AI) {
+				(info.a)->SetType(GameObjectType::_RESET_AI);
 				continue;
 			}
-			if ((info.b)->gOType == GameObjectType::_AI && (info.a)->gOType == GameObjectType::_SLIME) {
-				(info.b)->gOType = GameObjectType::_RESET_AI;
+			if ((info.b)->GetType() == GameObjectType::_AI && (info.a)->GetType() == GameObjectType::_SLIME) {
+				(info.b)->SetType(GameObjectType::_RESET_AI);
 				continue;
 			}
 
@@ -431,39 +703,47 @@ based on any forces that have been accumulated in the objects during
 the course of the previous game frame.
 */
 void PhysicsSystem::IntegrateAccel(float dt) {
-	std::vector <GameObject*>::const_iterator first;
-	std::vector <GameObject*>::const_iterator last;
-	gameWorld.GetObjectIterators(first, last);
-
-	for (auto i = first; i != last; ++i) {
-		PhysicsObject* object = (*i)->GetPhysicsObject();
-		if (object == nullptr) {
-			continue; //No physics object for this GameObject!
-		}
-		float inverseMass = object->GetInverseMass();
+	NCL_PROFILE_SCOPE("PhysicsSystem::IntegrateAccel");
+	//Only the objects with physics, straight from the world's packed store
+	PhysicsObject* bodies			= gameWorld.GetPhysicsObjects().Data();
+	GameObject* const* owners		= gameWorld.GetPhysicsObjects().Owners();
+
+	//Each body only touches its own state, so they can be split up between threads
+	JobSystem::ParallelFor(0, (int)gameWorld.GetPhysicsObjects().Size(), integrationGrainSize,
+		[&](int start, int end) {
+			for (int i = start; i < end; ++i) {
+				PhysicsObject* object = &bodies[i];
+				int stepMultiplier = GetLODStepMultiplier(*owners[i]);
+				if (stepMultiplier == 0) {
+					continue;
+				}
+				float stepDt = dt * stepMultiplier;
+				float inverseMass = object->GetInverseMass();
 
-		Vector3 linearVel = object->GetLinearVelocity();
-		Vector3 force = object->GetForce();
-		Vector3 accel = force * inverseMass;
+				Vector3 linearVel = object->GetLinearVelocity();
+				Vector3 force = object->GetForce();
+				Vector3 accel = force * inverseMass;
 
-		if (applyGravity && inverseMass > 0) {
-			accel += gravity; //dont move infinitely heavy things
+				if (applyGravity && inverseMass > 0) {
+					accel += gravity; //dont move infinitely heavy things
 
-		}
-		linearVel += accel * dt; // integrate accel!
-		object->SetLinearVelocity(linearVel);
+				}
+				linearVel += accel * stepDt; // integrate accel!
+				object->SetLinearVelocity(linearVel);
 
-		// Angular stuff
-		Vector3 torque = object->GetTorque();
-		Vector3 angVel = object->GetAngularVelocity();
+				// Angular stuff
+				Vector3 torque = object->GetTorque();
+				Vector3 angVel = object->GetAngularVelocity();
 		
-		object->UpdateInertiaTensor(); // update tensor vs orientation
+				object->UpdateInertiaTensor(); // update tensor vs orientation
 		
-		Vector3 angAccel = object->GetInertiaTensor() * torque;
+				Vector3 angAccel = object->GetInertiaTensor() * torque;
 		
-		angVel += angAccel * dt; // integrate angular accel!
-		object->SetAngularVelocity(angVel);
-	}
+				angVel += angAccel * stepDt; // integrate angular accel!
+				object->SetAngularVelocity(angVel);
+			}
+		}
+	);
 }
 /*
 This function integrates linear and angular velocity into
@@ -472,40 +752,52 @@ throughout a physics update, to slowly move the objects through
 the world, looking for collisions.
 */
 void PhysicsSystem::IntegrateVelocity(float dt) {
-	std::vector <GameObject*>::const_iterator first;
-	std::vector <GameObject*>::const_iterator last;
-	gameWorld.GetObjectIterators(first, last);
-	float frameLinearDamping = 1.0f - (0.4f * dt);
-	
-		for (auto i = first; i != last; ++i) {
-		PhysicsObject * object = (*i)->GetPhysicsObject();
-		if (object == nullptr) {
-			continue;
-		}
-		Transform & transform = (*i)->GetTransform();
-		// Position Stuff
-		Vector3 position = transform.GetPosition();
-		Vector3 linearVel = object->GetLinearVelocity();
-		position += linearVel * dt;
-		transform.SetPosition(position);
-		// Linear Damping
-		linearVel = linearVel * frameLinearDamping;
-		object->SetLinearVelocity(linearVel);	
-
-		// Orientation Stuff
-		Quaternion orientation = transform.GetOrientation();
-		Vector3 angVel = object->GetAngularVelocity();
+	NCL_PROFILE_SCOPE("PhysicsSystem::IntegrateVelocity");
+	PhysicsObject* bodies			= gameWorld.GetPhysicsObjects().Data();
+	GameObject* const* owners		= gameWorld.GetPhysicsObjects().Owners();
+
+	std::atomic<int> bodySteps(0);
+	JobSystem::ParallelFor(0, (int)gameWorld.GetPhysicsObjects().Size(), integrationGrainSize,
+		[&](int start, int end) {
+			int steps = 0;
+			for (int i = start; i < end; ++i) {
+				PhysicsObject * object = &bodies[i];
+				int stepMultiplier = GetLODStepMultiplier(*owners[i]);
+				if (stepMultiplier == 0) {
+					continue;
+				}
+				float stepDt = dt * stepMultiplier;
+				float frameLinearDamping = 1.0f - (0.4f * stepDt);
+				steps++;
+
+				Transform & transform = owners[i]->GetTransform();
+				// Position Stuff
+				Vector3 position = transform.GetPosition();
+				Vector3 linearVel = object->GetLinearVelocity();
+				position += linearVel * stepDt;
+				transform.SetPosition(position);
+				// Linear Damping
+				linearVel = linearVel * frameLinearDamping;
+				object->SetLinearVelocity(linearVel);	
+
+				// Orientation Stuff
+				Quaternion orientation = transform.GetOrientation();
+				Vector3 angVel = object->GetAngularVelocity();
 		
-		orientation = orientation + (Quaternion(angVel * dt * 0.5f, 0.0f) * orientation);
-		orientation.Normalise();
+				orientation = orientation + (Quaternion(angVel * stepDt * 0.5f, 0.0f) * orientation);
+				orientation.Normalise();
 		
-		transform.SetOrientation(orientation);
+				transform.SetOrientation(orientation);
 		
-		//Damp the angular velocity too
-		float frameAngularDamping = 1.0f - (0.4f * dt);
-		angVel = angVel * frameAngularDamping;
-		object->SetAngularVelocity(angVel);
-	}
+				//Damp the angular velocity too
+				float frameAngularDamping = 1.0f - (0.4f * stepDt);
+				angVel = angVel * frameAngularDamping;
+				object->SetAngularVelocity(angVel);
+			}
+			bodySteps += steps;
+		}
+	);
+	timings.bodySteps += bodySteps;
 }
 
 /*
@@ -514,11 +806,10 @@ clear out any accumulated forces, ready to receive new
 ones in the next 'game' frame.
 */
 void PhysicsSystem::ClearForces() {
-	gameWorld.OperateOnContents(
-		[](GameObject* o) {
-			o->GetPhysicsObject()->ClearForces();
-		}
-	);
+	ComponentStore<PhysicsObject>& bodies = gameWorld.GetPhysicsObjects();
+	for (size_t i = 0; i < bodies.Size(); ++i) {
+		bodies[i].ClearForces();
+	}
 }
 
 
@@ -530,6 +821,7 @@ us to model springs and ropes etc.
 
 */
 void PhysicsSystem::UpdateConstraints(float dt) {
+	NCL_PROFILE_SCOPE("PhysicsSystem::UpdateConstraints");
 	std::vector<Constraint*>::const_iterator first;
 	std::vector<Constraint*>::const_iterator last;
 	gameWorld.GetConstraintIterators(first, last);
@@ -537,4 +829,194 @@ void PhysicsSystem::UpdateConstraints(float dt) {
 	for (auto i = first; i != last; ++i) {
 		(*i)->UpdateConstraint(dt);
 	}
-}
\ No newline at end of file
+}
+
+/*
+Hashes the exact bits of everything the simulation carries from one step to
+the next - if two runs ever give a different hash after the same step, they
+have drifted apart, and will only get further apart from then on. Forces are
+left out, as they are cleared at the end of every Update.
+*/
+namespace {
+	//FNV-1a
+	void HashFloats(unsigned long long& hash, const float* f, size_t count) {
+		const unsigned char* bytes = (const unsigned char*)f;
+		for (size_t i = 0; i < count * sizeof(float); ++i) {
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+	}
+}
+
+unsigned long long PhysicsSystem::GetStateHash() const {
+	unsigned long long hash = 14695981039346656037ull;
+
+	GameObjectIterator first;
+	GameObjectIterator last;
+	gameWorld.GetObjectIterators(first, last);
+
+	for (auto i = first; i != last; ++i) {
+		Transform& t = (*i)->GetTransform();
+		Vector3		position	= t.GetPosition();
+		Quaternion	orientation	= t.GetOrientation();
+		HashFloats(hash, position.array, 3);
+		HashFloats(hash, orientation.array, 4);
+
+		const PhysicsObject* object = (*i)->GetPhysicsObject();
+		if (object) {
+			Vector3 linear	= object->GetLinearVelocity();
+			Vector3 angular	= object->GetAngularVelocity();
+			HashFloats(hash, linear.array, 3);
+			HashFloats(hash, angular.array, 3);
+		}
+	}
+	for (int i = 0; i < xpbd.GetParticleCount(); ++i) {
+		Vector3 position = xpbd.GetParticlePosition(i);
+		Vector3 velocity = xpbd.GetParticleVelocity(i);
+		HashFloats(hash, position.array, 3);
+		HashFloats(hash, velocity.array, 3);
+	}
+	return hash;
+}
+
+/*
+Bodies are saved in the physics store's order, which is still the order
+they're in when restored unless objects have come or gone in between - so
+each saved body is checked against whatever is in the same place in the
+store, and only looked up by its handle if that isn't it.
+*/
+namespace {
+	void SaveBody(GameObject& o, const PhysicsObject& p, PhysicsSnapshot::Body& b) {
+		Transform& t = o.GetTransform();
+		b.object			= o.GetHandle();
+		b.position			= t.GetPosition();
+		b.orientation		= t.GetOrientation();
+		b.linearVelocity	= p.GetLinearVelocity();
+		b.angularVelocity	= p.GetAngularVelocity();
+		b.lod				= p.GetLOD();
+	}
+
+	//Exactly the same bits - the same thing a hash would tell apart
+	bool SameBody(const PhysicsSnapshot::Body& a, const PhysicsSnapshot::Body& b) {
+		return a.object == b.object && a.lod == b.lod
+			&& memcmp(a.position.array,			b.position.array,			sizeof(float) * 3) == 0
+			&& memcmp(a.orientation.array,		b.orientation.array,		sizeof(float) * 4) == 0
+			&& memcmp(a.linearVelocity.array,	b.linearVelocity.array,		sizeof(float) * 3) == 0
+			&& memcmp(a.angularVelocity.array,	b.angularVelocity.array,	sizeof(float) * 3) == 0;
+	}
+}
+
+void PhysicsSystem::SaveSnapshot(PhysicsSnapshot& out) const {
+	NCL_PROFILE_SCOPE("PhysicsSystem::SaveSnapshot");
+	const ComponentStore<PhysicsObject>& store = gameWorld.GetPhysicsObjects();
+	out.bodies.resize(store.Size());
+	for (size_t i = 0; i < store.Size(); ++i) {
+		SaveBody(*store.GetOwner(i), store[i], out.bodies[i]);
+	}
+	out.isDelta = false;
+	SaveSharedState(out);
+}
+
+void PhysicsSystem::SaveDeltaSnapshot(const PhysicsSnapshot& base, PhysicsSnapshot& out) const {
+	NCL_PROFILE_SCOPE("PhysicsSystem::SaveDeltaSnapshot");
+	const ComponentStore<PhysicsObject>& store = gameWorld.GetPhysicsObjects();
+	out.bodies.clear();
+	PhysicsSnapshot::Body b;
+	for (size_t i = 0; i < store.Size(); ++i) {
+		SaveBody(*store.GetOwner(i), store[i], b);
+		if (i < base.bodies.size() && SameBody(b, base.bodies[i])) {
+			continue;
+		}
+		out.bodies.emplace_back(b);
+	}
+	out.isDelta = true;
+	SaveSharedState(out);
+}
+
+//The contacts and particles are small enough to always be saved whole
+void PhysicsSystem::SaveSharedState(PhysicsSnapshot& out) const {
+	out.contacts.resize(allCollisions.size());
+	size_t c = 0;
+	for (const CollisionDetection::CollisionInfo& info : allCollisions) {
+		PhysicsSnapshot::Contact& contact = out.contacts[c++];
+		contact.a			= info.a->GetHandle();
+		contact.b			= info.b->GetHandle();
+		contact.framesLeft	= info.framesLeft;
+		contact.point		= info.point;
+	}
+	out.particles.resize(xpbd.GetParticleCount());
+	for (int i = 0; i < xpbd.GetParticleCount(); ++i) {
+		out.particles[i].position = xpbd.GetParticlePosition(i);
+		out.particles[i].velocity = xpbd.GetParticleVelocity(i);
+	}
+	out.timeOffset	= dTOffset;
+	out.fixedDT		= realDT;
+	out.lodSubstep	= lodSubstep;
+}
+
+void PhysicsSystem::RestoreSnapshot(const PhysicsSnapshot& s) {
+	NCL_PROFILE_SCOPE("PhysicsSystem::RestoreSnapshot");
+	RestoreBodies(s);
+	RestoreSharedState(s);
+}
+
+void PhysicsSystem::RestoreDeltaSnapshot(const PhysicsSnapshot& base, const PhysicsSnapshot& delta) {
+	NCL_PROFILE_SCOPE("PhysicsSystem::RestoreDeltaSnapshot");
+	RestoreBodies(base);
+	RestoreBodies(delta);
+	RestoreSharedState(delta);
+}
+
+void PhysicsSystem::RestoreBodies(const PhysicsSnapshot& s) {
+	ComponentStore<PhysicsObject>& store = gameWorld.GetPhysicsObjects();
+	for (size_t i = 0; i < s.bodies.size(); ++i) {
+		const PhysicsSnapshot::Body& b = s.bodies[i];
+		GameObject*		o = (i < store.Size()) ? store.GetOwner(i) : nullptr;
+		PhysicsObject*	p = nullptr;
+		if (o && o->GetHandle() == b.object) {
+			p = &store[i];
+		}
+		else {
+			o = gameWorld.GetGameObject(b.object);
+			p = o ? o->GetPhysicsObject() : nullptr;
+			if (!p) {
+				continue; //Gone since the snapshot was taken
+			}
+		}
+		o->GetTransform()
+			.SetPosition(b.position)
+			.SetOrientation(b.orientation);
+		p->SetLinearVelocity(b.linearVelocity);
+		p->SetAngularVelocity(b.angularVelocity);
+		p->SetLOD(b.lod);
+		p->ClearForces();
+	}
+}
+
+//Contacts come back without any collision callbacks - as far as the objects
+//are concerned, they never stopped (or started) touching
+void PhysicsSystem::RestoreSharedState(const PhysicsSnapshot& s) {
+	allCollisions.clear();
+	for (const PhysicsSnapshot::Contact& contact : s.contacts) {
+		CollisionDetection::CollisionInfo info;
+		info.a = gameWorld.GetGameObject(contact.a);
+		info.b = gameWorld.GetGameObject(contact.b);
+		if (!info.a || !info.b) {
+			continue;
+		}
+		info.framesLeft	= contact.framesLeft;
+		info.point		= contact.point;
+		allCollisions.insert(allCollisions.end(), info); //Saved in order, so each one goes on the end
+	}
+	int particles = std::min((int)s.particles.size(), xpbd.GetParticleCount());
+	for (int i = 0; i < particles; ++i) {
+		xpbd.SetParticlePosition(i, s.particles[i].position);
+		xpbd.SetParticleVelocity(i, s.particles[i].velocity);
+	}
+	dTOffset	= s.timeOffset;
+	lodSubstep	= s.lodSubstep;
+	if (s.fixedDT > 0.0f) {
+		realDT = s.fixedDT;
+		realHZ = (int)std::lround(1.0f / realDT);
+	}
+	sweptBodies.clear(); //The broadphase is rebuilt at the start of the next update anyway
+}
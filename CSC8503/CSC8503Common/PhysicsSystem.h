@@ -1,9 +1,28 @@
 #pragma once
 #include "../CSC8503Common/GameWorld.h"
+#include "ConstraintSolver.h"
+#include "XPBDSystem.h"
+#include "PhysicsSnapshot.h"
+#include "../../Common/SIMDKernels.h"
+#include "../../Common/FrameArena.h"
 #include <set>
 
 namespace NCL {
 	namespace CSC8503 {
+		struct PhysicsTimings {
+			float integrateAccel	= 0.0f;
+			float broadPhase		= 0.0f;
+			float narrowPhase		= 0.0f;
+			float constraints		= 0.0f;
+			float integrateVelocity	= 0.0f;
+			float xpbd				= 0.0f;
+			float collisionList		= 0.0f;
+			float total				= 0.0f;
+			int	  substeps			= 0;
+			int	  bodySteps			= 0;	//how many times a body was integrated
+			int	  particleSteps		= 0;	//how many times an XPBD particle was, across every XPBD substep
+		};
+
 		class PhysicsSystem	{
 		public:
 			PhysicsSystem(GameWorld& g);
@@ -22,9 +41,66 @@ namespace NCL {
 			}
 
 			void SetGravity(const Vector3& g);
+
+			//When off, the system always steps at the ideal rate instead of
+			//dropping the iteration count when physics takes too long
+			void UseAdaptiveTimestep(bool state) {
+				adaptiveTimestep = state;
+			}
+
+			//When off, constraints are updated one at a time in world order
+			void UseBatchedConstraints(bool state) {
+				batchedConstraints = state;
+			}
+
+			//Ropes, chains and cloth are simulated as XPBD particles, stepped
+			//after the rigid bodies on every fixed update
+			void UseXPBD(bool state) {
+				useXPBD = state;
+			}
+
+			XPBDSystem& GetXPBDSystem() {
+				return xpbd;
+			}
+
+			//When on, bodies further from the main camera than each of these
+			//distances step at half rate, quarter rate, or not at all
+			void UseLOD(bool state) {
+				useLOD = state;
+			}
+
+			void SetLODDistances(float half, float quarter, float freeze) {
+				lodDistances[0] = half;
+				lodDistances[1] = quarter;
+				lodDistances[2] = freeze;
+			}
+
+			//Changes if any body or particle is even a bit different - two runs
+			//that are still in lockstep will have the same hash after every Update
+			unsigned long long GetStateHash() const;
+
+			/*
+			For rolling the simulation back (see PhysicsSnapshot.h). Both are
+			a straight copy of each body in the world's physics store order,
+			so restoring a snapshot taken since the last add or remove never
+			has to look anything up. A delta snapshot only keeps the bodies
+			that have changed since base, and restoring it restores base
+			first, so base has to be kept around for as long as the delta.
+			*/
+			void SaveSnapshot(PhysicsSnapshot& out) const;
+			void RestoreSnapshot(const PhysicsSnapshot& s);
+			void SaveDeltaSnapshot(const PhysicsSnapshot& base, PhysicsSnapshot& out) const;
+			void RestoreDeltaSnapshot(const PhysicsSnapshot& base, const PhysicsSnapshot& delta);
+
+			//Seconds spent in each phase during the last call to Update
+			const PhysicsTimings& GetTimings() const {
+				return timings;
+			}
 		protected:
 			void BasicCollisionDetection();
-			void BroadPhase();
+			void BroadPhase(float sweepTime);
+			void UpdateSweptPairs(float sweepTime);
+			bool GetSweptAABB(GameObject& o, float sweepTime, Vector3& outPos, Vector3& outSize) const;
 			void NarrowPhase();
 
 			void ClearForces();
@@ -35,8 +111,17 @@ namespace NCL {
 			void UpdateConstraints(float dt);
 
 			void UpdateCollisionList();
+			void ForgetObjects(const std::vector<GameObject*>& removed);
+
+			void SaveSharedState(PhysicsSnapshot& out) const;
+			void RestoreBodies(const PhysicsSnapshot& s);
+			void RestoreSharedState(const PhysicsSnapshot& s);
 			void UpdateObjectAABBs();
 
+			void UpdateLODTiers();
+			int  GetLODStepMultiplier(const GameObject& o) const;
+			bool IsSteppedThisSubstep(const GameObject& o) const;
+
 			void ImpulseResolveCollision(GameObject& a , GameObject&b, CollisionDetection::ContactPoint& p) const;
 
 			GameWorld& gameWorld;
@@ -47,10 +132,43 @@ namespace NCL {
 			float	globalDamping;
 
 			std::set<CollisionDetection::CollisionInfo> allCollisions;
-			std::set <CollisionDetection::CollisionInfo > broadphaseCollisions;
+			//Rebuilt every frame, so the set's nodes come from the frame arena
+			FrameLocal<FrameSet<CollisionDetection::CollisionInfo>> broadphaseCollisions;
+
+			struct SweptBody {
+				GameObject* object;
+				Vector3		velocity;	//what the swept AABB was built from
+			};
+			QuadTree<GameObject*>*	broadphaseTree = nullptr;
+			std::vector<SweptBody>	sweptBodies;
+
+			SIMD::AABBArray				leafBoxes;
+			std::vector<GameObject*>	leafObjects;
+			std::vector<int>			leafOverlaps;
+			float requeryDistance	= 0.05f;
 
 			bool useBroadPhase		= true;
+			bool adaptiveTimestep	= true;
+			bool batchedConstraints	= true;
+			bool useXPBD			= true;
+			bool useLOD				= false;
+			float lodDistances[3]	= { 100.0f, 200.0f, 400.0f };
+			int lodSubstep			= 0;
 			int numCollisionFrames	= 5;
+			int constraintIterationCount = 10;
+
+			/*
+			This is the fixed update we actually have...
+			If physics takes too long it starts to kill the framerate, it'll drop the
+			iteration count down until the FPS stabilises, even if that ends up
+			being at a low rate.
+			*/
+			int		realHZ;
+			float	realDT;
+
+			ConstraintSolver	constraintSolver;
+			XPBDSystem			xpbd;
+			PhysicsTimings		timings;
 		};
 	}
 }
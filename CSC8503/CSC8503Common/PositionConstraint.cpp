@@ -1,39 +1,56 @@
 #include "PositionConstraint.h"
 #include "GameObject.h"
+#include <cmath>
 
 using namespace NCL::CSC8503;
 
-//void PositionConstraint::UpdateConstraint(float dt) {
-//	Vector3 relativePos = objectA->GetTransform().GetPosition() - objectB->GetTransform().GetPosition();
-//	float currentDistance = relativePos.Length();
-//	float offset = distance - currentDistance;
-//
-//	if (abs(offset) > 0.0f) {
-//		Vector3 offsetDir = relativePos.Normalised();
-//
-//		PhysicsObject* physA = objectA->GetPhysicsObject();
-//		PhysicsObject* physB = objectB->GetPhysicsObject();
-//
-//		Vector3 relativeVelocity = physA->GetLinearVelocity() -
-//			physB->GetLinearVelocity();
-//
-//		float constraintMass = physA->GetInverseMass() +
-//			physB->GetInverseMass();
-//
-//		if (constraintMass > 0.0f) {
-//			//how much of their relative force is affecting the constraint
-//			float velocityDot = Vector3::Dot(relativeVelocity, offsetDir);
-//
-//			float biasFactor = 0.01f;
-//			float bias = -(biasFactor / dt) * offset;
-//
-//			float lambda = -(velocityDot + bias) / constraintMass;
-//
-//			Vector3 aImpulse = offsetDir * lambda;
-//			Vector3 bImpulse = -offsetDir * lambda;
-//
-//			physA->ApplyLinearImpulse(aImpulse);// multiplied by mass here
-//			physB->ApplyLinearImpulse(bImpulse);// multiplied by mass here
-//		}
-//	}
-//}
\ No newline at end of file
+void PositionConstraint::UpdateConstraint(float dt) {
+	PhysicsObject* physA = objectA->GetPhysicsObject();
+	PhysicsObject* physB = objectB->GetPhysicsObject();
+
+	Vector3 velocityA = physA->GetLinearVelocity();
+	Vector3 velocityB = physB->GetLinearVelocity();
+
+	SolveDistance(objectA->GetTransform().GetPosition(), velocityA, physA->GetInverseMass(),
+		objectB->GetTransform().GetPosition(), velocityB, physB->GetInverseMass(), distance, dt);
+
+	physA->SetLinearVelocity(velocityA);
+	physB->SetLinearVelocity(velocityB);
+}
+
+void PositionConstraint::SolveDistance(const Vector3& positionA, Vector3& velocityA, float inverseMassA,
+	const Vector3& positionB, Vector3& velocityB, float inverseMassB, float distance, float dt) {
+	Vector3 relativePos = positionA - positionB;
+	float currentDistance = relativePos.Length();
+	float offset = distance - currentDistance;
+
+	if (std::abs(offset) > 0.0f) {
+		Vector3 offsetDir = relativePos.Normalised();
+
+		Vector3 relativeVelocity = velocityA - velocityB;
+
+		float constraintMass = inverseMassA + inverseMassB;
+
+		if (constraintMass > 0.0f) {
+			//how much of their relative force is affecting the constraint
+			float velocityDot = Vector3::Dot(relativeVelocity, offsetDir);
+
+			float biasFactor = 0.01f;
+			float bias = -(biasFactor / dt) * offset;
+
+			float lambda = -(velocityDot + bias) / constraintMass;
+
+			Vector3 aImpulse = offsetDir * lambda;
+			Vector3 bImpulse = -offsetDir * lambda;
+
+			//Static bodies are left alone entirely, so that the batched
+			//solver can share them between threads
+			if (inverseMassA > 0.0f) {
+				velocityA += aImpulse * inverseMassA;// multiplied by mass here
+			}
+			if (inverseMassB > 0.0f) {
+				velocityB += bImpulse * inverseMassB;// multiplied by mass here
+			}
+		}
+	}
+}
\ No newline at end of file
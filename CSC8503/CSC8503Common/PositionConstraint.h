@@ -1,5 +1,8 @@
 #pragma once
 #include "Constraint.h"
+#include "../../Common/Vector3.h"
+
+using namespace NCL::Maths;
 
 namespace NCL {
 	namespace CSC8503 {
@@ -8,13 +11,30 @@ namespace NCL {
 		class PositionConstraint : public Constraint {
 		public:
 			PositionConstraint(GameObject* a, GameObject* b, float d) {
+				type = ConstraintType::Position;
 				objectA = a;
 				objectB = b;
 				distance = d;
 			}
 			~PositionConstraint() {}
 
-			//void UpdateConstraint(float dt) override;
+			void UpdateConstraint(float dt) override;
+
+			//The distance constraint itself, shared with the batched ConstraintSolver
+			static void SolveDistance(const Vector3& positionA, Vector3& velocityA, float inverseMassA,
+				const Vector3& positionB, Vector3& velocityB, float inverseMassB, float distance, float dt);
+
+			GameObject* GetObjectA() const {
+				return objectA;
+			}
+
+			GameObject* GetObjectB() const {
+				return objectB;
+			}
+
+			float GetDistance() const {
+				return distance;
+			}
 
 		protected:
 			GameObject* objectA;
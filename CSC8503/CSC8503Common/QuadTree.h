@@ -2,8 +2,10 @@
 #include "../../Common/Vector2.h"
 #include "../CSC8503Common/CollisionDetection.h"
 #include "Debug.h"
+#include "../../Common/FrameArena.h"
 #include <list>
 #include <functional>
+#include <new>
 
 namespace NCL {
 	using namespace NCL::Maths;
@@ -24,10 +26,13 @@ namespace NCL {
 			}
 		};
 
+		template<class T>
+		using QuadTreeEntryList = std::list<QuadTreeEntry<T>, FrameAllocator<QuadTreeEntry<T>>>;
+
 		template<class T>
 		class QuadTreeNode {
 		public:
-			typedef std::function<void(std::list<QuadTreeEntry<T>>&)> QuadTreeFunc;
+			typedef std::function<void(QuadTreeEntryList<T>&)> QuadTreeFunc;
 		protected:
 			friend class QuadTree<T>;
 
@@ -40,7 +45,7 @@ namespace NCL {
 			}
 
 			~QuadTreeNode() {
-				delete[] children;
+				//The children are in the frame arena, and just get dropped with it
 			}
 
 			void Insert(T& object, const Vector3& objectPos, const Vector3& objectSize, int depthLeft, int maxSize) {
@@ -76,14 +81,14 @@ namespace NCL {
 
 			void Split() {
 				Vector2 halfSize = size / 2.0f;
-				children = new QuadTreeNode <T >[4];
-				children[0] = QuadTreeNode <T>(position +
+				children = FrameArena::Allocate<QuadTreeNode<T>>(4);
+				new (&children[0]) QuadTreeNode <T>(position +
 					Vector2(-halfSize.x, halfSize.y), halfSize);
-				children[1] = QuadTreeNode <T>(position +
+				new (&children[1]) QuadTreeNode <T>(position +
 					Vector2(halfSize.x, halfSize.y), halfSize);
-				children[2] = QuadTreeNode <T>(position +
+				new (&children[2]) QuadTreeNode <T>(position +
 					Vector2(-halfSize.x, -halfSize.y), halfSize);
-				children[3] = QuadTreeNode <T>(position +
+				new (&children[3]) QuadTreeNode <T>(position +
 					Vector2(halfSize.x, -halfSize.y), halfSize);
 			}
 
@@ -91,7 +96,8 @@ namespace NCL {
 
 			}
 
-			void OperateOnContents(QuadTreeFunc& func) {
+			template<typename F>
+			void OperateOnContents(F& func) {
 				if (children) {
 					for (int i = 0; i < 4; ++i) {
 						children[i].OperateOnContents(func);
@@ -104,8 +110,27 @@ namespace NCL {
 				}
 			}
 
+			template<typename F>
+			void OperateOnOverlaps(const Vector3& objectPos, const Vector3& objectSize, F& func) {
+				if (!CollisionDetection::AABBTest(objectPos,
+					Vector3(position.x, 0, position.y), objectSize,
+					Vector3(size.x, 1000.0f, size.y))) {
+					return;
+				}
+				if (children) {
+					for (int i = 0; i < 4; ++i) {
+						children[i].OperateOnOverlaps(objectPos, objectSize, func);
+					}
+				}
+				else {
+					if (!contents.empty()) {
+						func(contents);
+					}
+				}
+			}
+
 		protected:
-			std::list< QuadTreeEntry<T> >	contents;
+			QuadTreeEntryList<T>	contents;
 
 			Vector2 position;
 			Vector2 size;
@@ -119,6 +144,11 @@ namespace NCL {
 namespace NCL {
 	using namespace NCL::Maths;
 	namespace CSC8503 {
+		/*
+		Everything in a tree comes from the frame arena, as it's meant to be
+		built from scratch every frame - so a tree is only good until the end
+		of the next frame, and needs to be made anew after that.
+		*/
 		template<class T>
 		class QuadTree
 		{
@@ -139,10 +169,18 @@ namespace NCL {
 				root.DebugDraw();
 			}
 
-			void OperateOnContents(typename QuadTreeNode<T>::QuadTreeFunc  func) {
+			//func is called with a QuadTreeEntryList<T>& for each leaf that has something in it
+			template<typename F>
+			void OperateOnContents(F func) {
 				root.OperateOnContents(func);
 			}
 
+			//Only visits the leaves that the given box touches
+			template<typename F>
+			void OperateOnOverlaps(const Vector3& pos, const Vector3& size, F func) {
+				root.OperateOnOverlaps(pos, size, func);
+			}
+
 		protected:
 			QuadTreeNode<T> root;
 			int maxDepth;
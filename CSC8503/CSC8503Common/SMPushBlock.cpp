@@ -14,7 +14,7 @@ SMPushBlock::SMPushBlock(Vector3 position, Vector3 force, float distance) {
 	this->fireDist = distance;
 	fired = false;
 
-	this->gOType == GameObjectType::_SPRING;
+	this->SetType(GameObjectType::_SPRING);
 
 	State* cocked = new State([&](float dt)-> void
 		{
@@ -10,6 +10,14 @@ namespace NCL {
 
 			virtual void Update(float dt);
 
+			Vector3 GetFireForce() const {
+				return fireForce;
+			}
+
+			float GetFireDistance() const {
+				return fireDist;
+			}
+
 		protected:
 			StateMachine* stateMachine;
 			Vector3 initPosition;
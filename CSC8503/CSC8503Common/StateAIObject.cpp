@@ -2,12 +2,14 @@
 #include "StateTransition.h"
 #include "StateMachine.h"
 #include "State.h"
+#include "GameWorld.h"
 
 using namespace NCL;
 using namespace CSC8503;
 
 StateAIObject::StateAIObject() {
 	speed = 1.0f;
+	world = nullptr;
 	stateMachine = new StateMachine();
 	targetPos = GetTransform().GetPosition();
 
@@ -57,8 +59,16 @@ StateAIObject::StateAIObject() {
 		[&]()-> bool
 		{
 			float currentLength;
-			for (auto i : coins) {
-				for (auto j : bumpers) {
+			for (auto c : coins) {
+				GameObject* i = world->GetGameObject(c);
+				if (!i) {
+					continue;
+				}
+				for (auto b : bumpers) {
+					GameObject* j = world->GetGameObject(b);
+					if (!j) {
+						continue;
+					}
 					if ((i->GetTransform().GetPosition() - j->GetTransform().GetPosition()).Length() > (i->GetTransform().GetPosition() - j->GetTransform().GetPosition()).Length()) {
 						coinPos = i->GetTransform().GetPosition() - GetTransform().GetPosition();
 						return false;
@@ -77,7 +87,11 @@ StateAIObject ::~StateAIObject() {
  void StateAIObject::Update(float dt) {
 	 stateMachine->Update(dt);
 	 currentLength = (GetTransform().GetPosition() - targetPos).Length();
-	 for (auto i : coins) {
+	 for (auto c : coins) {
+		 GameObject* i = world ? world->GetGameObject(c) : nullptr;
+		 if (!i) {
+			 continue;
+		 }
 		 if ((GetTransform().GetPosition() - i->GetTransform().GetPosition()).Length() < currentLength) {
 			 currentLength = (GetTransform().GetPosition() - i->GetTransform().GetPosition()).Length();
 			 coinPos = i->GetTransform().GetPosition();
@@ -85,6 +99,10 @@ StateAIObject ::~StateAIObject() {
 	 }
 }
 
+int StateAIObject::GetStateIndex() const {
+	return stateMachine->GetActiveStateIndex();
+}
+
  void StateAIObject::MoveFromBall(float dt) {
 	 GetPhysicsObject()->AddForce((GetTransform().GetPosition() - targetPos) * speed);
  }
@@ -1,8 +1,10 @@
 #pragma once
 #include "GameObject.h"
+#include "GameObjectHandle.h"
 namespace NCL {
 	namespace CSC8503 {
 		class StateMachine;
+		class GameWorld;
 		class StateAIObject : public GameObject {
 		public:
 			StateAIObject();
@@ -10,11 +12,16 @@ namespace NCL {
 
 			virtual void Update(float dt);
 
+			//0 hunting the ball, 1 running from it, 2 hunting coins, 3 avoiding bumpers
+			int GetStateIndex() const;
+
 			Vector3 targetPos;
 			Vector3 coinPos;
 			Vector3 bumperPos;
-			std::vector<GameObject*> coins;
-			std::vector<GameObject*> bumpers;
+			//Handles, as the coins get taken out of the world when collected
+			std::vector<GameObjectHandle> coins;
+			std::vector<GameObjectHandle> bumpers;
+			const GameWorld* world;
 		protected:
 			void MoveToBall(float dt);
 			void MoveFromBall(float dt);
@@ -30,6 +30,15 @@ void StateMachine::AddTransition(StateTransition* t) {
 	allTransitions.insert(std::make_pair(t->GetSourceState(), t));
 }
 
+int StateMachine::GetActiveStateIndex() const {
+	for (size_t i = 0; i < allStates.size(); ++i) {
+		if (allStates[i] == activeState) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
 void StateMachine::Update(float dt) {
 	if (activeState) {
 		activeState->Update(dt);
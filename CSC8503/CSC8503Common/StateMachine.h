@@ -23,6 +23,9 @@ namespace NCL {
 
 			void Update(float dt);
 
+			//Where the active state is in the order the states were added, or -1 if there's none
+			int GetActiveStateIndex() const;
+
 		protected:
 			State * activeState;
 
@@ -4,7 +4,8 @@ using namespace NCL::CSC8503;
 
 Transform::Transform()
 {
-	scale	= Vector3(1, 1, 1);
+	scale		= Vector3(1, 1, 1);
+	matrixDirty	= true;
 }
 
 Transform::~Transform()
@@ -12,27 +13,111 @@ Transform::~Transform()
 
 }
 
-void Transform::UpdateMatrix() {
-	matrix =
-		Matrix4::Translation(position) *
-		Matrix4(orientation) *
-		Matrix4::Scale(scale);
+/*
+This is Translation(position) * Matrix4(orientation) * Scale(scale), but
+without the two full matrix multiplies - the scale only ever multiplies the
+rotation's columns, and the translation only ever fills in the last one.
+*/
+void Transform::UpdateMatrix() const {
+	matrix = Matrix4(orientation);
+	for (int c = 0; c < 3; ++c) {
+		for (int r = 0; r < 3; ++r) {
+			matrix.array[(c * 4) + r] *= scale[c];
+		}
+	}
+	matrix.SetPositionVector(position);
+	matrixDirty = false;
+}
+
+/*
+Does the same as UpdateMatrix, but for four transforms at once - their
+quaternions are transposed so that each register holds one component from
+all four, and then the rotation matrix is worked out exactly as in the
+Matrix4 quaternion constructor (in the same order, to get the same result).
+The columns then get transposed back out, one transform per register.
+*/
+void Transform::UpdateMatrices(Transform* const* transforms, size_t count) {
+	size_t i = 0;
+#if defined(NCL_SIMD_SSE2)
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+
+	for (; i + 4 <= count; i += 4) {
+		Transform* const* t = &transforms[i];
+
+		__m128 x = t[0]->orientation.ToSIMD();
+		__m128 y = t[1]->orientation.ToSIMD();
+		__m128 z = t[2]->orientation.ToSIMD();
+		__m128 w = t[3]->orientation.ToSIMD();
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		__m128 sx = SIMD::Load3(t[0]->scale.array);
+		__m128 sy = SIMD::Load3(t[1]->scale.array);
+		__m128 sz = SIMD::Load3(t[2]->scale.array);
+		__m128 sw = SIMD::Load3(t[3]->scale.array);
+		_MM_TRANSPOSE4_PS(sx, sy, sz, sw);
+
+		__m128 yy = _mm_mul_ps(y, y);
+		__m128 zz = _mm_mul_ps(z, z);
+		__m128 xy = _mm_mul_ps(x, y);
+		__m128 zw = _mm_mul_ps(z, w);
+		__m128 xz = _mm_mul_ps(x, z);
+		__m128 yw = _mm_mul_ps(y, w);
+		__m128 xx = _mm_mul_ps(x, x);
+		__m128 yz = _mm_mul_ps(y, z);
+		__m128 xw = _mm_mul_ps(x, w);
+
+		__m128 c0[4] = {
+			_mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, _mm_mul_ps(two, yy)), _mm_mul_ps(two, zz)), sx),
+			_mm_mul_ps(_mm_add_ps(_mm_mul_ps(two, xy), _mm_mul_ps(two, zw)), sx),
+			_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(two, xz), _mm_mul_ps(two, yw)), sx),
+			_mm_setzero_ps()
+		};
+		__m128 c1[4] = {
+			_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(two, xy), _mm_mul_ps(two, zw)), sy),
+			_mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, _mm_mul_ps(two, xx)), _mm_mul_ps(two, zz)), sy),
+			_mm_mul_ps(_mm_add_ps(_mm_mul_ps(two, yz), _mm_mul_ps(two, xw)), sy),
+			_mm_setzero_ps()
+		};
+		__m128 c2[4] = {
+			_mm_mul_ps(_mm_add_ps(_mm_mul_ps(two, xz), _mm_mul_ps(two, yw)), sz),
+			_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(two, yz), _mm_mul_ps(two, xw)), sz),
+			_mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, _mm_mul_ps(two, xx)), _mm_mul_ps(two, yy)), sz),
+			_mm_setzero_ps()
+		};
+		_MM_TRANSPOSE4_PS(c0[0], c0[1], c0[2], c0[3]);
+		_MM_TRANSPOSE4_PS(c1[0], c1[1], c1[2], c1[3]);
+		_MM_TRANSPOSE4_PS(c2[0], c2[1], c2[2], c2[3]);
+
+		for (int j = 0; j < 4; ++j) {
+			float* m = t[j]->matrix.array;
+			SIMD::Store(m, c0[j]);
+			SIMD::Store(m + 4, c1[j]);
+			SIMD::Store(m + 8, c2[j]);
+			SIMD::Store(m + 12, _mm_add_ps(SIMD::Load3(t[j]->position.array), _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f)));
+			t[j]->matrixDirty = false;
+		}
+	}
+#endif
+	for (; i < count; ++i) {
+		transforms[i]->UpdateMatrix();
+	}
 }
 
 Transform& Transform::SetPosition(const Vector3& worldPos) {
-	position = worldPos;
-	UpdateMatrix();
+	position	= worldPos;
+	matrixDirty	= true;
 	return *this;
 }
 
 Transform& Transform::SetScale(const Vector3& worldScale) {
-	scale = worldScale;
-	UpdateMatrix();
+	scale		= worldScale;
+	matrixDirty	= true;
 	return *this;
 }
 
 Transform& Transform::SetOrientation(const Quaternion& worldOrientation) {
-	orientation = worldOrientation;
-	UpdateMatrix();
+	orientation	= worldOrientation;
+	matrixDirty	= true;
 	return *this;
 }
\ No newline at end of file
@@ -34,12 +34,28 @@ namespace NCL {
 				return orientation;
 			}
 
-			Matrix4 GetMatrix() const {
+			//The matrix is only rebuilt when it's asked for, so moving an object
+			//several times a frame only costs one rebuild (or none, if nothing
+			//ever looks at it)
+			const Matrix4& GetMatrix() const {
+				if (matrixDirty) {
+					UpdateMatrix();
+				}
 				return matrix;
 			}
-			void UpdateMatrix();
+
+			bool IsMatrixDirty() const {
+				return matrixDirty;
+			}
+
+			void UpdateMatrix() const;
+
+			//Rebuilds the matrices of a whole array of transforms at once, four
+			//at a time where the SIMD backend allows it
+			static void UpdateMatrices(Transform* const* transforms, size_t count);
 		protected:
-			Matrix4		matrix;
+			mutable Matrix4	matrix;
+			mutable bool	matrixDirty;
 			Quaternion	orientation;
 			Vector3		position;
 
@@ -0,0 +1,244 @@
+#include "TransformHierarchy.h"
+#include <algorithm>
+
+using namespace NCL;
+using namespace NCL::CSC8503;
+
+TransformHierarchy::TransformHierarchy() {
+	orderDirty		= false;
+	updatedCount	= 0;
+}
+
+TransformHierarchy::~TransformHierarchy() {
+}
+
+void TransformHierarchy::Clear() {
+	transforms.clear();
+	parents.clear();
+	localPositions.clear();
+	localOrientations.clear();
+	inheritOrientations.clear();
+	worldPositions.clear();
+	worldOrientations.clear();
+	dirty.clear();
+	nodeIndices.clear();
+
+	orderDirty		= false;
+	updatedCount	= 0;
+}
+
+int TransformHierarchy::FindNode(const Transform* t) const {
+	auto i = nodeIndices.find(t);
+	return i == nodeIndices.end() ? -1 : i->second;
+}
+
+//New nodes go on the end, and get put in the right place by the next Update
+int TransformHierarchy::AddNode(Transform* t) {
+	int index = FindNode(t);
+	if (index >= 0) {
+		return index;
+	}
+	index = (int)transforms.size();
+
+	transforms.emplace_back(t);
+	parents.emplace_back(-1);
+	localPositions.emplace_back(Vector3());
+	localOrientations.emplace_back(Quaternion());
+	inheritOrientations.emplace_back(1);
+	worldPositions.emplace_back(t->GetPosition());
+	worldOrientations.emplace_back(t->GetOrientation());
+	dirty.emplace_back(1);
+
+	nodeIndices[t] = index;
+	orderDirty = true;
+	return index;
+}
+
+bool TransformHierarchy::Attach(Transform* child, Transform* parent, const Vector3& localPosition,
+	const Quaternion& localOrientation, bool inheritOrientation) {
+	if (!child || !parent || child == parent) {
+		return false;
+	}
+	//Can't hang something off one of its own children
+	for (int i = FindNode(parent); i >= 0; i = parents[i]) {
+		if (transforms[i] == child) {
+			return false;
+		}
+	}
+	int p = AddNode(parent);
+	int c = AddNode(child);
+
+	parents[c]				= p;
+	localPositions[c]		= localPosition;
+	localOrientations[c]	= localOrientation;
+	inheritOrientations[c]	= inheritOrientation ? 1 : 0;
+	dirty[c]				= 1;
+
+	orderDirty = true;
+	return true;
+}
+
+void TransformHierarchy::Detach(Transform* child) {
+	int c = FindNode(child);
+	if (c < 0 || parents[c] < 0) {
+		return;
+	}
+	parents[c]	= -1;
+	orderDirty	= true;
+}
+
+void TransformHierarchy::Remove(Transform* t) {
+	int index = FindNode(t);
+	if (index < 0) {
+		return;
+	}
+	for (int& p : parents) {
+		if (p == index) {
+			p = -1;
+		}
+	}
+	transforms[index]	= nullptr;
+	parents[index]		= -1;
+	nodeIndices.erase(t);
+	orderDirty = true;
+}
+
+bool TransformHierarchy::IsAttached(const Transform* child) const {
+	int c = FindNode(child);
+	return c >= 0 && parents[c] >= 0;
+}
+
+Transform* TransformHierarchy::GetParent(const Transform* child) const {
+	int c = FindNode(child);
+	return (c >= 0 && parents[c] >= 0) ? transforms[parents[c]] : nullptr;
+}
+
+void TransformHierarchy::SetLocalPosition(Transform* child, const Vector3& localPosition) {
+	int c = FindNode(child);
+	if (c >= 0) {
+		localPositions[c]	= localPosition;
+		dirty[c]			= 1;
+	}
+}
+
+void TransformHierarchy::SetLocalOrientation(Transform* child, const Quaternion& localOrientation) {
+	int c = FindNode(child);
+	if (c >= 0) {
+		localOrientations[c]	= localOrientation;
+		dirty[c]				= 1;
+	}
+}
+
+/*
+Puts the nodes back into breadth first order, starting from every root that
+still has something attached to it. Removed nodes, and roots that no longer
+have any children, get dropped along the way. This only happens when
+something has been attached or detached, never on a normal frame.
+*/
+void TransformHierarchy::RebuildOrder() {
+	const int oldCount = (int)transforms.size();
+
+	std::vector<std::vector<int>> children(oldCount);
+	std::vector<int> order;
+	order.reserve(oldCount);
+
+	for (int i = 0; i < oldCount; ++i) {
+		if (transforms[i] && parents[i] >= 0) {
+			children[parents[i]].emplace_back(i);
+		}
+	}
+	for (int i = 0; i < oldCount; ++i) {
+		if (transforms[i] && parents[i] < 0 && !children[i].empty()) {
+			order.emplace_back(i);
+		}
+	}
+	//order doubles up as the queue - everything before 'next' has been visited
+	for (size_t next = 0; next < order.size(); ++next) {
+		for (int c : children[order[next]]) {
+			order.emplace_back(c);
+		}
+	}
+
+	std::vector<int> newIndices(oldCount, -1);
+	for (int i = 0; i < (int)order.size(); ++i) {
+		newIndices[order[i]] = i;
+	}
+
+	auto Reorder = [&order](auto& v) {
+		auto old = v;
+		v.resize(order.size());
+		for (size_t i = 0; i < order.size(); ++i) {
+			v[i] = old[order[i]];
+		}
+	};
+	Reorder(transforms);
+	Reorder(parents);
+	Reorder(localPositions);
+	Reorder(localOrientations);
+	Reorder(inheritOrientations);
+	Reorder(worldPositions);
+	Reorder(worldOrientations);
+	Reorder(dirty);
+
+	nodeIndices.clear();
+	for (int i = 0; i < (int)transforms.size(); ++i) {
+		if (parents[i] >= 0) {
+			parents[i] = newIndices[parents[i]];
+		}
+		nodeIndices[transforms[i]] = i;
+	}
+	std::fill(dirty.begin(), dirty.end(), 1);
+	orderDirty = false;
+}
+
+/*
+As parents always come before their children, by the time a node is reached
+its parent's world position is final, and its parent's dirty flag says
+whether anything above it moved this frame - so dirtiness flows down the
+hierarchy without any recursion.
+
+Roots are moved by something else (physics, game code), so they are only
+checked against where they were last Update.
+*/
+void TransformHierarchy::Update() {
+	if (orderDirty) {
+		RebuildOrder();
+	}
+	updatedCount = 0;
+
+	const int count = (int)transforms.size();
+	for (int i = 0; i < count; ++i) {
+		Transform* t = transforms[i];
+		const int p = parents[i];
+
+		if (p < 0) {
+			const Vector3		pos		= t->GetPosition();
+			const Quaternion	orient	= t->GetOrientation();
+			if (pos != worldPositions[i] || orient != worldOrientations[i]) {
+				worldPositions[i]		= pos;
+				worldOrientations[i]	= orient;
+				dirty[i]				= 1;
+			}
+			continue;
+		}
+		if (!dirty[i] && !dirty[p]) {
+			continue;
+		}
+		dirty[i] = 1;
+
+		if (inheritOrientations[i]) {
+			const Quaternion& parentOrient = worldOrientations[p];
+			worldPositions[i]		= worldPositions[p] + parentOrient * localPositions[i];
+			worldOrientations[i]	= parentOrient * localOrientations[i];
+		}
+		else {
+			worldPositions[i]		= worldPositions[p] + localPositions[i];
+			worldOrientations[i]	= localOrientations[i];
+		}
+
+		t->SetPosition(worldPositions[i]);
+		t->SetOrientation(worldOrientations[i]);
+		updatedCount++;
+	}
+	std::fill(dirty.begin(), dirty.end(), 0);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "Transform.h"
+#include <vector>
+#include <unordered_map>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Lets Transforms be parented to other Transforms, so that they follow them
+		around without any per-object code.
+
+		Every Transform that is a parent or a child gets a node, and the nodes are
+		kept in breadth first order in flat arrays - every parent comes before all
+		of its children, so a single pass from the start to the end is enough to
+		move everything into place. Nodes only get recalculated if they, or
+		something above them, have moved since the last Update, so a big hierarchy
+		where only a few branches move only costs a flag check per node.
+
+		Only position and orientation are passed down - scale is left alone, as a
+		Transform's scale is also the size of its mesh and collision volume, and
+		children of a big floor shouldn't become huge too. Local positions are
+		in the parent's rotated space, but aren't scaled by it.
+
+		Children have their Transforms overwritten whenever their parent moves, so
+		anything with a PhysicsObject should have an inverse mass of 0.
+		*/
+		class TransformHierarchy {
+		public:
+			TransformHierarchy();
+			~TransformHierarchy();
+
+			void Clear();
+
+			//Children that don't inherit orientation only follow their parent's position,
+			//with the local position in world space - handy for cameras and shadows.
+			//Returns false (and does nothing) if 'child' is already above 'parent'
+			bool Attach(Transform* child, Transform* parent, const Vector3& localPosition,
+				const Quaternion& localOrientation = Quaternion(), bool inheritOrientation = true);
+
+			//Lets a child move freely again, from wherever it currently is. Its own
+			//children stay attached to it
+			void Detach(Transform* child);
+
+			//Takes a Transform out of the hierarchy completely, its children are detached
+			void Remove(Transform* t);
+
+			bool		IsAttached(const Transform* child) const;
+			Transform*	GetParent(const Transform* child) const;
+
+			void SetLocalPosition(Transform* child, const Vector3& localPosition);
+			void SetLocalOrientation(Transform* child, const Quaternion& localOrientation);
+
+			//Moves every child whose parent (or local offset) has changed
+			void Update();
+
+			int GetNodeCount() const {
+				return (int)transforms.size();
+			}
+
+			//How many nodes the last Update actually had to recalculate
+			int GetUpdatedCount() const {
+				return updatedCount;
+			}
+
+		protected:
+			int		FindNode(const Transform* t) const;
+			int		AddNode(Transform* t);
+			void	RebuildOrder();
+
+			std::vector<Transform*>		transforms;
+			std::vector<int>			parents;	//-1 for roots
+			std::vector<Vector3>		localPositions;
+			std::vector<Quaternion>		localOrientations;
+			std::vector<char>			inheritOrientations;
+			std::vector<Vector3>		worldPositions;
+			std::vector<Quaternion>		worldOrientations;
+			std::vector<char>			dirty;
+
+			std::unordered_map<const Transform*, int> nodeIndices;
+
+			bool	orderDirty;
+			int		updatedCount;
+		};
+	}
+}
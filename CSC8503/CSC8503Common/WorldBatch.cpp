@@ -0,0 +1,68 @@
+#include "WorldBatch.h"
+#include "../../Common/FrameArena.h"
+#include "../../Common/GameTimer.h"
+#include "../../Common/JobSystem.h"
+#include "../../Common/Profiler.h"
+
+using namespace NCL;
+using namespace CSC8503;
+
+void WorldBatch::AddWorlds(int count, const BuildFunc& build) {
+	instances.reserve(instances.size() + count);
+	for (int i = 0; i < count; ++i) {
+		instances.emplace_back(new Instance((int)instances.size()));
+		Debug::ContextScope debug(instances.back()->debug);
+		build(*instances.back());
+	}
+}
+
+void WorldBatch::Clear() {
+	for (auto& i : instances) {
+		i->physics.Clear();
+		i->world.ClearAndErase();
+	}
+	instances.clear();
+}
+
+//Anything drawn is aged out with the world's own context, rather than left to pile up
+void WorldBatch::StepWorld(Instance& i, float dt) {
+	Debug::ContextScope debug(i.debug);
+	if (stepFunction) {
+		stepFunction(i, dt);
+	}
+	i.world.UpdateWorld(dt);
+	i.physics.Update(dt);
+	Debug::FlushRenderables(dt);
+	i.steps++;
+}
+
+/*
+A world's own physics jobs can end up running on any thread, as can other
+worlds' - each job only ever touches its own world, so it doesn't matter
+which, or if one world's step ends up run inside another's Wait.
+*/
+void WorldBatch::Step(float dt) {
+	NCL_PROFILE_SCOPE("WorldBatch::Step");
+	JobSystem::ParallelFor(0, (int)instances.size(), 1,
+		[&](int start, int end) {
+			for (int i = start; i < end; ++i) {
+				StepWorld(*instances[i], dt);
+			}
+		}
+	);
+	FrameArena::EndFrame();
+}
+
+const WorldBatchTimings& WorldBatch::Run(int steps, float dt) {
+	GameTimer timer;
+	timer.Tick();
+	for (int i = 0; i < steps; ++i) {
+		Step(dt);
+	}
+	timer.Tick();
+	timings.worlds	= (int)instances.size();
+	timings.steps	= steps;
+	timings.seconds	= timer.GetTimeDeltaSeconds();
+	timings.worldStepsPerSecond = timings.seconds > 0.0 ? (timings.worlds * (double)steps) / timings.seconds : 0.0;
+	return timings;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "GameWorld.h"
+#include "PhysicsSystem.h"
+#include "Debug.h"
+#include <functional>
+#include <memory>
+
+namespace NCL {
+	namespace CSC8503 {
+		//How long the last call to WorldBatch::Run took, and how much it got through
+		struct WorldBatchTimings {
+			int		worlds		= 0;
+			int		steps		= 0;	//Of each world
+			double	seconds		= 0.0;
+			double	worldStepsPerSecond	= 0.0;
+		};
+
+		/*
+		A batch of worlds that have nothing to do with each other - each has
+		its own GameWorld, PhysicsSystem and Debug context - stepped side by
+		side, a job per world, for running lots of short matches of the same
+		level at once (training AI, or balancing a level offline).
+
+		The worlds are stepped in lockstep: every world takes a step, then the
+		frame arena is moved on, then the next step, as the arena can only be
+		moved on with no jobs running. Physics is stepped at a fixed rate in
+		every world, as the adaptive timestep depends on how long each step
+		takes, which would make worlds that started off the same drift apart.
+		*/
+		class WorldBatch {
+		public:
+			struct Instance {
+				Instance(int index) : physics(world), index(index) {
+					physics.UseAdaptiveTimestep(false);
+				}
+
+				GameWorld		world;
+				PhysicsSystem	physics;
+				Debug::Context	debug;
+				int				index;		//Where it is in the batch
+				int				steps = 0;	//How many times it has been stepped
+			};
+			//Fills in a new world
+			typedef std::function<void(Instance&)> BuildFunc;
+			//Runs whatever game logic a world needs, each step, before its physics
+			typedef std::function<void(Instance&, float dt)> StepFunc;
+
+			WorldBatch()	{}
+			~WorldBatch()	{}
+
+			//Makes count more worlds, calling build for each of them in turn
+			void AddWorlds(int count, const BuildFunc& build);
+			void Clear();
+
+			void SetStepFunction(const StepFunc& func) {
+				stepFunction = func;
+			}
+
+			//Steps every world once, each as its own job, and waits for them all
+			void Step(float dt);
+			//Steps every world steps times, and times it
+			const WorldBatchTimings& Run(int steps, float dt);
+
+			int GetWorldCount() const {
+				return (int)instances.size();
+			}
+
+			Instance& GetWorld(int i) {
+				return *instances[i];
+			}
+
+			const WorldBatchTimings& GetTimings() const {
+				return timings;
+			}
+
+		protected:
+			WorldBatch(const WorldBatch&) = delete;
+			WorldBatch& operator=(const WorldBatch&) = delete;
+
+			void StepWorld(Instance& i, float dt);
+
+			std::vector<std::unique_ptr<Instance>>	instances;
+			StepFunc			stepFunction;
+			WorldBatchTimings	timings;
+		};
+	}
+}
@@ -0,0 +1,323 @@
+#include "WorldPartition.h"
+#include "GameWorld.h"
+#include "../../Common/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+using namespace NCL;
+using namespace CSC8503;
+
+WorldPartition::WorldPartition(GameWorld& world, const LevelFile::Bindings& bindings, float cellSize)
+	: world(world), bindings(bindings), cellSize(cellSize) {
+	for (int& count : stateCounts) {
+		count = 0;
+	}
+	streamingThread = std::thread(&WorldPartition::StreamingLoop, this);
+}
+
+WorldPartition::~WorldPartition() {
+	{
+		std::lock_guard<std::mutex> lock(streamingLock);
+		stopStreaming = true;
+	}
+	streamingWake.notify_one();
+	streamingThread.join();
+	Clear();
+}
+
+void WorldPartition::AddCell(int x, int z, const std::string& filename) {
+	auto existing = cellIndices.find(CellKey(x, z));
+	if (existing != cellIndices.end()) {
+		Cell& c = cells[existing->second];
+		Unload(c);
+		c.filename	= filename;
+		c.failed	= false;
+		return;
+	}
+	cellIndices.emplace(CellKey(x, z), (int)cells.size());
+	cells.emplace_back();
+	cells.back().x			= x;
+	cells.back().z			= z;
+	cells.back().filename	= filename;
+	stateCounts[(int)CellState::Unloaded]++;
+}
+
+std::string WorldPartition::GetCellFilename(const std::string& filePrefix, int x, int z) {
+	return filePrefix + "_" + std::to_string(x) + "_" + std::to_string(z) + ".level";
+}
+
+int WorldPartition::SaveCells(const GameWorld& source, const std::string& filePrefix) {
+	std::map<std::pair<int, int>, std::vector<GameObject*>> byCell;
+	for (GameObject* o : source.GetGameObjects()) {
+		Vector3 position = o->GetTransform().GetPosition();
+		byCell[{ (int)std::floor(position.x / cellSize), (int)std::floor(position.z / cellSize) }].emplace_back(o);
+	}
+	int saved	= 0;
+	bool failed	= false;
+	LevelFile level;
+	for (auto& c : byCell) {
+		std::string filename = GetCellFilename(filePrefix, c.first.first, c.first.second);
+		level.Capture(c.second, bindings);
+		if (!level.Save(filename)) {
+			failed = true;
+			continue;
+		}
+		AddCell(c.first.first, c.first.second, filename);
+		saved++;
+	}
+	return failed ? -1 : saved;
+}
+
+void WorldPartition::SetRadii(int newActiveRadius, int newLoadRadius) {
+	activeRadius	= std::max(0, newActiveRadius);
+	loadRadius		= std::max(activeRadius, newLoadRadius);
+}
+
+void WorldPartition::SetState(Cell& c, CellState state) {
+	stateCounts[(int)c.state]--;
+	stateCounts[(int)state]++;
+	c.state = state;
+}
+
+/*
+Works out what each cell should be from how far it is from the focus, and
+moves it on towards that. Everything but making a newly loaded cell's
+objects is cheap, so only that is held to a budget, nearest cells first.
+*/
+void WorldPartition::Update(const Vector3& focus) {
+	NCL_PROFILE_SCOPE("WorldPartition::Update");
+	ReceiveLoads();
+
+	int focusX = (int)std::floor(focus.x / cellSize);
+	int focusZ = (int)std::floor(focus.z / cellSize);
+
+	toBuild.clear();
+	std::vector<std::pair<int, int>> newLoads; //Distance, and cell index
+	for (size_t i = 0; i < cells.size(); ++i) {
+		Cell& c = cells[i];
+		c.distance = std::max(std::abs(c.x - focusX), std::abs(c.z - focusZ));
+
+		if (c.distance <= activeRadius) {
+			c.wanted = CellState::Active;
+		}
+		else if (c.distance <= loadRadius) {
+			c.wanted = CellState::Inactive;
+		}
+		else if (c.distance <= loadRadius + 1) {
+			c.wanted = (c.state == CellState::Unloaded) ? CellState::Unloaded : CellState::Inactive;
+		}
+		else {
+			c.wanted = CellState::Unloaded;
+		}
+
+		switch (c.state) {
+			case CellState::Unloaded:
+				if (c.wanted != CellState::Unloaded && !c.failed) {
+					newLoads.emplace_back(c.distance, (int)i);
+					SetState(c, CellState::Loading);
+				}
+				break;
+			case CellState::Loading:
+				if (c.wanted == CellState::Unloaded) {
+					Unload(c);
+				}
+				break;
+			case CellState::Loaded:
+				if (c.wanted == CellState::Active) {
+					toBuild.emplace_back((int)i);
+				}
+				else if (c.wanted == CellState::Unloaded) {
+					Unload(c);
+				}
+				break;
+			case CellState::Active:
+				if (c.wanted == CellState::Inactive) {
+					Deactivate(c);
+				}
+				else if (c.wanted == CellState::Unloaded) {
+					Unload(c);
+				}
+				break;
+			case CellState::Inactive:
+				if (c.wanted == CellState::Active) {
+					Activate(c);
+				}
+				else if (c.wanted == CellState::Unloaded) {
+					Unload(c);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+	std::sort(toBuild.begin(), toBuild.end(),
+		[this](int a, int b) { return cells[a].distance < cells[b].distance; });
+	for (size_t i = 0; i < toBuild.size() && (int)i < buildsPerUpdate; ++i) {
+		Activate(cells[toBuild[i]]);
+	}
+	if (!newLoads.empty()) {
+		std::sort(newLoads.begin(), newLoads.end());
+		loadCount += (int)newLoads.size();
+		{
+			std::lock_guard<std::mutex> lock(streamingLock);
+			for (const auto& l : newLoads) {
+				loadRequests.emplace_back(l.second, cells[l.second].filename);
+			}
+		}
+		streamingWake.notify_one();
+	}
+}
+
+void WorldPartition::ReceiveLoads() {
+	std::vector<std::pair<int, std::unique_ptr<LevelFile>>> arrived;
+	{
+		std::lock_guard<std::mutex> lock(streamingLock);
+		if (finishedLoads.empty()) {
+			return;
+		}
+		arrived.swap(finishedLoads);
+	}
+	for (auto& l : arrived) {
+		Cell& c = cells[l.first];
+		if (c.state != CellState::Loading) {
+			continue; //Not wanted any more
+		}
+		if (!l.second) {
+			c.failed = true; //So it isn't tried again every frame
+			SetState(c, CellState::Unloaded);
+			continue;
+		}
+		c.level = std::move(l.second);
+		SetState(c, CellState::Loaded);
+	}
+}
+
+void WorldPartition::Activate(Cell& c) {
+	if (c.state == CellState::Loaded) {
+		c.objects.clear();
+		c.level->AddToWorld(world, bindings, &c.objects);
+	}
+	else {
+		for (GameObject* o : c.objects) {
+			world.AddGameObject(o);
+		}
+	}
+	c.handles.clear();
+	for (GameObject* o : c.objects) {
+		c.handles.emplace_back(o->GetHandle());
+	}
+	SetState(c, CellState::Active);
+}
+
+/*
+Objects that have left the world since their cell was made active (coins
+that have been collected, say) are someone else's now, and are forgotten.
+Everything else is taken out, but keeps its components.
+*/
+void WorldPartition::Deactivate(Cell& c) {
+	size_t kept = 0;
+	for (size_t i = 0; i < c.objects.size(); ++i) {
+		if (world.GetGameObject(c.handles[i]) == c.objects[i]) {
+			world.RemoveGameObject(c.objects[i], false);
+			c.objects[kept++] = c.objects[i];
+		}
+	}
+	c.objects.resize(kept);
+	c.handles.clear();
+	SetState(c, CellState::Inactive);
+}
+
+/*
+An inactive cell's objects were taken out of the world at least an Update
+ago, so they're out of its list by now, and can be deleted straight away.
+A cell still loading is only taken off the queue if it hasn't been started,
+otherwise its level is dropped when it arrives.
+*/
+void WorldPartition::Unload(Cell& c) {
+	if (c.state == CellState::Loading) {
+		int index = (int)(&c - cells.data());
+		std::lock_guard<std::mutex> lock(streamingLock);
+		auto request = std::find_if(loadRequests.begin(), loadRequests.end(),
+			[index](const std::pair<int, std::string>& r) { return r.first == index; });
+		if (request != loadRequests.end()) {
+			loadRequests.erase(request);
+		}
+	}
+	else if (c.state == CellState::Active) {
+		for (size_t i = 0; i < c.objects.size(); ++i) {
+			if (world.GetGameObject(c.handles[i]) == c.objects[i]) {
+				world.RemoveGameObject(c.objects[i], true);
+			}
+		}
+	}
+	else if (c.state == CellState::Inactive) {
+		for (GameObject* o : c.objects) {
+			world.DestroyGameObject(o);
+		}
+	}
+	c.objects.clear();
+	c.handles.clear();
+	c.level.reset();
+	SetState(c, CellState::Unloaded);
+}
+
+void WorldPartition::Clear() {
+	{
+		std::lock_guard<std::mutex> lock(streamingLock);
+		loadRequests.clear();
+	}
+	for (Cell& c : cells) {
+		Unload(c);
+		c.wanted = CellState::Unloaded;
+	}
+}
+
+bool WorldPartition::IsSettled() const {
+	for (const Cell& c : cells) {
+		if (c.state == CellState::Loading) {
+			return false;
+		}
+		if (c.wanted == CellState::Active && c.state != CellState::Active && !c.failed) {
+			return false;
+		}
+	}
+	return true;
+}
+
+CellState WorldPartition::GetCellState(int x, int z) const {
+	auto i = cellIndices.find(CellKey(x, z));
+	return i == cellIndices.end() ? CellState::Unloaded : cells[i->second].state;
+}
+
+size_t WorldPartition::GetActiveObjectCount() const {
+	size_t count = 0;
+	for (const Cell& c : cells) {
+		if (c.state == CellState::Active) {
+			count += c.handles.size();
+		}
+	}
+	return count;
+}
+
+//Runs on the streaming thread - it only ever touches the requests and finished loads
+void WorldPartition::StreamingLoop() {
+	while (true) {
+		std::pair<int, std::string> request;
+		{
+			std::unique_lock<std::mutex> lock(streamingLock);
+			streamingWake.wait(lock, [this] { return stopStreaming || !loadRequests.empty(); });
+			if (stopStreaming) {
+				return;
+			}
+			request = std::move(loadRequests.front());
+			loadRequests.pop_front();
+		}
+		std::unique_ptr<LevelFile> level(new LevelFile());
+		if (!level->Load(request.second)) {
+			level.reset();
+		}
+		std::lock_guard<std::mutex> lock(streamingLock);
+		finishedLoads.emplace_back(request.first, std::move(level));
+	}
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include "LevelFile.h"
+#include "GameObjectHandle.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace NCL {
+	namespace CSC8503 {
+		class GameWorld;
+
+		enum class CellState {
+			Unloaded = 0,
+			Loading,	//Its file is being read on the streaming thread
+			Loaded,		//Its level is in memory, but none of its objects have been made
+			Active,		//Its objects are in the world
+			Inactive,	//Its objects have been made, but are out of the world
+			MAX_STATES
+		};
+
+		/*
+		Splits a big map into a grid of square cells across the XZ plane, each
+		saved as its own LevelFile, and streams them in and out around a focus
+		point (the player, or the camera) as it moves.
+
+		Cells near the focus are Active, and their objects are in the world.
+		Further out they're Inactive - their objects are taken out of the
+		world, so the physics, the AI and the renderer never see them, but are
+		kept as they were, so they can go straight back in. Further still,
+		their objects are deleted and the level dropped. Files are read on a
+		thread of their own, rather than as jobs, as a job stuck waiting on
+		the disk would hold up whichever thread picked it up - which, in a
+		JobSystem::Wait, could be the main one.
+
+		Objects belong to the cell they were loaded in, wherever they move
+		to, and whatever happens to a cell is forgotten once it's unloaded -
+		it comes back as it was saved. An object's handle changes each time
+		its cell is made active again, so cells' objects should be found
+		again by type or tag, rather than held on to.
+		*/
+		class WorldPartition {
+		public:
+			WorldPartition(GameWorld& world, const LevelFile::Bindings& bindings, float cellSize);
+			~WorldPartition();
+
+			//A cell the partition can stream in, from a file saved by SaveCells
+			void AddCell(int x, int z, const std::string& filename);
+
+			/*
+			Splits the objects in source into cells by where they are, saves
+			each cell's objects as a level, and adds the cells. Returns how
+			many cells were saved, or -1 if any couldn't be.
+			*/
+			int SaveCells(const GameWorld& source, const std::string& filePrefix);
+
+			static std::string GetCellFilename(const std::string& filePrefix, int x, int z);
+
+			/*
+			How far from the focus's cell, in cells, a cell stays active, and
+			stays in memory. Cells beyond loadRadius + 1 are unloaded, so that
+			one going back and forth over a cell's edge doesn't keep loading
+			and unloading it.
+			*/
+			void SetRadii(int activeRadius, int loadRadius);
+
+			//Most cells to make the objects for each Update - it's the
+			//only part of streaming a cell in done on the main thread
+			void SetBuildsPerUpdate(int count) {
+				buildsPerUpdate = count;
+			}
+
+			//Call once a frame, from the main thread, before the physics
+			void Update(const Vector3& focus);
+
+			//Unloads every cell - call before clearing the world
+			void Clear();
+
+			//True once every cell is in the state the last Update wanted
+			bool IsSettled() const;
+
+			size_t GetCellCount() const {
+				return cells.size();
+			}
+
+			int CountCells(CellState state) const {
+				return stateCounts[(int)state];
+			}
+
+			CellState GetCellState(int x, int z) const;
+
+			//How many times a cell's file has been sent to be read
+			int GetLoadCount() const {
+				return loadCount;
+			}
+
+			//How many objects active cells have in the world
+			size_t GetActiveObjectCount() const;
+
+			float GetCellSize() const {
+				return cellSize;
+			}
+
+		protected:
+			struct Cell {
+				int				x;
+				int				z;
+				std::string		filename;
+				CellState		state		= CellState::Unloaded;
+				CellState		wanted		= CellState::Unloaded;
+				int				distance	= 0;	//From the focus's cell, as of the last Update
+				bool			failed		= false;
+				std::unique_ptr<LevelFile>		level;
+				std::vector<GameObject*>		objects;
+				std::vector<GameObjectHandle>	handles;	//While active
+			};
+
+			static int64_t CellKey(int x, int z) {
+				return ((int64_t)x << 32) | (uint32_t)z;
+			}
+
+			void SetState(Cell& c, CellState state);
+			void ReceiveLoads();
+			void Activate(Cell& c);
+			void Deactivate(Cell& c);
+			void Unload(Cell& c);
+
+			void StreamingLoop();
+
+			GameWorld&			world;
+			LevelFile::Bindings	bindings;
+			float				cellSize;
+			int					activeRadius	= 1;
+			int					loadRadius		= 2;
+			int					buildsPerUpdate	= 2;
+			int					loadCount		= 0;
+
+			std::vector<Cell>					cells;
+			std::unordered_map<int64_t, int>	cellIndices;
+			int		stateCounts[(int)CellState::MAX_STATES];
+			std::vector<int> toBuild;	//Scratch space for Update
+
+			//Shared with the streaming thread, behind streamingLock
+			std::thread					streamingThread;
+			std::mutex					streamingLock;
+			std::condition_variable		streamingWake;
+			std::deque<std::pair<int, std::string>> loadRequests;	//Cell index, and its file
+			std::vector<std::pair<int, std::unique_ptr<LevelFile>>> finishedLoads; //Null if it couldn't be read
+			bool						stopStreaming = false;
+		};
+	}
+}
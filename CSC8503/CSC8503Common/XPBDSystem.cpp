@@ -0,0 +1,229 @@
+#include "XPBDSystem.h"
+#include "GameObject.h"
+#include "Debug.h"
+#include "../../Common/SIMDKernels.h"
+#include "../../Common/Profiler.h"
+
+using namespace NCL;
+using namespace CSC8503;
+
+XPBDSystem::XPBDSystem()	{
+	substeps	= 10;
+	damping		= 0.0f;
+}
+
+XPBDSystem::~XPBDSystem()	{
+}
+
+void XPBDSystem::Clear() {
+	positions.clear();
+	previousPositions.clear();
+	velocities.clear();
+	inverseMasses.clear();
+
+	distanceConstraints.clear();
+	bendingConstraints.clear();
+	volumeConstraints.clear();
+
+	attachments.clear();
+	bindings.clear();
+}
+
+int XPBDSystem::AddParticle(const Vector3& position, float inverseMass) {
+	positions.emplace_back(position);
+	previousPositions.emplace_back(position);
+	velocities.emplace_back(Vector3());
+	inverseMasses.emplace_back(inverseMass);
+	return (int)positions.size() - 1;
+}
+
+void XPBDSystem::AddDistanceConstraint(int a, int b, float compliance) {
+	DistanceConstraint c;
+	c.a				= a;
+	c.b				= b;
+	c.restLength	= (positions[a] - positions[b]).Length();
+	c.compliance	= compliance;
+	distanceConstraints.emplace_back(c);
+}
+
+void XPBDSystem::AddBendingConstraint(int a, int b, int c, float compliance) {
+	BendingConstraint bc;
+	bc.a			= a;
+	bc.b			= b;
+	bc.c			= c;
+	bc.restHeight	= (positions[b] - (positions[a] + positions[b] + positions[c]) / 3.0f).Length();
+	bc.compliance	= compliance;
+	bendingConstraints.emplace_back(bc);
+}
+
+void XPBDSystem::AddVolumeConstraint(int a, int b, int c, int d, float compliance) {
+	VolumeConstraint vc;
+	vc.p[0]			= a;
+	vc.p[1]			= b;
+	vc.p[2]			= c;
+	vc.p[3]			= d;
+	vc.restVolume	= TetrahedronVolume(a, b, c, d);
+	vc.compliance	= compliance;
+	volumeConstraints.emplace_back(vc);
+}
+
+void XPBDSystem::AttachParticle(int particle, const Transform* transform, const Vector3& offset) {
+	inverseMasses[particle] = 0.0f;
+	attachments.push_back({ particle, transform, offset });
+}
+
+void XPBDSystem::BindObject(GameObject* object, int particle) {
+	bindings.push_back({ object, particle });
+}
+
+float XPBDSystem::TetrahedronVolume(int a, int b, int c, int d) const {
+	PaddedVector3 e1 = positions[b] - positions[a];
+	PaddedVector3 e2 = positions[c] - positions[a];
+	PaddedVector3 e3 = positions[d] - positions[a];
+	return PaddedVector3::Dot(PaddedVector3::Cross(e1, e2), e3) / 6.0f;
+}
+
+void XPBDSystem::Update(float dt, const Vector3& gravity) {
+	NCL_PROFILE_SCOPE("XPBDSystem::Update");
+	if (positions.empty()) {
+		return;
+	}
+	float subDt = dt / substeps;
+	for (int i = 0; i < substeps; ++i) {
+		Substep(subDt, gravity);
+	}
+	for (const Binding& b : bindings) {
+		b.object->GetTransform().SetPosition(positions[b.particle]);
+		if (b.object->GetPhysicsObject()) {
+			b.object->GetPhysicsObject()->SetLinearVelocity(velocities[b.particle]);
+		}
+	}
+}
+
+/*
+
+Each substep predicts where every particle is going to end up, moves those
+predictions until the constraints are met, and then works out the velocity
+from how far each particle actually moved. With small enough substeps a
+single pass over the constraints is all that is needed, so the Lagrange
+multipliers never need to be stored between iterations.
+
+*/
+void XPBDSystem::Substep(float dt, const Vector3& gravity) {
+	float frameDamping = 1.0f - (damping * dt);
+
+	SIMD::IntegrateParticles(positions.data(), previousPositions.data(), velocities.data(),
+		inverseMasses.data(), positions.size(), gravity * dt, frameDamping, dt);
+
+	for (const Attachment& a : attachments) {
+		positions[a.particle] = a.transform->GetPosition() + a.offset;
+	}
+
+	SolveDistanceConstraints(dt);
+	SolveBendingConstraints(dt);
+	SolveVolumeConstraints(dt);
+
+	float invDt = 1.0f / dt;
+	for (size_t i = 0; i < positions.size(); ++i) {
+		velocities[i] = (positions[i] - previousPositions[i]) * invDt;
+	}
+}
+
+void XPBDSystem::SolveDistanceConstraints(float dt) {
+	float invDt2 = 1.0f / (dt * dt);
+
+	for (const DistanceConstraint& c : distanceConstraints) {
+		float wA = inverseMasses[c.a];
+		float wB = inverseMasses[c.b];
+		float w = wA + wB;
+		if (w == 0.0f) {
+			continue;
+		}
+		PaddedVector3 delta	= positions[c.a] - positions[c.b];
+		float length		= delta.Length();
+		if (length == 0.0f) {
+			continue;
+		}
+		PaddedVector3 normal = delta / length;
+		float C = length - c.restLength;
+
+		float alpha		= c.compliance * invDt2;
+		float lambda	= -C / (w + alpha);
+
+		positions[c.a] += normal * (lambda * wA);
+		positions[c.b] -= normal * (lambda * wB);
+	}
+}
+
+/*
+C = |b - centre| - restHeight, where centre is the average of a, b and c. The
+gradient for b is 2/3 of the direction away from the centre, a and c get -1/3.
+*/
+void XPBDSystem::SolveBendingConstraints(float dt) {
+	float invDt2 = 1.0f / (dt * dt);
+
+	for (const BendingConstraint& c : bendingConstraints) {
+		float wA = inverseMasses[c.a];
+		float wB = inverseMasses[c.b];
+		float wC = inverseMasses[c.c];
+
+		float w = (wA + 4.0f * wB + wC) / 9.0f;
+		if (w == 0.0f) {
+			continue;
+		}
+		PaddedVector3 centre	= (positions[c.a] + positions[c.b] + positions[c.c]) / 3.0f;
+		PaddedVector3 height	= positions[c.b] - centre;
+		float length			= height.Length();
+		if (length == 0.0f) {
+			continue;
+		}
+		PaddedVector3 normal = height / length;
+		float C = length - c.restHeight;
+
+		float alpha		= c.compliance * invDt2;
+		float lambda	= -C / (w + alpha);
+
+		positions[c.a] -= normal * (lambda * wA / 3.0f);
+		positions[c.b] += normal * (lambda * wB * 2.0f / 3.0f);
+		positions[c.c] -= normal * (lambda * wC / 3.0f);
+	}
+}
+
+void XPBDSystem::SolveVolumeConstraints(float dt) {
+	float invDt2 = 1.0f / (dt * dt);
+
+	for (const VolumeConstraint& c : volumeConstraints) {
+		PaddedVector3 p0 = positions[c.p[0]];
+		PaddedVector3 e1 = positions[c.p[1]] - p0;
+		PaddedVector3 e2 = positions[c.p[2]] - p0;
+		PaddedVector3 e3 = positions[c.p[3]] - p0;
+
+		PaddedVector3 grads[4];
+		grads[1] = PaddedVector3::Cross(e2, e3) / 6.0f;
+		grads[2] = PaddedVector3::Cross(e3, e1) / 6.0f;
+		grads[3] = PaddedVector3::Cross(e1, e2) / 6.0f;
+		grads[0] = -(grads[1] + grads[2] + grads[3]);
+
+		float w = 0.0f;
+		for (int i = 0; i < 4; ++i) {
+			w += inverseMasses[c.p[i]] * PaddedVector3::Dot(grads[i], grads[i]);
+		}
+		if (w == 0.0f) {
+			continue;
+		}
+		float C = PaddedVector3::Dot(e1, grads[1]) - c.restVolume;
+
+		float alpha		= c.compliance * invDt2;
+		float lambda	= -C / (w + alpha);
+
+		for (int i = 0; i < 4; ++i) {
+			positions[c.p[i]] += grads[i] * (lambda * inverseMasses[c.p[i]]);
+		}
+	}
+}
+
+void XPBDSystem::DebugDraw() const {
+	for (const DistanceConstraint& c : distanceConstraints) {
+		Debug::DrawLine(positions[c.a], positions[c.b], Vector4(1, 1, 0, 1));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+#include "../../Common/Vector3.h"
+#include "../../Common/PaddedVector3.h"
+#include <vector>
+
+using namespace NCL::Maths;
+
+namespace NCL {
+	namespace CSC8503 {
+		class GameObject;
+		class Transform;
+
+		/*
+		An extended position based dynamics (XPBD) solver for ropes, chains and
+		cloth. Rather than rigid bodies, it works on particles, which are stored
+		in flat arrays, as are the constraints between them.
+
+		Constraints work directly on positions, and their stiffness is given as
+		a compliance (the inverse of stiffness, in m/N) that doesn't depend on
+		the timestep - 0 is completely rigid. Each update is split into a number
+		of small substeps, which converges much faster on long chains than
+		adding more solver iterations does.
+
+		Particles can be pinned to a Transform (a banner pole, or the end of a
+		bridge), and a GameObject can be bound to a particle so that it gets
+		rendered and collided against wherever the particle ends up. The
+		coupling is one way - give bound objects an inverse mass of 0.
+		*/
+		class XPBDSystem	{
+		public:
+			XPBDSystem();
+			~XPBDSystem();
+
+			void Clear();
+
+			void Update(float dt, const Vector3& gravity);
+
+			int AddParticle(const Vector3& position, float inverseMass);
+
+			//Rest lengths / heights / volumes are taken from the particles' current positions
+			void AddDistanceConstraint(int a, int b, float compliance = 0.0f);
+			//Keeps b (the middle particle) at its rest distance from the centre of a, b and c
+			void AddBendingConstraint(int a, int b, int c, float compliance = 0.0f);
+			//Keeps the volume of the tetrahedron a, b, c, d
+			void AddVolumeConstraint(int a, int b, int c, int d, float compliance = 0.0f);
+
+			//The particle follows the transform (plus offset) every substep
+			void AttachParticle(int particle, const Transform* transform, const Vector3& offset = Vector3());
+			//The object follows the particle after every update
+			void BindObject(GameObject* object, int particle);
+
+			void SetSubsteps(int count) {
+				substeps = count > 0 ? count : 1;
+			}
+
+			int GetSubsteps() const {
+				return substeps;
+			}
+
+			void SetDamping(float d) {
+				damping = d;
+			}
+
+			int GetParticleCount() const {
+				return (int)positions.size();
+			}
+
+			Vector3 GetParticlePosition(int particle) const {
+				return positions[particle];
+			}
+
+			void SetParticlePosition(int particle, const Vector3& position) {
+				positions[particle]			= position;
+				previousPositions[particle] = position;
+			}
+
+			Vector3 GetParticleVelocity(int particle) const {
+				return velocities[particle];
+			}
+
+			void SetParticleVelocity(int particle, const Vector3& velocity) {
+				velocities[particle] = velocity;
+			}
+
+			float GetParticleInverseMass(int particle) const {
+				return inverseMasses[particle];
+			}
+
+			void DebugDraw() const;
+
+		protected:
+			struct DistanceConstraint {
+				int		a;
+				int		b;
+				float	restLength;
+				float	compliance;
+			};
+
+			struct BendingConstraint {
+				int		a;
+				int		b;
+				int		c;
+				float	restHeight;
+				float	compliance;
+			};
+
+			struct VolumeConstraint {
+				int		p[4];
+				float	restVolume;
+				float	compliance;
+			};
+
+			struct Attachment {
+				int					particle;
+				const Transform*	transform;
+				Vector3				offset;
+			};
+
+			struct Binding {
+				GameObject*	object;
+				int			particle;
+			};
+
+			void Substep(float dt, const Vector3& gravity);
+
+			void SolveDistanceConstraints(float dt);
+			void SolveBendingConstraints(float dt);
+			void SolveVolumeConstraints(float dt);
+
+			float TetrahedronVolume(int a, int b, int c, int d) const;
+
+			std::vector<PaddedVector3>	positions;
+			std::vector<PaddedVector3>	previousPositions;
+			std::vector<PaddedVector3>	velocities;
+			std::vector<float>			inverseMasses;
+
+			std::vector<DistanceConstraint>	distanceConstraints;
+			std::vector<BendingConstraint>	bendingConstraints;
+			std::vector<VolumeConstraint>	volumeConstraints;
+
+			std::vector<Attachment>	attachments;
+			std::vector<Binding>	bindings;
+
+			int		substeps;
+			float	damping;
+		};
+	}
+}
\ No newline at end of file
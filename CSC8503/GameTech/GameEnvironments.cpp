@@ -0,0 +1,135 @@
+#include "GameEnvironments.h"
+#include "../../Common/FrameArena.h"
+#include "../../Common/JobSystem.h"
+#include "../../Common/Profiler.h"
+#include <algorithm>
+
+using namespace NCL;
+using namespace CSC8503;
+
+namespace {
+	//The ball, the timer and score, and the AI, before the coins
+	const int gameObservationSize = 15;
+}
+
+/*
+Physics is stepped at a fixed rate in every game, as the adaptive timestep
+depends on how long each step takes, which would make games given the same
+actions drift apart.
+*/
+GameEnvironments::GameEnvironments(int count, bool gm1) {
+	environments.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		environments.emplace_back(new Environment());
+		Environment& e = *environments.back();
+		Debug::ContextScope debug(e.debug);
+		e.game.reset(new TutorialGame(gm1, true));
+		e.game->GetPhysics()->UseAdaptiveTimestep(false);
+		if (i == 0) {
+			e.game->CaptureLevel(level);
+		}
+		e.game->SetLevel(&level);
+	}
+	rewards.resize(count);
+	finishStates.resize(count);
+	Reset();
+}
+
+//The games' renderers are gone, so the debug drawing can't be left pointing at the last one
+GameEnvironments::~GameEnvironments() {
+	environments.clear();
+	Debug::SetRenderer(nullptr);
+}
+
+void GameEnvironments::Reset() {
+	for (auto& e : environments) {
+		Debug::ContextScope debug(e->debug);
+		Restart(*e);
+	}
+	coinCount		= environments.empty() ? 0 : (int)environments[0]->coins.size();
+	observationSize	= gameObservationSize + coinCount * 4;
+	observations.resize(environments.size() * observationSize);
+	for (int i = 0; i < GetCount(); ++i) {
+		rewards[i]		= 0.0f;
+		finishStates[i]	= FinishState::_NULL;
+		Observe(i);
+	}
+}
+
+void GameEnvironments::Restart(Environment& e) {
+	e.game->Restart();
+	e.coins = e.game->GetCoins();
+}
+
+/*
+Each game only ever touches its own world, so the games can be stepped in
+any order, on any thread. The frame arena can only be moved on with no jobs
+running, so the games are stepped in lockstep, with it moved on after each.
+*/
+void GameEnvironments::Step(const float* actions) {
+	NCL_PROFILE_SCOPE("GameEnvironments::Step");
+	JobSystem::ParallelFor(0, GetCount(), 1,
+		[this, actions](int start, int end) {
+			for (int i = start; i < end; ++i) {
+				StepEnvironment(i, actions + i * ActionSize);
+			}
+		}
+	);
+	FrameArena::EndFrame();
+	for (FinishState s : finishStates) {
+		if (s != FinishState::_NULL) {
+			episodeCount++;
+		}
+	}
+}
+
+//Anything drawn is aged out with the game's own context, rather than left to pile up
+void GameEnvironments::StepEnvironment(int i, const float* actions) {
+	Environment& e = *environments[i];
+	TutorialGame& game = *e.game;
+	Debug::ContextScope debug(e.debug);
+
+	GameActions a;
+	a.ballPush		= Vector2(std::min(std::max(actions[0], -1.0f), 1.0f), std::min(std::max(actions[1], -1.0f), 1.0f));
+	a.fireSprings	= actions[2] > 0.5f;
+
+	float oldScore = game.GetScore();
+	game.StepSimulation(stepTime, a);
+	Debug::FlushRenderables(stepTime);
+
+	rewards[i]		= game.GetScore() - oldScore;
+	finishStates[i]	= game.IsFinished() ? game.fState : FinishState::_NULL;
+	if (game.IsFinished()) {
+		Restart(e);
+	}
+	Observe(i);
+}
+
+void GameEnvironments::Observe(int i) {
+	const Environment& e = *environments[i];
+	const TutorialGame& game = *e.game;
+	float* out = observations.data() + (size_t)i * observationSize;
+
+	auto write = [&out](const Vector3& v) {
+		*out++ = v.x;
+		*out++ = v.y;
+		*out++ = v.z;
+	};
+	GameObject* ball = game.GetBall();
+	write(ball ? ball->GetTransform().GetPosition() : Vector3());
+	write(ball && ball->GetPhysicsObject() ? ball->GetPhysicsObject()->GetLinearVelocity() : Vector3());
+	*out++ = game.GetTimer();
+	*out++ = game.GetScore();
+
+	StateAIObject* ai = game.GetStateAI();
+	write(ai ? ai->GetTransform().GetPosition() : Vector3());
+	write(ai && ai->GetPhysicsObject() ? ai->GetPhysicsObject()->GetLinearVelocity() : Vector3());
+	*out++ = ai ? (float)ai->GetStateIndex() : -1.0f;
+
+	const std::vector<GameObjectHandle>& left = game.GetCoins();
+	for (int c = 0; c < coinCount; ++c) {
+		GameObject* coin = c < (int)e.coins.size() ? game.GetWorld()->GetGameObject(e.coins[c]) : nullptr;
+		write(coin ? coin->GetTransform().GetPosition() : Vector3());
+		*out++ = coin && std::find(left.begin(), left.end(), e.coins[c]) != left.end() ? 1.0f : 0.0f;
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "TutorialGame.h"
+#include "../CSC8503Common/Debug.h"
+#include <memory>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		A batch of headless games, all on the same level, stepped together for
+		training agents. Each step takes every game's actions from one flat
+		array, and writes what every game looks like into one contiguous
+		array of floats, so the whole batch can go to and from a learner in a
+		single copy rather than a game at a time.
+
+		Each game's actions are ActionSize floats:
+			ball push x, ball push z (each -1 to 1), fire springs (> 0.5 to fire)
+		The ball can only be pushed in game mode 2, as with the arrow keys.
+
+		Each game's observation is GetObservationSize() floats:
+			ball position (3), ball velocity (3), timer, score,
+			AI position (3), AI velocity (3), AI state (-1 with no AI),
+			then for each coin the level starts with: position (3), and 1 if it
+			is still to be collected, or 0 if it has been
+
+		Every game is built from the same level, captured once from the first
+		game, so they all start the same. A game that's won or lost is started
+		again straight away - its reward and finish state are for the step
+		that finished it, but its observation is of the new game.
+		*/
+		class GameEnvironments {
+		public:
+			static const int ActionSize = 3;
+
+			GameEnvironments(int count, bool gm1);
+			~GameEnvironments();
+
+			//Starts every game again
+			void Reset();
+
+			//Steps every game once with its actions, each as its own job
+			void Step(const float* actions);
+
+			void SetStepTime(float dt) {
+				stepTime = dt;
+			}
+
+			int GetCount() const {
+				return (int)environments.size();
+			}
+
+			int GetObservationSize() const {
+				return observationSize;
+			}
+
+			//Every game's observation, one after the other
+			const float* GetObservations() const {
+				return observations.data();
+			}
+
+			//How much each game's score went up by in the last step
+			const float* GetRewards() const {
+				return rewards.data();
+			}
+
+			//How each game's last step ended it, or _NULL if it's still going
+			const FinishState* GetFinishStates() const {
+				return finishStates.data();
+			}
+
+			//How many games have been won or lost, across every environment
+			int GetEpisodeCount() const {
+				return episodeCount;
+			}
+
+			TutorialGame& GetGame(int i) {
+				return *environments[i]->game;
+			}
+
+		protected:
+			GameEnvironments(const GameEnvironments&) = delete;
+			GameEnvironments& operator=(const GameEnvironments&) = delete;
+
+			struct Environment {
+				std::unique_ptr<TutorialGame>	game;
+				Debug::Context					debug;
+				std::vector<GameObjectHandle>	coins;	//Every coin the game started with
+			};
+
+			void Restart(Environment& e);
+			void StepEnvironment(int i, const float* actions);
+			void Observe(int i);
+
+			std::vector<std::unique_ptr<Environment>> environments;
+			LevelFile		level;
+			float			stepTime		= 1.0f / 60.0f;
+			int				coinCount		= 0;
+			int				observationSize	= 0;
+			int				episodeCount	= 0;
+
+			std::vector<float>			observations;
+			std::vector<float>			rewards;
+			std::vector<FinishState>	finishStates;
+		};
+	}
+}
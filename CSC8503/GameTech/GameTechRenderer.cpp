@@ -4,6 +4,7 @@
 #include "../../Common/Vector2.h"
 #include "../../Common/Vector3.h"
 #include "../../Common/TextureLoader.h"
+#include "../../Common/Profiler.h"
 using namespace NCL;
 using namespace Rendering;
 using namespace CSC8503;
@@ -98,8 +99,10 @@ void GameTechRenderer::LoadSkybox() {
 }
 
 void GameTechRenderer::RenderFrame() {
+	NCL_PROFILE_SCOPE("GameTechRenderer::RenderFrame");
 	glEnable(GL_CULL_FACE);
 	glClearColor(1, 1, 1, 1);
+	gameWorld.UpdateTransforms();
 	BuildObjectList();
 	SortObjectList();
 	RenderShadowMap();
@@ -109,25 +112,37 @@ void GameTechRenderer::RenderFrame() {
 }
 
 void GameTechRenderer::BuildObjectList() {
-	activeObjects.clear();
-
-	gameWorld.OperateOnContents(
-		[&](GameObject* o) {
-			if (o->IsActive()) {
-				const RenderObject* g = o->GetRenderObject();
-				if (g) {
-					activeObjects.emplace_back(g);
-				}
-			}
+	NCL_PROFILE_SCOPE("GameTechRenderer::BuildObjectList");
+	ObjectList& list = objectList.Get();
+	list.objects.clear();	//In case the frame gets rendered more than once
+	list.modelMatrices.clear();
+
+	//Usually about as many as last frame, so start off with room for them
+	list.objects.reserve(lastObjectCount);
+	list.modelMatrices.reserve(lastObjectCount);
+
+	//Only the objects with something to draw, straight from the world's packed store
+	const ComponentStore<RenderObject>& renderObjects = gameWorld.GetRenderObjects();
+	for (size_t i = 0; i < renderObjects.Size(); ++i) {
+		if (renderObjects.GetOwner(i)->IsActive()) {
+			const RenderObject* g = &renderObjects[i];
+			list.objects.emplace_back(g);
+			list.modelMatrices.emplace_back(g->GetTransform()->GetMatrix());
 		}
-	);
+	}
+	list.objectMatrices.resize(list.modelMatrices.size());
+	lastObjectCount = list.objects.size();
 }
 
 void GameTechRenderer::SortObjectList() {
+	NCL_PROFILE_SCOPE("GameTechRenderer::SortObjectList");
 	//Who cares!
 }
 
 void GameTechRenderer::RenderShadowMap() {
+	NCL_PROFILE_SCOPE("GameTechRenderer::RenderShadowMap");
+	ObjectList& list = objectList.Get();
+
 	glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO);
 	glClear(GL_DEPTH_BUFFER_BIT);
 	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
@@ -145,11 +160,12 @@ void GameTechRenderer::RenderShadowMap() {
 
 	shadowMatrix = biasMatrix * mvMatrix; //we'll use this one later on
 
-	for (const auto&i : activeObjects) {
+	SIMD::MultiplyMatrices(mvMatrix, list.modelMatrices.data(), list.objectMatrices.data(), list.modelMatrices.size());
+
+	for (size_t index = 0; index < list.objects.size(); ++index) {
+		const RenderObject* i = list.objects[index];
 		if (i) {
-			Matrix4 modelMatrix = (*i).GetTransform()->GetMatrix();
-			Matrix4 mvpMatrix = mvMatrix * modelMatrix;
-			glUniformMatrix4fv(mvpLocation, 1, false, (float*)&mvpMatrix);
+			glUniformMatrix4fv(mvpLocation, 1, false, (float*)&list.objectMatrices[index]);
 			BindMesh((*i).GetMesh());
 			int layerCount = (*i).GetMesh()->GetSubMeshCount();
 			for (int i = 0; i < layerCount; ++i) {
@@ -166,6 +182,7 @@ void GameTechRenderer::RenderShadowMap() {
 }
 
 void GameTechRenderer::RenderSkybox() {
+	NCL_PROFILE_SCOPE("GameTechRenderer::RenderSkybox");
 	glDisable(GL_CULL_FACE);
 	glDisable(GL_BLEND);
 	glDisable(GL_DEPTH_TEST);
@@ -196,6 +213,9 @@ void GameTechRenderer::RenderSkybox() {
 }
 
 void GameTechRenderer::RenderCamera() {
+	NCL_PROFILE_SCOPE("GameTechRenderer::RenderCamera");
+	ObjectList& list = objectList.Get();
+
 	float screenAspect = (float)currentWidth / (float)currentHeight;
 	Matrix4 viewMatrix = gameWorld.GetMainCamera()->BuildViewMatrix();
 	Matrix4 projMatrix = gameWorld.GetMainCamera()->BuildProjectionMatrix(screenAspect);
@@ -218,7 +238,10 @@ void GameTechRenderer::RenderCamera() {
 	glActiveTexture(GL_TEXTURE0 + 1);
 	glBindTexture(GL_TEXTURE_2D, shadowTex);
 
-	for (const auto&i : activeObjects) {
+	SIMD::MultiplyMatrices(shadowMatrix, list.modelMatrices.data(), list.objectMatrices.data(), list.modelMatrices.size());
+
+	for (size_t index = 0; index < list.objects.size(); ++index) {
+		const RenderObject* i = list.objects[index];
 		OGLShader* shader = (OGLShader*)(*i).GetShader();
 		BindShader(shader);
 
@@ -253,11 +276,8 @@ void GameTechRenderer::RenderCamera() {
 			activeShader = shader;
 		}
 
-		Matrix4 modelMatrix = (*i).GetTransform()->GetMatrix();
-		glUniformMatrix4fv(modelLocation, 1, false, (float*)&modelMatrix);			
-		
-		Matrix4 fullShadowMat = shadowMatrix * modelMatrix;
-		glUniformMatrix4fv(shadowLocation, 1, false, (float*)&fullShadowMat);
+		glUniformMatrix4fv(modelLocation, 1, false, (float*)&list.modelMatrices[index]);
+		glUniformMatrix4fv(shadowLocation, 1, false, (float*)&list.objectMatrices[index]);
 
 		glUniform4fv(colourLocation, 1, (float*)&i->GetColour());
 
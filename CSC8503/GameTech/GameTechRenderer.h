@@ -5,6 +5,7 @@
 #include "../../Plugins/OpenGLRendering/OGLMesh.h"
 
 #include "../CSC8503Common/GameWorld.h"
+#include "../../Common/SIMDKernels.h"
 
 namespace NCL {
 	class Maths::Vector3;
@@ -35,7 +36,14 @@ namespace NCL {
 
 			void LoadSkybox();
 
-			vector<const RenderObject*> activeObjects;
+			//What's being drawn this frame - BuildObjectList fills it in the frame arena
+			struct ObjectList {
+				FrameVector<const RenderObject*>	objects;
+				FrameVector<Matrix4>				modelMatrices;	//one per active object
+				FrameVector<Matrix4>				objectMatrices;	//model matrices with the current pass's matrix applied
+			};
+			FrameLocal<ObjectList>	objectList;
+			size_t					lastObjectCount = 0;
 
 			OGLShader*  skyboxShader;
 			OGLMesh*	skyboxMesh;
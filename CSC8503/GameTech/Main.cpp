@@ -10,12 +10,27 @@
 #include "../CSC8503Common/PushdownMachine.h"
 
 #include "TutorialGame.h"
+#include "GameEnvironments.h"
 #include "Menu.h"
+#include "../../Common/NullWindow.h"
+#include "../../Common/InputRecording.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
 
 using namespace NCL;
 using namespace CSC8503;
 
 vector <Vector3 > testNodes;
+
+//Set with -record, every game started from the menu is recorded into it
+InputRecording* inputRecording = nullptr;
 void TestPathfinding() {
 	NavigationGrid grid("TestGrid1.txt");
 
@@ -174,7 +189,18 @@ public:
 class GameScreen : public PushdownState {
 public:
 	GameScreen(bool gm1) { 
+		if (inputRecording) {
+			//Only the last game played is kept, and it starts from the same seed a replay will
+			inputRecording->Clear();
+			inputRecording->SetOptions(gm1 ? 1 : 2);
+			srand(inputRecording->GetSeed());
+		}
 		g = new TutorialGame(gm1);
+		g->SetInputRecording(inputRecording);
+		if (inputRecording) {
+			//The adaptive timestep goes by how long each step took, which a replay would never match
+			g->GetPhysics()->UseAdaptiveTimestep(false);
+		}
 	}
 	//~GameScreen() { delete g; };
 	PushdownResult OnUpdate(float dt, PushdownState** newState) override {
@@ -264,6 +290,160 @@ void TestPushdownAutomata(Window* w) {
 	}
 }
 
+/*
+Runs the game with no window or graphics for a set number of frames, with a
+fixed timestep, then reports what would have been drawn and how long it all
+took. Useful for profiling the game code on its own, or on a machine with no
+GPU at all.
+*/
+int RunHeadless(int frames, bool gm1) {
+	NullWindow* w = NullWindow::CreateNullWindow(1280, 720);
+	w->SetFrameLimit(frames);
+
+	TutorialGame* g = new TutorialGame(gm1, true);
+	NullRenderer* r = (NullRenderer*)g->GetRenderer();
+
+	auto start = std::chrono::high_resolution_clock::now();
+	while (w->UpdateWindow()) {
+		g->UpdateGame(w->GetTimer()->GetTimeDeltaSeconds());
+	}
+	std::chrono::duration<double, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+
+	const int ran = std::max(1, r->GetFrameCount());
+	std::cout << "Headless run: " << r->GetFrameCount() << " frames in " << time.count() << "ms ("
+		<< time.count() / ran << "ms per frame)" << std::endl;
+	std::cout << "Objects drawn: " << r->GetObjectCount() << " (" << r->GetFrameObjectCount() << " in the last frame)" << std::endl;
+	std::cout << "Strings drawn: " << r->GetStringCount() << ", lines drawn: " << r->GetLineCount() << std::endl;
+
+	delete g;
+	Window::DestroyGameWindow();
+	return 0;
+}
+
+/*
+Steps a batch of headless games together, as an agent being trained would,
+with random actions, and reports how many game steps a second the batch
+gets through - the same as RunHeadless, but for GameEnvironments.
+*/
+int RunEnvironments(int count, int steps, bool gm1) {
+	NullWindow::CreateNullWindow(1280, 720);
+	srand(0);
+
+	GameEnvironments* envs = new GameEnvironments(count, gm1);
+	std::vector<float> actions(count * GameEnvironments::ActionSize);
+	int won		= 0;
+	int lost	= 0;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int s = 0; s < steps; ++s) {
+		for (float& a : actions) {
+			a = (rand() / (float)RAND_MAX) * 2.0f - 1.0f;
+		}
+		envs->Step(actions.data());
+		for (int i = 0; i < count; ++i) {
+			won		+= envs->GetFinishStates()[i] == FinishState::_WIN;
+			lost	+= envs->GetFinishStates()[i] == FinishState::_LOSE;
+		}
+	}
+	std::chrono::duration<double, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+
+	std::cout << "Environments: " << count << " games, " << steps << " steps in " << time.count() << "ms ("
+		<< (count * (double)steps) / std::max(time.count() / 1000.0, 1e-9) << " game steps per second)" << std::endl;
+	std::cout << "Observation size: " << envs->GetObservationSize() << " floats, games won: " << won << ", lost: " << lost << std::endl;
+
+	delete envs;
+	Window::DestroyGameWindow();
+	return 0;
+}
+
+/*
+Plays a recording made with -record back through the same UpdateGame as the
+real game, with no window or graphics, and times every frame - so a heavy
+session can be captured once and replayed against every build to see if
+it's got any slower. Physics is stepped at a fixed rate, as it was when the
+game was recorded, so the game ends up in exactly the same state every time,
+and the physics hash printed at the end should never change for a recording.
+*/
+int RunReplay(const std::string& filename, const std::string& timingsFile) {
+	InputRecording recording;
+	if (!recording.Load(filename)) {
+		std::cout << "Couldn't load recording " << filename << std::endl;
+		return -1;
+	}
+	NullWindow* w = NullWindow::CreateNullWindow(1280, 720);
+	w->PlayRecording(&recording);
+
+	srand(recording.GetSeed());
+	TutorialGame* g = new TutorialGame(recording.GetOptions() != 2, true);
+	g->GetPhysics()->UseAdaptiveTimestep(false);
+
+	std::ofstream timings;
+	if (!timingsFile.empty()) {
+		timings.open(timingsFile);
+		timings << "frame,dt,update_ms,physics_ms\n";
+	}
+	std::vector<double> frameTimes;
+	frameTimes.reserve(recording.GetFrameCount());
+
+	while (w->UpdateWindow()) {
+		float dt = w->GetTimer()->GetTimeDeltaSeconds();
+		auto start = std::chrono::high_resolution_clock::now();
+		g->UpdateGame(dt);
+		std::chrono::duration<double, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+
+		if (timings.is_open()) {
+			timings << frameTimes.size() << "," << dt << "," << time.count() << ","
+				<< g->GetPhysics()->GetTimings().total * 1000.0f << "\n";
+		}
+		frameTimes.emplace_back(time.count());
+	}
+	unsigned long long hash = g->GetPhysics()->GetStateHash();
+
+	delete g;
+	Window::DestroyGameWindow();
+
+	if (frameTimes.empty()) {
+		std::cout << "Recording " << filename << " has no frames" << std::endl;
+		return -1;
+	}
+	double total = 0.0;
+	for (double t : frameTimes) {
+		total += t;
+	}
+	std::sort(frameTimes.begin(), frameTimes.end());
+	auto percentile = [&](double p) {
+		return frameTimes[std::min(frameTimes.size() - 1, (size_t)(p * frameTimes.size()))];
+	};
+	std::cout << "Replay of " << filename << ": " << frameTimes.size() << " frames in " << total << "ms" << std::endl;
+	std::cout << "Frame time: " << total / frameTimes.size() << "ms mean, " << percentile(0.5) << "ms median, "
+		<< percentile(0.95) << "ms 95th, " << percentile(0.99) << "ms 99th, " << frameTimes.back() << "ms worst" << std::endl;
+	std::cout << "Final physics hash: " << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec << std::endl;
+	return 0;
+}
+
+/*
+Saves both game modes' levels, as built by TutorialGame's Init functions,
+for the game to load instead of building them. Needs a window, as the
+meshes have to be loaded to save which objects use which.
+*/
+int ExportLevels() {
+	int failed = 0;
+	for (int i = 0; i < 2; ++i) {
+		TutorialGame* g = new TutorialGame(i == 0);
+		std::string file = TutorialGame::GetLevelFilename(g->gMode);
+		if (g->ExportLevel(file)) {
+			std::cout << "Saved " << file << std::endl;
+		}
+		else {
+			std::cout << "Couldn't save " << file << std::endl;
+			failed++;
+		}
+		delete g;
+	}
+	Window::DestroyGameWindow();
+	return failed == 0 ? 0 : -1;
+}
+
 /*
 
 The main function should look pretty familar to you!
@@ -276,7 +456,51 @@ This time, we've added some extra functionality to the window class - we can
 hide or show the 
 
 */
-int main() {
+int main(int argc, char** argv) {
+	//-headless [frames] [-gm2] runs the game with no window, see RunHeadless
+	//-envs count [steps] [-gm2] steps a batch of games together, see RunEnvironments
+	//-replay file [-timings file.csv] plays back a recording, see RunReplay
+	//-record file records the last game played
+	//-exportlevels saves the levels the game loads, see ExportLevels
+	std::string recordFile;
+	bool exportLevels = false;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "-replay") == 0 && i + 1 < argc) {
+			std::string timingsFile;
+			for (int j = 1; j + 1 < argc; ++j) {
+				if (strcmp(argv[j], "-timings") == 0) {
+					timingsFile = argv[j + 1];
+				}
+			}
+			return RunReplay(argv[i + 1], timingsFile);
+		}
+		if (strcmp(argv[i], "-record") == 0 && i + 1 < argc) {
+			recordFile = argv[i + 1];
+		}
+		if (strcmp(argv[i], "-exportlevels") == 0) {
+			exportLevels = true;
+		}
+		if (strcmp(argv[i], "-headless") == 0) {
+			int frames = (i + 1 < argc && isdigit(argv[i + 1][0])) ? atoi(argv[i + 1]) : 1000;
+			bool gm1 = true;
+			for (int j = 1; j < argc; ++j) {
+				if (strcmp(argv[j], "-gm2") == 0) {
+					gm1 = false;
+				}
+			}
+			return RunHeadless(frames, gm1);
+		}
+		if (strcmp(argv[i], "-envs") == 0 && i + 1 < argc) {
+			int steps = (i + 2 < argc && isdigit(argv[i + 2][0])) ? atoi(argv[i + 2]) : 1000;
+			bool gm1 = true;
+			for (int j = 1; j < argc; ++j) {
+				if (strcmp(argv[j], "-gm2") == 0) {
+					gm1 = false;
+				}
+			}
+			return RunEnvironments(std::max(1, atoi(argv[i + 1])), steps, gm1);
+		}
+	}
 	//TestPathfinding();
 	//TestBehaviourTree();
 	Window*w = Window::CreateGameWindow("CSC8503 Game technology!", 1280, 720);
@@ -284,12 +508,29 @@ int main() {
 	if (!w->HasInitialised()) {
 		return -1;
 	}	
+	if (exportLevels) {
+		return ExportLevels();
+	}
 	
 	srand(time(0));
 	/*w->ShowOSPointer(true);
 	w->LockMouseToWindow(true);*/
+	InputRecording recording;
+	if (!recordFile.empty()) {
+		recording.SetSeed((uint32_t)time(0));
+		inputRecording = &recording;
+	}
 	TestPushdownAutomata(w);
 
+	if (inputRecording) {
+		if (recording.Save(recordFile)) {
+			std::cout << "Recorded " << recording.GetFrameCount() << " frames (" << recording.GetByteSize() << " bytes) to " << recordFile << std::endl;
+		}
+		else {
+			std::cout << "Couldn't write recording " << recordFile << std::endl;
+		}
+		inputRecording = nullptr;
+	}
 	Window::DestroyGameWindow();
 }
 
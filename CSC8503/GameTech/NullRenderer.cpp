@@ -0,0 +1,59 @@
+#include "NullRenderer.h"
+#include "../CSC8503Common/GameObject.h"
+#include "../../Common/Profiler.h"
+
+using namespace NCL;
+using namespace CSC8503;
+
+NullRenderer::NullRenderer(GameWorld& world) : RendererBase(*Window::GetWindow()), gameWorld(world) {
+	ResetCounts();
+}
+
+NullRenderer::~NullRenderer() {
+}
+
+void NullRenderer::ResetCounts() {
+	frameCount		= 0;
+	objectCount		= 0;
+	stringCount		= 0;
+	lineCount		= 0;
+	frameObjects	= 0;
+}
+
+void NullRenderer::OnWindowResize(int w, int h) {
+	currentWidth	= w;
+	currentHeight	= h;
+}
+
+void NullRenderer::BeginFrame() {
+	frameObjects = 0;
+}
+
+//Does the same CPU side work GameTechRenderer does to find what to draw
+void NullRenderer::RenderFrame() {
+	NCL_PROFILE_SCOPE("NullRenderer::RenderFrame");
+	gameWorld.UpdateTransforms();
+
+	const ComponentStore<RenderObject>& renderObjects = gameWorld.GetRenderObjects();
+	for (size_t i = 0; i < renderObjects.Size(); ++i) {
+		if (renderObjects.GetOwner(i)->IsActive()) {
+			frameObjects++;
+		}
+	}
+	objectCount += frameObjects;
+}
+
+void NullRenderer::EndFrame() {
+}
+
+void NullRenderer::SwapBuffers() {
+	frameCount++;
+}
+
+void NullRenderer::AddDebugString(const FrameString& text, const Vector2& pos, const Vector4& colour, float size) {
+	stringCount++;
+}
+
+void NullRenderer::DrawLine(const Vector3& start, const Vector3& end, const Vector4& colour) {
+	lineCount++;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "../../Common/RendererBase.h"
+#include "../CSC8503Common/GameWorld.h"
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Stands in for GameTechRenderer when there's nothing to draw to. It goes
+		through the same steps each frame, and counts what would have been
+		drawn, but never touches a graphics API, so the whole game can be run
+		headless - on a server, or to time everything but the rendering.
+		*/
+		class NullRenderer : public RendererBase {
+		public:
+			NullRenderer(GameWorld& world);
+			~NullRenderer();
+
+			void DrawLine(const Vector3& start, const Vector3& end, const Vector4& colour) override;
+
+			//All totals since the renderer was made (or ResetCounts)
+			int GetFrameCount()		const { return frameCount; }
+			int GetObjectCount()	const { return objectCount; }
+			int GetStringCount()	const { return stringCount; }
+			int GetLineCount()		const { return lineCount; }
+
+			//How many objects the last frame would have drawn
+			int GetFrameObjectCount() const { return frameObjects; }
+
+			void ResetCounts();
+
+		protected:
+			void OnWindowResize(int w, int h)	override;
+			void BeginFrame()	override;
+			void RenderFrame()	override;
+			void EndFrame()		override;
+			void SwapBuffers()	override;
+
+			void AddDebugString(const FrameString& text, const Vector2& pos, const Vector4& colour, float size) override;
+
+			GameWorld&	gameWorld;
+
+			int frameCount;
+			int objectCount;
+			int stringCount;
+			int lineCount;
+			int frameObjects;
+		};
+	}
+}
@@ -4,14 +4,31 @@
 #include "../../Plugins/OpenGLRendering/OGLShader.h"
 #include "../../Plugins/OpenGLRendering/OGLTexture.h"
 #include "../../Common/TextureLoader.h"
+#include "../../Common/JobSystem.h"
+#include "../../Common/Profiler.h"
+#include "../../Common/Assets.h"
 #include "..//CSC8503Common/PositionConstraint.h"
 
 using namespace NCL;
 using namespace CSC8503;
 
-TutorialGame::TutorialGame(bool gm1)	{
+namespace {
+	//What the level files call the objects that aren't plain GameObjects
+	const uint8_t pushBlockClass	= 1;
+	const uint8_t stateAIClass		= 2;
+
+	//How hard the arrow keys push the ball
+	const float ballPushForce = 10.0f;
+}
+
+TutorialGame::TutorialGame(bool gm1, bool headless)	{
 	world		= new GameWorld();
-	renderer	= new GameTechRenderer(*world);
+	if (headless) {
+		renderer = new NullRenderer(*world);
+	}
+	else {
+		renderer = new GameTechRenderer(*world);
+	}
 	physics		= new PhysicsSystem(*world);
 
 	forceMagnitude	= 10.0f;
@@ -19,10 +36,13 @@ TutorialGame::TutorialGame(bool gm1)	{
 	inSelectionMode = true;
 	debugMenu		= false;
 	debugObject		= false;
+	showProfile		= false;
+	writeProfile	= false;
 	finished		= false;
 	timer			= 100.0f;
 	score			= 0;
 	fState			= FinishState::_NULL;
+	this->headless	= headless;
 	gMode			= (gm1) ? Gamemode::_GM1 : Gamemode::_GM2;
 
 	
@@ -67,6 +87,12 @@ for this module, even in the coursework, but you can add it if you like!
 
 */
 void TutorialGame::InitialiseAssets() {
+	if (headless) {
+		//Everything is made with null meshes, which nothing but GameTechRenderer looks at
+		InitCamera();
+		InitWorld();
+		return;
+	}
 	auto loadFunc = [](const string& name, OGLMesh** into) {
 		*into = new OGLMesh(name);
 		(*into)->SetPrimitiveType(GeometryPrimitive::Triangles);
@@ -105,17 +131,11 @@ TutorialGame::~TutorialGame()	{
 }
 
 void TutorialGame::UpdateGame(float dt) {
-	if (finished) {
-		world->ClearForces();
-		for (auto i : world->GetGameObjects()) {
-			i->GetPhysicsObject()->SetLinearVelocity(Vector3(0, 0, 0));
-			i->GetPhysicsObject()->SetAngularVelocity(Vector3(0, 0, 0));
-		}
-		useGravity = false;
-	}
-	else {
-		UpdateTimer(dt);
+	NCL_PROFILE_SCOPE("TutorialGame::UpdateGame");
+	if (recording) {
+		recording->RecordFrame(dt, *Window::GetKeyboard(), *Window::GetMouse());
 	}
+	BeginStep(dt);
 
 	if (!inSelectionMode) {
 		world->GetMainCamera()->UpdateCamera(dt);
@@ -133,29 +153,20 @@ void TutorialGame::UpdateGame(float dt) {
 	SelectObject(dt);
 	MoveSelectedObject();
 	physics->Update(dt);
+	world->UpdateHierarchy();
 
 	if (lockedObject != nullptr) {
-		Vector3 objPos = lockedObject->GetTransform().GetPosition();
-		Vector3 camPos = objPos + lockedOffset;
-
-		Matrix4 temp = Matrix4::BuildViewMatrix(camPos, objPos, Vector3(0,1,0));
+		//The rig has already been moved along with the object
+		Vector3 angles = cameraRig.GetOrientation().ToEuler();
 
-		Matrix4 modelMat = temp.Inverse();
-
-		Quaternion q(modelMat);
-		Vector3 angles = q.ToEuler(); //nearly there now!
-
-		world->GetMainCamera()->SetPosition(camPos);
+		world->GetMainCamera()->SetPosition(cameraRig.GetPosition());
 		world->GetMainCamera()->SetPitch(angles.x);
 		world->GetMainCamera()->SetYaw(angles.y);
 
 		//Debug::DrawAxisLines(lockedObject->GetTransform().GetMatrix(), 2.0f);
 	}
 
-	if (testStateObject) {
-		testStateObject->targetPos = ball->GetTransform().GetPosition();
-		testStateObject->Update(dt);
-	}
+	UpdateAI(dt);
 
 	if (debugMenu)
 		DebugMenu();
@@ -163,34 +174,110 @@ void TutorialGame::UpdateGame(float dt) {
 	if (debugObject)
 		DebugObject();
 
+	if (showProfile)
+		Debug::PrintProfile(Vector2(50, 5));
+
 	if (gMode == Gamemode::_GM2) {
 		MoveBall();
-		if (coins.empty()) {
-			finished = true;
-			fState = (score > 0) ? FinishState::_WIN : FinishState::_LOSE;
+	}
+	EndStep(dt);
+
+	renderer->Update(dt);
+
+	Debug::FlushRenderables(dt);
+	renderer->Render();
+
+}
+
+/*
+One frame of the game with no window - the same steps as UpdateGame, in the
+same order, but with the ball pushed and the springs fired by actions rather
+than the keyboard, and nothing drawn. The camera, the debug menus and
+picking objects are left out, as they only matter to someone watching.
+*/
+void TutorialGame::StepSimulation(float dt, const GameActions& actions) {
+	NCL_PROFILE_SCOPE("TutorialGame::StepSimulation");
+	BeginStep(dt);
+	if (actions.fireSprings) {
+		FireSprings(dt);
+	}
+	physics->Update(dt);
+	world->UpdateHierarchy();
+
+	UpdateAI(dt);
+
+	if (gMode == Gamemode::_GM2 && ball) {
+		ball->GetPhysicsObject()->AddForce(Vector3(actions.ballPush.x, 0, actions.ballPush.y) * ballPushForce);
+	}
+	EndStep(dt);
+}
+
+//Objects added or removed by gameplay and physics only go in or out of
+//the world's list once they're all done, in EndStep
+void TutorialGame::BeginStep(float dt) {
+	world->BeginDeferringChanges();
+	if (finished) {
+		world->ClearForces();
+		ComponentStore<PhysicsObject>& bodies = world->GetPhysicsObjects();
+		for (size_t i = 0; i < bodies.Size(); ++i) {
+			bodies[i].SetAngularVelocity(Vector3(0, 0, 0));
 		}
+		useGravity = false;
 	}
+	else {
+		UpdateTimer(dt);
+	}
+}
 
-	for (auto i : vSprings) {
-		if (i)
-			i->Update(dt);
+//The AI and the springs only ever move themselves, so they can all be
+//updated at once on the job system
+void TutorialGame::UpdateAI(float dt) {
+	JobCounter aiCounter;
+	if (testStateObject) {
+		testStateObject->targetPos = ball->GetTransform().GetPosition();
+		JobSystem::Run([this, dt]() { testStateObject->Update(dt); }, &aiCounter);
 	}
+	GameObject* const* springs = world->GetObjectsWithTag(GameObjectTag::_PUSH_BLOCK).data();
+	JobSystem::ParallelFor(0, (int)world->CountWithTag(GameObjectTag::_PUSH_BLOCK), 1,
+		[springs, dt](int start, int end) {
+			for (int i = start; i < end; ++i) {
+				static_cast<SMPushBlock*>(springs[i])->Update(dt);
+			}
+		}, &aiCounter
+	);
+	JobSystem::Wait(aiCounter);
+}
 
+void TutorialGame::EndStep(float dt) {
+	if (gMode == Gamemode::_GM2 && coins.empty()) {
+		finished = true;
+		fState = (score > 0) ? FinishState::_WIN : FinishState::_LOSE;
+	}
 	UpdateObjectState(dt);
-	
-	world->UpdateWorld(dt);
-	renderer->Update(dt);
 
-	Debug::FlushRenderables(dt);
-	renderer->Render();
+	world->EndDeferringChanges();
+	world->UpdateWorld(dt);
+}
 
+//Back to the start of the game mode, as if the game had just been made
+void TutorialGame::Restart() {
+	InitWorld();
+	selectionObject = nullptr;
+	LockCameraToObject(nullptr);
+
+	useGravity	= true;
+	physics->UseGravity(true);
+	finished	= false;
+	timer		= 100.0f;
+	score		= 0;
+	fState		= FinishState::_NULL;
 }
 
 void TutorialGame::UpdateKeys(float dt) {
 	if (Window::GetKeyboard()->KeyPressed(KeyboardKeys::F1)) {
 		InitWorld(); //We can reset the simulation at any time with F1
 		selectionObject = nullptr;
-		lockedObject	= nullptr;
+		LockCameraToObject(nullptr);
 	}
 
 	if (Window::GetKeyboard()->KeyPressed(KeyboardKeys::F2)) {
@@ -221,6 +308,18 @@ void TutorialGame::UpdateKeys(float dt) {
 	if (Window::GetKeyboard()->KeyPressed(KeyboardKeys::F3)) {
 		debugMenu = !debugMenu;
 	}
+	if (Window::GetKeyboard()->KeyPressed(KeyboardKeys::F4)) {
+		showProfile = !showProfile;
+	}
+	//Captures the next few seconds, to look at in chrome://tracing
+	if (Window::GetKeyboard()->KeyPressed(KeyboardKeys::F5) && !writeProfile) {
+		Profiler::StartCapture(300);
+		writeProfile = true;
+	}
+	if (writeProfile && !Profiler::IsCapturing()) {
+		Profiler::WriteChromeTrace("profile.json");
+		writeProfile = false;
+	}
 
 
 	if (lockedObject) {
@@ -242,12 +341,7 @@ void TutorialGame::UpdateKeys(float dt) {
 	}
 
 	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::M)) {
-		for (auto i : vSprings) {
-			if (i) {
-				i->springFired = true;
-				i->Update(dt);
-			}
-		}
+		FireSprings(dt);
 	}
 }
 
@@ -335,19 +429,19 @@ void TutorialGame::DebugObjectMovement() {
 void TutorialGame::MoveBall() {
 	//Movement
 	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::RIGHT)) {
-		ball->GetPhysicsObject()->AddForce(Vector3(10, 0, 0));
+		ball->GetPhysicsObject()->AddForce(Vector3(ballPushForce, 0, 0));
 	}
 
 	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::UP)) {
-		ball->GetPhysicsObject()->AddForce(Vector3(0, 0, -10));
+		ball->GetPhysicsObject()->AddForce(Vector3(0, 0, -ballPushForce));
 	}
 
 	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::DOWN)) {
-		ball->GetPhysicsObject()->AddForce(Vector3(0, 0, 10));
+		ball->GetPhysicsObject()->AddForce(Vector3(0, 0, ballPushForce));
 	}
 
 	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::LEFT)) {
-		ball->GetPhysicsObject()->AddForce(Vector3(-10, 0, 0));
+		ball->GetPhysicsObject()->AddForce(Vector3(-ballPushForce, 0, 0));
 	}
 }
 
@@ -357,18 +451,52 @@ void TutorialGame::InitCamera() {
 	world->GetMainCamera()->SetPitch(-90.0f);
 	world->GetMainCamera()->SetYaw(0.0f);
 	world->GetMainCamera()->SetPosition(Vector3(-0, 65, 0));
-	lockedObject = nullptr;
+	LockCameraToObject(nullptr);
 }
 
-void TutorialGame::InitWorld() {
+/*
+The camera follows the locked object by hanging a rig off it in the world's
+transform hierarchy - only its position is followed, so the camera doesn't
+spin around with the object. The view direction never changes, so it only
+needs working out once, here.
+*/
+void TutorialGame::LockCameraToObject(GameObject* o) {
+	lockedObject = o;
+	if (!o) {
+		world->GetTransformHierarchy().Detach(&cameraRig);
+		return;
+	}
+	Matrix4 temp = Matrix4::BuildViewMatrix(lockedOffset, Vector3(0, 0, 0), Vector3(0, 1, 0));
+
+	Matrix4 modelMat = temp.Inverse();
+
+	Quaternion q(modelMat);
+
+	world->GetTransformHierarchy().Attach(&cameraRig, &o->GetTransform(), lockedOffset, q, false);
+}
+
+void TutorialGame::InitWorld(bool fromLevelFile) {
 	world->ClearAndErase();
 	physics->Clear();
+	coins.clear();
+	bumpers.clear();
+	ball			= nullptr;
+	fallingLog		= nullptr;
+	testStateObject	= nullptr;
 
 	//InitMixedGridWorld(5, 5, 3.5f, 3.5f);
 	//InitGameExamples();
 	//InitDefaultFloor();
 	//BridgeConstraintTest();
+	//XPBDBridgeTest();
 	//testStateObject = AddStateObjectToWorld(Vector3(0, 10, 0));
+	if (fromLevelFile && sharedLevel) {
+		AddLevel(*sharedLevel);
+		return;
+	}
+	if (fromLevelFile && LoadLevel(GetLevelFilename(gMode))) {
+		return;
+	}
 	if (gMode == Gamemode::_GM1)
 		InitGamemode1();
 
@@ -377,6 +505,109 @@ void TutorialGame::InitWorld() {
 	//InitCollisionTest();
 }
 
+std::string TutorialGame::GetLevelFilename(Gamemode mode) {
+	return Assets::DATADIR + (mode == Gamemode::_GM1 ? "Gamemode1.level" : "Gamemode2.level");
+}
+
+/*
+Builds the world from a level saved by ExportLevel, rather than with the
+Init functions. The objects the game keeps hold of are found again by
+their names, types and tags.
+*/
+bool TutorialGame::LoadLevel(const std::string& filename) {
+	LevelFile level;
+	if (!level.Load(filename)) {
+		return false;
+	}
+	AddLevel(level);
+	return true;
+}
+
+void TutorialGame::AddLevel(const LevelFile& level) {
+	std::vector<GameObject*> added;
+	level.AddToWorld(*world, GetLevelBindings(), &added);
+
+	for (GameObject* o : added) {
+		if (o->GetName() == "ball") {
+			ball = o;
+		}
+		else if (o->GetName() == "log") {
+			fallingLog = o;
+		}
+		if (o->GetType() == GameObjectType::_AI) {
+			testStateObject = dynamic_cast<StateAIObject*>(o);
+		}
+		if (o->GetType() == GameObjectType::_COIN) {
+			coins.emplace_back(o->GetHandle());
+		}
+		if (o->HasTag(GameObjectTag::_BUMPER)) {
+			bumpers.emplace_back(o->GetHandle());
+		}
+	}
+	if (!ball) {
+		InitWorld(false); //Not a level the game can be played on
+		return;
+	}
+	if (testStateObject) {
+		testStateObject->targetPos	= ball->GetTransform().GetPosition();
+		testStateObject->coins		= coins;
+		testStateObject->bumpers	= bumpers;
+	}
+}
+
+//Headless, the meshes are all null, so this is only for loading back into another headless game
+void TutorialGame::CaptureLevel(LevelFile& level) {
+	level.Capture(*world, GetLevelBindings());
+}
+
+/*
+The meshes are looked up in the bindings to find their IDs, so this needs
+the real ones - headless, every mesh is null, and would be saved as none.
+*/
+bool TutorialGame::ExportLevel(const std::string& filename) {
+	if (headless) {
+		return false;
+	}
+	InitWorld(false);
+	LevelFile level;
+	level.Capture(*world, GetLevelBindings());
+	return level.Save(filename);
+}
+
+LevelFile::Bindings TutorialGame::GetLevelBindings() {
+	LevelFile::Bindings bindings;
+	//Level files refer to these by where they are in here, so new ones only go on the end
+	bindings.meshes		= { cubeMesh, sphereMesh, capsuleMesh, bonusMesh, charMeshA, charMeshB, enemyMesh };
+	bindings.textures	= { basicTex };
+	bindings.shaders	= { basicShader };
+
+	bindings.describe = [](const GameObject& o, LevelFile::Object& saved) {
+		if (const SMPushBlock* spring = dynamic_cast<const SMPushBlock*>(&o)) {
+			saved.objectClass	= pushBlockClass;
+			saved.classData		= Vector4(spring->GetFireForce(), spring->GetFireDistance());
+		}
+		else if (dynamic_cast<const StateAIObject*>(&o)) {
+			saved.objectClass	= stateAIClass;
+		}
+	};
+	bindings.create = [this](const LevelFile::Object& saved, const std::string& name) -> GameObject* {
+		GameObject* o = nullptr;
+		if (saved.objectClass == pushBlockClass) {
+			o = new SMPushBlock(saved.position, Vector3(saved.classData), saved.classData.w);
+		}
+		else if (saved.objectClass == stateAIClass) {
+			StateAIObject* ai = new StateAIObject();
+			ai->world = world;
+			o = ai;
+		}
+		if (o) {
+			o->SetName(name);
+		}
+		return o;
+	};
+	return bindings;
+}
+
 void TutorialGame::InitCollisionTest() {
 	float sphereRadius = 1.0f;
 	Vector3 cubeDims = Vector3(1, 1, 1);
@@ -388,7 +619,7 @@ void TutorialGame::InitCollisionTest() {
 
 	AddSphereToWorld(Vector3(-20,5,-20), sphereRadius, 1.0f);
 	//AddSphereToWorld(Vector3(-3,20,-5), sphereRadius, 1.0f);
-	vSprings.emplace_back(AddSpringBlockToWorld(Vector3(19, 2, 16), Vector3(1, 1, 2), Quaternion(0, 0, 0, 1), 1.0f, Vector3(-250, 0, 0), 3.0f));
+	AddSpringBlockToWorld(Vector3(19, 2, 16), Vector3(1, 1, 2), Quaternion(0, 0, 0, 1), 1.0f, Vector3(-250, 0, 0), 3.0f);
 }
 
 void TutorialGame::InitGamemode1(){
@@ -396,9 +627,11 @@ void TutorialGame::InitGamemode1(){
 
 	// Ball
 	ball = AddSphereToWorld(Vector3(16, 2, 16), 0.5f, 1.0f);
+	ball->SetName("ball");
 
 	// Log
 	fallingLog = AddCapsuleToWorld(Vector3(0, 20, 0), 2.0f, 0.4f, Quaternion::EulerAnglesToQuaternion(0.0f, 0.0f, 90.0f), 0.001f, GameObjectType::_LOG);
+	fallingLog->SetName("log");
 
 	// Reset Collider
 	AddCubeToWorld(Vector3(0, -5, 0), Vector3(20, 0.5, 20), Quaternion(0, 0, 0, 1), 0, GameObjectType::_RESET);
@@ -433,9 +666,9 @@ void TutorialGame::InitGamemode1(){
 	AddCubeToWorld(Vector3(-12, 2, 7), Vector3(8, 6, 1), Quaternion(0, 0, 0, 1), 0, GameObjectType::_WALL);
 
 	// Springs
-	vSprings.emplace_back(AddSpringBlockToWorld(Vector3(19, 2, 16), Vector3(1,1,2), Quaternion(0, 0, 0, 1), 1.0f, Vector3(-300, 0, 0) ,3.0f));
-	vSprings.emplace_back(AddSpringBlockToWorld(Vector3(-19, 4, 10), Vector3(1,1,2), Quaternion(0, 0, 0, 1), 1.0f, Vector3(300, 0, 0), 2.5f));
-	vSprings.emplace_back(AddSpringBlockToWorld(Vector3(15, 4, 11), Vector3(3,1,1), Quaternion(0, 0, 0, 1), 1.0f, Vector3(0, 0, -300), 2.0f));
+	AddSpringBlockToWorld(Vector3(19, 2, 16), Vector3(1,1,2), Quaternion(0, 0, 0, 1), 1.0f, Vector3(-300, 0, 0) ,3.0f);
+	AddSpringBlockToWorld(Vector3(-19, 4, 10), Vector3(1,1,2), Quaternion(0, 0, 0, 1), 1.0f, Vector3(300, 0, 0), 2.5f);
+	AddSpringBlockToWorld(Vector3(15, 4, 11), Vector3(3,1,1), Quaternion(0, 0, 0, 1), 1.0f, Vector3(0, 0, -300), 2.0f);
 
 	// Ramps
 	AddCubeToWorld(Vector3(0, 1, 16), Vector3(11, 1, 2), Quaternion::EulerAnglesToQuaternion(0.0f, 0.0f, -5.8f), 0, GameObjectType::_RAMP);
@@ -451,14 +684,15 @@ void TutorialGame::InitGamemode1(){
 	AddCubeToWorld(Vector3(-16, 2, -16), Vector3(2, 1, 2), Quaternion(0,0,0,1), 0, GameObjectType::_BUTTON_SPRING);
 
 	// Coins
-	coins.emplace_back(AddSphereToWorld(Vector3(-12, 4, 16), 1.0f, 1.0f, GameObjectType::_COIN));
-	coins.emplace_back(AddSphereToWorld(Vector3(10, 4, 9), 1.0f, 1.0f, GameObjectType::_COIN));
-	coins.emplace_back(AddSphereToWorld(Vector3(-14, 4, 9), 1.0f, 1.0f, GameObjectType::_COIN));
+	coins.emplace_back(AddSphereToWorld(Vector3(-12, 4, 16), 1.0f, 1.0f, GameObjectType::_COIN)->GetHandle());
+	coins.emplace_back(AddSphereToWorld(Vector3(10, 4, 9), 1.0f, 1.0f, GameObjectType::_COIN)->GetHandle());
+	coins.emplace_back(AddSphereToWorld(Vector3(-14, 4, 9), 1.0f, 1.0f, GameObjectType::_COIN)->GetHandle());
 }
 
 void TutorialGame::InitGamemode2() {
 	// Ball
 	ball = AddSphereToWorld(Vector3(15, 2, 15), 0.5f, 1.0f, GameObjectType::_NULL);
+	ball->SetName("ball");
 
 	// Base Floor
 	AddCubeToWorld(Vector3(0, 0, 0), Vector3(20, 1, 20), Quaternion(0, 0, 0, 1), 0, GameObjectType::_FLOOR);
@@ -470,48 +704,87 @@ void TutorialGame::InitGamemode2() {
 	AddCubeToWorld(Vector3(0, 0, -19), Vector3(20, 4, 1), Quaternion(0, 0, 0, 1), 0, GameObjectType::_WALL);
 
 	// Bumpers
-	//bumpers.emplace_back(AddSphereToWorld(Vector3(0, 0, -11), 2.0f, 0, GameObjectType::_SLIME));
-	//bumpers.emplace_back(AddSphereToWorld(Vector3(0, 0, 11), 2.0f, 0, GameObjectType::_SLIME));
-	bumpers.emplace_back(AddSphereToWorld(Vector3(11, 0, -5), 2.0f, 0, GameObjectType::_SLIME));
-	bumpers.emplace_back(AddSphereToWorld(Vector3(-11, 0, -5), 2.0f, 0, GameObjectType::_SLIME));
-	bumpers.emplace_back(AddSphereToWorld(Vector3(0, 0, 5), 2.0f, 0, GameObjectType::_SLIME));
+	//bumpers.emplace_back(AddSphereToWorld(Vector3(0, 0, -11), 2.0f, 0, GameObjectType::_SLIME)->GetHandle());
+	//bumpers.emplace_back(AddSphereToWorld(Vector3(0, 0, 11), 2.0f, 0, GameObjectType::_SLIME)->GetHandle());
+	Vector3 bumperPositions[] = { Vector3(11, 0, -5), Vector3(-11, 0, -5), Vector3(0, 0, 5) };
+	for (const Vector3& position : bumperPositions) {
+		GameObject* bumper = AddSphereToWorld(position, 2.0f, 0, GameObjectType::_SLIME);
+		bumper->AddTag(GameObjectTag::_BUMPER);
+		bumpers.emplace_back(bumper->GetHandle());
+	}
 
 	// Coins
-	coins.emplace_back(AddSphereToWorld(Vector3(0, 2, -7), 1.0f, 1.0f, GameObjectType::_COIN));
-	coins.emplace_back(AddSphereToWorld(Vector3(-5, 2, 7), 1.0f, 1.0f, GameObjectType::_COIN));
-	coins.emplace_back(AddSphereToWorld(Vector3(5, 2, 7), 1.0f, 1.0f, GameObjectType::_COIN));
-	coins.emplace_back(AddSphereToWorld(Vector3(-15, 2, -15), 1.0f, 1.0f, GameObjectType::_COIN));
-	coins.emplace_back(AddSphereToWorld(Vector3(15, 2, -15), 1.0f, 1.0f, GameObjectType::_COIN));
+	coins.emplace_back(AddSphereToWorld(Vector3(0, 2, -7), 1.0f, 1.0f, GameObjectType::_COIN)->GetHandle());
+	coins.emplace_back(AddSphereToWorld(Vector3(-5, 2, 7), 1.0f, 1.0f, GameObjectType::_COIN)->GetHandle());
+	coins.emplace_back(AddSphereToWorld(Vector3(5, 2, 7), 1.0f, 1.0f, GameObjectType::_COIN)->GetHandle());
+	coins.emplace_back(AddSphereToWorld(Vector3(-15, 2, -15), 1.0f, 1.0f, GameObjectType::_COIN)->GetHandle());
+	coins.emplace_back(AddSphereToWorld(Vector3(15, 2, -15), 1.0f, 1.0f, GameObjectType::_COIN)->GetHandle());
 
 	// Enemy
 	testStateObject = AddStateObjectToWorld(Vector3(-15, 2, 15), GameObjectType::_AI);
 	//AddEnemyToWorld(Vector3(-15, 4, -15));
 }
 
-//void TutorialGame::BridgeConstraintTest() {
-//	Vector3 cubeSize = Vector3(8, 8, 8);
-//	
-//	float invCubeMass = 5; //how heavy the middle pieces are
-//	int numLinks = 10;
-//	float maxDistance = 30; // constraint distance
-//	float cubeDistance = 20; // distance between links
-//	
-//	Vector3 startPos = Vector3(500, 500, 500);
-//	
-//	 GameObject * start = AddCubeToWorld(startPos + Vector3(0, 0, 0), cubeSize, Quaternion(0, 0, 0, 0), 0);
-//	 GameObject * end = AddCubeToWorld(startPos + Vector3((numLinks + 2)* cubeDistance, 0, 0), cubeSize, Quaternion(0, 0, 0, 0), 0);
-//	
-//	 GameObject * previous = start;
-//	
-//	 for (int i = 0; i < numLinks; ++i) {
-//	 GameObject * block = AddCubeToWorld(startPos + Vector3((i + 1) *cubeDistance, 0, 0), cubeSize, Quaternion(0, 0, 0, 0), invCubeMass);
-//	 PositionConstraint * constraint = new PositionConstraint(previous,block, maxDistance);
-//	 world->AddConstraint(constraint);
-//	 previous = block;
-//	}
-//	PositionConstraint * constraint = new PositionConstraint(previous,end, maxDistance);
-//	world->AddConstraint(constraint);
-//}
+void TutorialGame::BridgeConstraintTest() {
+	Vector3 cubeSize = Vector3(8, 8, 8);
+	
+	float invCubeMass = 5; //how heavy the middle pieces are
+	int numLinks = 10;
+	float maxDistance = 30; // constraint distance
+	float cubeDistance = 20; // distance between links
+	
+	Vector3 startPos = Vector3(500, 500, 500);
+	
+	GameObject * start = AddCubeToWorld(startPos + Vector3(0, 0, 0), cubeSize, Quaternion(0, 0, 0, 0), 0);
+	GameObject * end = AddCubeToWorld(startPos + Vector3((numLinks + 2)* cubeDistance, 0, 0), cubeSize, Quaternion(0, 0, 0, 0), 0);
+	
+	GameObject * previous = start;
+	
+	for (int i = 0; i < numLinks; ++i) {
+		GameObject * block = AddCubeToWorld(startPos + Vector3((i + 1) *cubeDistance, 0, 0), cubeSize, Quaternion(0, 0, 0, 0), invCubeMass);
+		PositionConstraint * constraint = new PositionConstraint(previous,block, maxDistance);
+		world->AddConstraint(constraint);
+		previous = block;
+	}
+	PositionConstraint * constraint = new PositionConstraint(previous,end, maxDistance);
+	world->AddConstraint(constraint);
+}
+
+/*
+
+The same bridge as above, but with the links simulated as XPBD particles.
+The cubes just follow their particles around, so they're given an inverse
+mass of 0 - other objects will still bounce off them.
+
+*/
+void TutorialGame::XPBDBridgeTest() {
+	Vector3 cubeSize = Vector3(8, 8, 8);
+
+	int numLinks = 10;
+	float cubeDistance = 20; // distance between links
+
+	Vector3 startPos = Vector3(500, 500, 500);
+
+	GameObject* start	= AddCubeToWorld(startPos + Vector3(0, 0, 0), cubeSize, Quaternion(0, 0, 0, 0), 0);
+	GameObject* end		= AddCubeToWorld(startPos + Vector3((numLinks + 1) * cubeDistance, 0, 0), cubeSize, Quaternion(0, 0, 0, 0), 0);
+
+	XPBDSystem& xpbd = physics->GetXPBDSystem();
+
+	int previous = xpbd.AddParticle(start->GetTransform().GetPosition(), 0.0f);
+	xpbd.AttachParticle(previous, &start->GetTransform());
+
+	for (int i = 0; i < numLinks; ++i) {
+		GameObject* block = AddCubeToWorld(startPos + Vector3((i + 1) * cubeDistance, 0, 0), cubeSize, Quaternion(0, 0, 0, 0), 0);
+
+		int particle = xpbd.AddParticle(block->GetTransform().GetPosition(), 0.2f);
+		xpbd.BindObject(block, particle);
+		xpbd.AddDistanceConstraint(previous, particle);
+		previous = particle;
+	}
+	int last = xpbd.AddParticle(end->GetTransform().GetPosition(), 0.0f);
+	xpbd.AttachParticle(last, &end->GetTransform());
+	xpbd.AddDistanceConstraint(previous, last);
+}
 
 /*
 
@@ -519,19 +792,17 @@ A single function to add a large immoveable cube to the bottom of our world
 
 */
 GameObject* TutorialGame::AddFloorToWorld(const Vector3& position) {
-	GameObject* floor = new GameObject();
-	std::string name = "floor";
-	floor->SetName(name);
+	GameObject* floor = world->CreateGameObject("floor");
 
 	Vector3 floorSize	= Vector3(100, 2, 100);
-	AABBVolume* volume	= new AABBVolume(floorSize);
+	AABBVolume* volume	= world->CreateAABBVolume(floorSize);
 	floor->SetBoundingVolume((CollisionVolume*)volume);
 	floor->GetTransform()
 		.SetScale(floorSize * 2)
 		.SetPosition(position);
 
-	floor->SetRenderObject(new RenderObject(&floor->GetTransform(), cubeMesh, basicTex, basicShader));
-	floor->SetPhysicsObject(new PhysicsObject(&floor->GetTransform(), floor->GetBoundingVolume()));
+	world->CreateRenderObject(floor, cubeMesh, basicTex, basicShader);
+	world->CreatePhysicsObject(floor);
 
 	floor->GetPhysicsObject()->SetInverseMass(0);
 	floor->GetPhysicsObject()->InitCubeInertia();
@@ -549,22 +820,20 @@ physics worlds. You'll probably need another function for the creation of OBB cu
 
 */
 GameObject* TutorialGame::AddSphereToWorld(const Vector3& position, float radius, float inverseMass, GameObjectType type) {
-	GameObject* sphere = new GameObject();
-	std::string name = "sphere";
-	sphere->SetName(name);
+	GameObject* sphere = world->CreateGameObject("sphere");
 
 	Vector3 sphereSize = Vector3(radius, radius, radius);
-	SphereVolume* volume = new SphereVolume(radius);
+	SphereVolume* volume = world->CreateSphereVolume(radius);
 	sphere->SetBoundingVolume((CollisionVolume*)volume);
 
 	sphere->GetTransform()
 		.SetScale(sphereSize)
 		.SetPosition(position);
 
-	sphere->gOType = type;
+	sphere->SetType(type);
 
-	sphere->SetRenderObject(new RenderObject(&sphere->GetTransform(), sphereMesh, basicTex, basicShader));
-	sphere->SetPhysicsObject(new PhysicsObject(&sphere->GetTransform(), sphere->GetBoundingVolume()));
+	world->CreateRenderObject(sphere, sphereMesh, basicTex, basicShader);
+	world->CreatePhysicsObject(sphere);
 
 	sphere->GetPhysicsObject()->SetInverseMass(inverseMass);
 	sphere->GetPhysicsObject()->InitSphereInertia();
@@ -577,19 +846,17 @@ GameObject* TutorialGame::AddSphereToWorld(const Vector3& position, float radius
 }
 
 GameObject* TutorialGame::AddCapsuleToWorld(const Vector3& position, float halfHeight, float radius, float inverseMass) {
-	GameObject* capsule = new GameObject();
-	std::string name = "capsule";
-	capsule->SetName(name);
+	GameObject* capsule = world->CreateGameObject("capsule");
 
-	CapsuleVolume* volume = new CapsuleVolume(halfHeight, radius);
+	CapsuleVolume* volume = world->CreateCapsuleVolume(halfHeight, radius);
 	capsule->SetBoundingVolume((CollisionVolume*)volume);
 
 	capsule->GetTransform()
 		.SetScale(Vector3(radius* 2, halfHeight, radius * 2))
 		.SetPosition(position);
 
-	capsule->SetRenderObject(new RenderObject(&capsule->GetTransform(), capsuleMesh, basicTex, basicShader));
-	capsule->SetPhysicsObject(new PhysicsObject(&capsule->GetTransform(), capsule->GetBoundingVolume()));
+	world->CreateRenderObject(capsule, capsuleMesh, basicTex, basicShader);
+	world->CreatePhysicsObject(capsule);
 
 	capsule->GetPhysicsObject()->SetInverseMass(inverseMass);
 	capsule->GetPhysicsObject()->InitCubeInertia();
@@ -600,11 +867,9 @@ GameObject* TutorialGame::AddCapsuleToWorld(const Vector3& position, float halfH
 }
 
 GameObject* TutorialGame::AddCapsuleToWorld(const Vector3& position, float  halfheight, float radius, Quaternion& orientation, float inverseMass, GameObjectType type) {
-	GameObject* capsule = new GameObject();
-	std::string name = "capsule";
-	capsule->SetName(name);
+	GameObject* capsule = world->CreateGameObject("capsule");
 
-	CapsuleVolume* volume = new CapsuleVolume(halfheight, radius);
+	CapsuleVolume* volume = world->CreateCapsuleVolume(halfheight, radius);
 	capsule->SetBoundingVolume((CollisionVolume*)volume);
 
 	capsule->GetTransform()
@@ -612,8 +877,8 @@ GameObject* TutorialGame::AddCapsuleToWorld(const Vector3& position, float  half
 		.SetPosition(position)
 		.SetOrientation(orientation);
 
-	capsule->SetRenderObject(new RenderObject(&capsule->GetTransform(), capsuleMesh, basicTex, basicShader));
-	capsule->SetPhysicsObject(new PhysicsObject(&capsule->GetTransform(), capsule->GetBoundingVolume()));
+	world->CreateRenderObject(capsule, capsuleMesh, basicTex, basicShader);
+	world->CreatePhysicsObject(capsule);
 	capsule->GetPhysicsObject()->SetInverseMass(inverseMass);
 	capsule->GetPhysicsObject()->InitCubeInertia();
 
@@ -623,16 +888,14 @@ GameObject* TutorialGame::AddCapsuleToWorld(const Vector3& position, float  half
 }
 
 GameObject* TutorialGame::AddCubeToWorld(const Vector3& position, Vector3 dimensions, Quaternion& orientation, float inverseMass, GameObjectType type) {
-	GameObject* cube = new GameObject();
-	std::string name = "cube";
-	cube->SetName(name);
+	GameObject* cube = world->CreateGameObject("cube");
 
 	if (orientation == Quaternion(0, 0, 0, 1)) {
-		AABBVolume* volume = new AABBVolume(dimensions);
+		AABBVolume* volume = world->CreateAABBVolume(dimensions);
 		cube->SetBoundingVolume((CollisionVolume*)volume);
 	}
 	else {
-		OBBVolume* volume = new OBBVolume(dimensions);
+		OBBVolume* volume = world->CreateOBBVolume(dimensions);
 		cube->SetBoundingVolume((CollisionVolume*)volume);
 	}
 
@@ -641,10 +904,10 @@ GameObject* TutorialGame::AddCubeToWorld(const Vector3& position, Vector3 dimens
 		.SetScale(dimensions * 2)
 		.SetOrientation(orientation);
 
-	cube->gOType = type;
+	cube->SetType(type);
 
-	cube->SetRenderObject(new RenderObject(&cube->GetTransform(), cubeMesh, basicTex, basicShader));
-	cube->SetPhysicsObject(new PhysicsObject(&cube->GetTransform(), cube->GetBoundingVolume()));
+	world->CreateRenderObject(cube, cubeMesh, basicTex, basicShader);
+	world->CreatePhysicsObject(cube);
 
 	cube->GetPhysicsObject()->SetInverseMass(inverseMass);
 	cube->GetPhysicsObject()->InitCubeInertia();
@@ -661,11 +924,11 @@ SMPushBlock* TutorialGame::AddSpringBlockToWorld(const Vector3& position, Vector
 	spring->SetName(name);
 
 	if (orientation == Quaternion(0, 0, 0, 1)) {
-		AABBVolume* volume = new AABBVolume(dimensions);
+		AABBVolume* volume = world->CreateAABBVolume(dimensions);
 		spring->SetBoundingVolume((CollisionVolume*)volume);
 	}
 	else {
-		OBBVolume* volume = new OBBVolume(dimensions);
+		OBBVolume* volume = world->CreateOBBVolume(dimensions);
 		spring->SetBoundingVolume((CollisionVolume*)volume);
 	}
 
@@ -674,13 +937,14 @@ SMPushBlock* TutorialGame::AddSpringBlockToWorld(const Vector3& position, Vector
 		.SetScale(dimensions * 2)
 		.SetOrientation(orientation);
 
-	spring->SetRenderObject(new RenderObject(&spring->GetTransform(), cubeMesh, basicTex, basicShader));
-	spring->SetPhysicsObject(new PhysicsObject(&spring->GetTransform(), spring->GetBoundingVolume()));
+	world->CreateRenderObject(spring, cubeMesh, basicTex, basicShader);
+	world->CreatePhysicsObject(spring);
 
 	spring->GetPhysicsObject()->SetInverseMass(inverseMass);
 	spring->GetPhysicsObject()->InitCubeInertia();
 
-	spring->gOType = GameObjectType::_SPRING;
+	spring->SetType(GameObjectType::_SPRING);
+	spring->AddTag(GameObjectTag::_PUSH_BLOCK);
 	spring->InitObjType();
 
 	world->AddGameObject(spring);
@@ -740,9 +1004,9 @@ GameObject* TutorialGame::AddPlayerToWorld(const Vector3& position) {
 	float meshSize = 3.0f;
 	float inverseMass = 0.5f;
 
-	GameObject* character = new GameObject();
+	GameObject* character = world->CreateGameObject();
 
-	AABBVolume* volume = new AABBVolume(Vector3(0.3f, 0.85f, 0.3f) * meshSize);
+	AABBVolume* volume = world->CreateAABBVolume(Vector3(0.3f, 0.85f, 0.3f) * meshSize);
 
 	character->SetBoundingVolume((CollisionVolume*)volume);
 
@@ -751,12 +1015,12 @@ GameObject* TutorialGame::AddPlayerToWorld(const Vector3& position) {
 		.SetPosition(position);
 
 	if (rand() % 2) {
-		character->SetRenderObject(new RenderObject(&character->GetTransform(), charMeshA, nullptr, basicShader));
+		world->CreateRenderObject(character, charMeshA, nullptr, basicShader);
 	}
 	else {
-		character->SetRenderObject(new RenderObject(&character->GetTransform(), charMeshB, nullptr, basicShader));
+		world->CreateRenderObject(character, charMeshB, nullptr, basicShader);
 	}
-	character->SetPhysicsObject(new PhysicsObject(&character->GetTransform(), character->GetBoundingVolume()));
+	world->CreatePhysicsObject(character);
 
 	character->GetPhysicsObject()->SetInverseMass(inverseMass);
 	character->GetPhysicsObject()->InitSphereInertia();
@@ -772,17 +1036,17 @@ GameObject* TutorialGame::AddEnemyToWorld(const Vector3& position) {
 	float meshSize		= 3.0f;
 	float inverseMass	= 0.5f;
 
-	GameObject* character = new GameObject();
+	GameObject* character = world->CreateGameObject();
 
-	AABBVolume* volume = new AABBVolume(Vector3(0.3f, 0.9f, 0.3f) * meshSize);
+	AABBVolume* volume = world->CreateAABBVolume(Vector3(0.3f, 0.9f, 0.3f) * meshSize);
 	character->SetBoundingVolume((CollisionVolume*)volume);
 
 	character->GetTransform()
 		.SetScale(Vector3(meshSize, meshSize, meshSize))
 		.SetPosition(position);
 
-	character->SetRenderObject(new RenderObject(&character->GetTransform(), enemyMesh, nullptr, basicShader));
-	character->SetPhysicsObject(new PhysicsObject(&character->GetTransform(), character->GetBoundingVolume()));
+	world->CreateRenderObject(character, enemyMesh, nullptr, basicShader);
+	world->CreatePhysicsObject(character);
 
 	character->GetPhysicsObject()->SetInverseMass(inverseMass);
 	character->GetPhysicsObject()->InitSphereInertia();
@@ -793,16 +1057,16 @@ GameObject* TutorialGame::AddEnemyToWorld(const Vector3& position) {
 }
 
 GameObject* TutorialGame::AddBonusToWorld(const Vector3& position) {
-	GameObject* apple = new GameObject();
+	GameObject* apple = world->CreateGameObject();
 
-	SphereVolume* volume = new SphereVolume(0.25f);
+	SphereVolume* volume = world->CreateSphereVolume(0.25f);
 	apple->SetBoundingVolume((CollisionVolume*)volume);
 	apple->GetTransform()
 		.SetScale(Vector3(0.25, 0.25, 0.25))
 		.SetPosition(position);
 
-	apple->SetRenderObject(new RenderObject(&apple->GetTransform(), bonusMesh, nullptr, basicShader));
-	apple->SetPhysicsObject(new PhysicsObject(&apple->GetTransform(), apple->GetBoundingVolume()));
+	world->CreateRenderObject(apple, bonusMesh, nullptr, basicShader);
+	world->CreatePhysicsObject(apple);
 
 	apple->GetPhysicsObject()->SetInverseMass(1.0f);
 	apple->GetPhysicsObject()->InitSphereInertia();
@@ -815,15 +1079,15 @@ GameObject* TutorialGame::AddBonusToWorld(const Vector3& position) {
 StateAIObject* TutorialGame::AddStateObjectToWorld(const Vector3& position, GameObjectType type) {
 	StateAIObject* apple = new StateAIObject();
 
-	SphereVolume* volume = new SphereVolume(1.0f);
+	SphereVolume* volume = world->CreateSphereVolume(1.0f);
 	apple->SetBoundingVolume((CollisionVolume*)volume);
 	apple->GetTransform()
 		.SetScale(Vector3(0.25, 0.25, 0.25))
 		.SetPosition(position);
 
-	apple->SetRenderObject(new RenderObject(&apple->GetTransform(), bonusMesh, nullptr, basicShader));
-	apple->SetPhysicsObject(new PhysicsObject(&apple->GetTransform(), apple->GetBoundingVolume()));
-	apple->gOType = type;
+	world->CreateRenderObject(apple, bonusMesh, nullptr, basicShader);
+	world->CreatePhysicsObject(apple);
+	apple->SetType(type);
 
 	apple->GetPhysicsObject()->SetInverseMass(1.0f);
 	apple->GetPhysicsObject()->InitSphereInertia();
@@ -831,6 +1095,7 @@ StateAIObject* TutorialGame::AddStateObjectToWorld(const Vector3& position, Game
 	apple->targetPos = ball->GetTransform().GetPosition();
 	apple->coins = coins;
 	apple->bumpers = bumpers;
+	apple->world = world;
 
 	world->AddGameObject(apple);
 	apple->InitObjType();
@@ -866,7 +1131,7 @@ bool TutorialGame::SelectObject(float dt) {
 				selectionObject->InitObjType();
 
 				selectionObject = nullptr;
-				lockedObject = nullptr;
+				LockCameraToObject(nullptr);
 			}
 
 			Ray ray = CollisionDetection::BuildRayFromMouse(*world->GetMainCamera());
@@ -875,13 +1140,8 @@ bool TutorialGame::SelectObject(float dt) {
 			if (world->Raycast(ray, closestCollision, true)) {
 				selectionObject = (GameObject*)closestCollision.node;
 
-				if (selectionObject->gOType == GameObjectType::_BUTTON_SPRING) {
-					for (auto i : vSprings) {
-						if (i) {
-							i->springFired = true;
-							i->Update(dt);
-						}
-					}
+				if (selectionObject->GetType() == GameObjectType::_BUTTON_SPRING) {
+					FireSprings(dt);
 					return true;
 				}
 
@@ -911,10 +1171,10 @@ bool TutorialGame::SelectObject(float dt) {
 	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::L)) {
 		if (selectionObject) {
 			if (lockedObject == selectionObject) {
-				lockedObject = nullptr;
+				LockCameraToObject(nullptr);
 			}
 			else {
-				lockedObject = selectionObject;
+				LockCameraToObject(selectionObject);
 			}
 		}
 
@@ -925,59 +1185,77 @@ bool TutorialGame::SelectObject(float dt) {
 
 void TutorialGame::UpdateObjectState(float dt) {
 	if (fallingLog) {
-		if (fallingLog->gOType == GameObjectType::_RESET) {
+		if (fallingLog->GetType() == GameObjectType::_RESET) {
 			fallingLog->GetPhysicsObject()->SetLinearVelocity(Vector3(0,0,0));
 			fallingLog->GetTransform().SetPosition(Vector3(0,20,0));
-			fallingLog->gOType = GameObjectType::_LOG;
+			fallingLog->SetType(GameObjectType::_LOG);
 		}
 	}
 	if (ball) {
-		if (ball->gOType == GameObjectType::_RESET) {
+		if (ball->GetType() == GameObjectType::_RESET) {
 			ball->GetPhysicsObject()->SetLinearVelocity(Vector3(0, 0, 0));
 			ball->GetTransform().SetPosition(Vector3(16, 2, 16));
-			ball->gOType = GameObjectType::_NULL;
+			ball->SetType(GameObjectType::_NULL);
 		}
-		if (ball->gOType == GameObjectType::_GOAL) {
+		if (ball->GetType() == GameObjectType::_GOAL) {
 			finished = true;
 			fState = FinishState::_WIN;
 		}
-		if (ball->gOType == GameObjectType::_AI) {
+		if (ball->GetType() == GameObjectType::_AI) {
 			finished = true;
 			fState = FinishState::_LOSE;
 		}
 	}
 	if (testStateObject)
 	{
-		if (testStateObject->gOType == GameObjectType::_RESET_AI) {
+		if (testStateObject->GetType() == GameObjectType::_RESET_AI) {
 			testStateObject->GetPhysicsObject()->SetLinearVelocity(Vector3(0, 0, 0));
 			testStateObject->GetTransform().SetPosition(Vector3(-15, 2, 15));
-			testStateObject->gOType = GameObjectType::_AI;
+			testStateObject->SetType(GameObjectType::_AI);
 		}
 	}
-	for (int i = 0; i < coins.size(); i++) {
-		if (coins[i]->gOType == GameObjectType::_COIN_COLLECTED || coins[i]->gOType == GameObjectType::_COIN_COLLECTED_AI) {
-			PlaySound(TEXT("../../Assets/Audio/coin.wav"), NULL, SND_ASYNC);
+	//Only the coins that were touched this frame, rather than all of them
+	auto collect = [this](GameObject* coin) { CollectCoin(coin); };
+	world->ForEachOfType(GameObjectType::_COIN_COLLECTED, collect);
+	world->ForEachOfType(GameObjectType::_COIN_COLLECTED_AI, collect);
+}
 
-			coins[i]->GetPhysicsObject()->SetLinearVelocity(Vector3(0, 0, 0));
-			if (gMode == Gamemode::_GM1) {
-				coins[i]->GetTransform().SetPosition(Vector3(-12, 2, -4 + (3 * score)));
-			}
-			if (gMode == Gamemode::_GM2) {
-				coins[i]->GetTransform().SetPosition(Vector3(-19, 7, -19 + (3 * score)));
-			}
-			if (coins[i]->gOType == GameObjectType::_COIN_COLLECTED_AI) {
-				coins[i]->gOType = GameObjectType::_COIN;
-				coins.erase(coins.begin() + i);
-				score--;
-				testStateObject->coins = coins;
-			}
-			else {
-				coins[i]->gOType = GameObjectType::_COIN;
-				coins.erase(coins.begin() + i);
-				score++;
-			}
-		}
+void TutorialGame::CollectCoin(GameObject* coin) {
+	auto i = std::find(coins.begin(), coins.end(), coin->GetHandle());
+	if (i == coins.end()) {
+		return; //Already on the scoreboard
+	}
+#ifdef _WIN32
+	if (!headless) {
+		PlaySound(TEXT("../../Assets/Audio/coin.wav"), NULL, SND_ASYNC);
 	}
+#endif
+
+	coin->GetPhysicsObject()->SetLinearVelocity(Vector3(0, 0, 0));
+	if (gMode == Gamemode::_GM1) {
+		coin->GetTransform().SetPosition(Vector3(-12, 2, -4 + (3 * score)));
+	}
+	if (gMode == Gamemode::_GM2) {
+		coin->GetTransform().SetPosition(Vector3(-19, 7, -19 + (3 * score)));
+	}
+	if (coin->GetType() == GameObjectType::_COIN_COLLECTED_AI) {
+		coin->SetType(GameObjectType::_COIN);
+		coins.erase(i);
+		score--;
+		testStateObject->coins = coins;
+	}
+	else {
+		coin->SetType(GameObjectType::_COIN);
+		coins.erase(i);
+		score++;
+	}
+}
+
+void TutorialGame::FireSprings(float dt) {
+	world->ForEachWithTag(GameObjectTag::_PUSH_BLOCK, [dt](GameObject* o) {
+		o->springFired = true;
+		static_cast<SMPushBlock*>(o)->Update(dt);
+	});
 }
 
 void TutorialGame::UpdateTimer(float dt) {
@@ -1019,7 +1297,7 @@ void TutorialGame::MoveSelectedObject() {
 	}
 
 	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::SPACE)) {
-		if (selectionObject->gOType == GameObjectType::_SPRING)
+		if (selectionObject->GetType() == GameObjectType::_SPRING)
 			selectionObject->springFired = true;
 	}
 }
@@ -1,8 +1,11 @@
 #pragma once
 #include "GameTechRenderer.h"
+#include "NullRenderer.h"
 #include "../CSC8503Common/PhysicsSystem.h"
 #include "../CSC8503Common/StateAIObject.h"
 #include "../CSC8503Common/SMPushBlock.h"
+#include "../CSC8503Common/LevelFile.h"
+#include "../../Common/InputRecording.h"
 
 namespace NCL {
 	namespace CSC8503 {
@@ -17,21 +20,62 @@ namespace NCL {
 			_WIN
 		};
 
+		//What an agent does each step, in place of the keyboard
+		struct GameActions {
+			Vector2	ballPush;				//-1 to 1 on each axis - x along x, y along z
+			bool	fireSprings = false;	//As if M were pressed
+		};
+
 		class TutorialGame		{
 		public:
-			TutorialGame(bool gm1);
+			//A headless game draws nothing, and loads no meshes, textures or shaders
+			TutorialGame(bool gm1, bool headless = false);
 			~TutorialGame();
 
 			virtual void UpdateGame(float dt);
 
-			float GetTimer() { return timer; }
-			float GetScore() { return score; }
-			GameTechRenderer* GetRenderer() { return renderer; }
+			//A frame of the game, driven by actions instead of the keyboard, and not drawn
+			void StepSimulation(float dt, const GameActions& actions);
+
+			//Starts the game mode again, with a new timer and no score
+			void Restart();
+
+			//The world is built from this on every InitWorld rather than from
+			//the level file, so games can share one level - nullptr to stop
+			void SetLevel(const LevelFile* level) {
+				sharedLevel = level;
+			}
+			void CaptureLevel(LevelFile& level);
+
+			GameObject* GetBall() const { return ball; }
+			StateAIObject* GetStateAI() const { return testStateObject; }
+			GameWorld* GetWorld() const { return world; }
+			bool IsFinished() const { return finished; }
+			const std::vector<GameObjectHandle>& GetCoins() const { return coins; }
+
+			float GetTimer() const { return timer; }
+			float GetScore() const { return score; }
+			RendererBase* GetRenderer() { return renderer; }
+			PhysicsSystem* GetPhysics() { return physics; }
+			bool IsHeadless() const { return headless; }
 			void ResetRenderer();
 			void PrintPause();
 			void PrintWin();
 			void PrintLose();
 
+			//Every UpdateGame adds a frame to the recording, with the input it
+			//sees and its dt - nullptr to stop recording
+			void SetInputRecording(InputRecording* r) {
+				recording = r;
+			}
+
+			//Where each game mode's level is loaded from, if it's there
+			static std::string GetLevelFilename(Gamemode mode);
+
+			//Builds the world with the game mode's Init function, and saves it
+			//as a level for the game to load instead
+			bool ExportLevel(const std::string& filename);
+
 			FinishState fState;
 			Gamemode gMode;
 		protected:
@@ -40,9 +84,19 @@ namespace NCL {
 			void InitCamera();
 			void UpdateKeys(float dt);
 			void UpdateObjectState(float dt);
+			void CollectCoin(GameObject* coin);
+			void FireSprings(float dt);
 			void UpdateTimer(float dt);
 
-			void InitWorld();
+			//UpdateGame and StepSimulation both step the game with these
+			void BeginStep(float dt);
+			void UpdateAI(float dt);
+			void EndStep(float dt);
+
+			void InitWorld(bool fromLevelFile = true);
+			bool LoadLevel(const std::string& filename);
+			void AddLevel(const LevelFile& level);
+			LevelFile::Bindings GetLevelBindings();
 
 			void InitGameExamples();
 
@@ -54,6 +108,7 @@ namespace NCL {
 			void InitGamemode1();
 			void InitGamemode2();
 			void BridgeConstraintTest();
+			void XPBDBridgeTest();
 			void MoveBall();
 	
 			bool SelectObject(float dt);
@@ -84,7 +139,7 @@ namespace NCL {
 			GameObject* ball;
 			StateAIObject* testStateObject;
 
-			GameTechRenderer*	renderer;
+			RendererBase*		renderer;
 			PhysicsSystem*		physics;
 			GameWorld*			world;
 
@@ -92,17 +147,22 @@ namespace NCL {
 			bool		inSelectionMode;
 			bool		debugMenu;
 			bool		debugObject;
+			bool		showProfile;
+			bool		writeProfile;
 			bool		finished;
 			bool		addScore;
+			bool		headless;
+
+			InputRecording* recording = nullptr;
+			const LevelFile* sharedLevel = nullptr;
 
 			float		forceMagnitude;
 			float		timer;
 			int			score;
 
 			GameObject* selectionObject = nullptr;
-			std::vector<GameObject*> coins;
-			std::vector<GameObject*> bumpers;
-			std::vector<SMPushBlock*> vSprings;
+			std::vector<GameObjectHandle> coins;
+			std::vector<GameObjectHandle> bumpers;
 
 			OGLMesh*	capsuleMesh = nullptr;
 			OGLMesh*	cubeMesh	= nullptr;
@@ -119,9 +179,8 @@ namespace NCL {
 			//Coursework Additional functionality	
 			GameObject* lockedObject	= nullptr;
 			Vector3 lockedOffset		= Vector3(0, 14, 20);
-			void LockCameraToObject(GameObject* o) {
-				lockedObject = o;
-			}
+			Transform cameraRig;
+			void LockCameraToObject(GameObject* o);
 		};
 	}
 }
@@ -0,0 +1,67 @@
+#include "BatchCheck.h"
+#include "../CSC8503Common/WorldBatch.h"
+#include "../../Common/GameTimer.h"
+#include "../../Common/FrameArena.h"
+
+#include <iostream>
+#include <iomanip>
+
+using namespace NCL;
+using namespace CSC8503;
+
+bool BatchCheck::Run(BenchmarkSceneType scene, int numBodies, int numWorlds, int frames, float frameTime, bool csv) {
+	//One world at a time, the way the game steps its own
+	unsigned long long singleHash = 0;
+	double singleTime = 0.0;
+	{
+		BenchmarkWorld	single(scene, numBodies);
+		GameWorld&		world	= single.world;
+		PhysicsSystem&	physics	= single.physics;
+
+		GameTimer timer;
+		timer.Tick();
+		for (int i = 0; i < frames; ++i) {
+			world.UpdateWorld(frameTime);
+			physics.Update(frameTime);
+			FrameArena::EndFrame();
+		}
+		timer.Tick();
+		singleTime = timer.GetTimeDeltaSeconds();
+		singleHash = physics.GetStateHash();
+		world.ClearAndErase();
+	}
+
+	WorldBatch batch;
+	batch.AddWorlds(numWorlds, [&](WorldBatch::Instance& i) {
+		BenchmarkScenes::BuildScene(i.world, i.physics.GetXPBDSystem(), scene, numBodies);
+	});
+	WorldBatchTimings timings = batch.Run(frames, frameTime);
+
+	int mismatches = 0;
+	for (int i = 0; i < batch.GetWorldCount(); ++i) {
+		if (batch.GetWorld(i).physics.GetStateHash() != singleHash) {
+			mismatches++;
+		}
+	}
+	batch.Clear();
+
+	double singleRate	= singleTime > 0.0 ? frames / singleTime : 0.0;
+	double speedUp		= singleRate > 0.0 ? timings.worldStepsPerSecond / singleRate : 0.0;
+	const char* name = BenchmarkScenes::GetSceneName(scene);
+	if (csv) {
+		std::cout << name << "," << numBodies << "," << numWorlds << "," << frames << "," << singleRate << ","
+			<< timings.worldStepsPerSecond << "," << speedUp << "," << mismatches << "\n";
+		return mismatches == 0;
+	}
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "Scene " << name << ", " << numBodies << " bodies, " << numWorlds << " worlds, " << frames << " frames\n";
+	std::cout << "\tOne world on its own  " << singleRate << " world steps/s\n";
+	std::cout << "\tBatch                 " << timings.worldStepsPerSecond << " world steps/s (x" << speedUp << ")\n";
+	if (mismatches > 0) {
+		std::cout << "\t" << mismatches << " of the worlds ended up different to the one stepped on its own\n";
+	}
+	else {
+		std::cout << "\tEvery world matches the one stepped on its own\n";
+	}
+	return mismatches == 0;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "BenchmarkScenes.h"
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Builds the same scene in every world of a WorldBatch and steps them
+		all side by side, reporting how many world steps a second that gets
+		through, against stepping one world on its own. As the worlds all
+		start off the same, and share nothing, they should all still be the
+		same at the end - and the same as the world stepped on its own.
+		*/
+		class BatchCheck {
+		public:
+			//Returns false if any world in the batch ended up different
+			static bool Run(BenchmarkSceneType scene, int numBodies, int numWorlds, int frames, float frameTime, bool csv);
+
+		private:
+			BatchCheck()	{}
+			~BatchCheck()	{}
+		};
+	}
+}
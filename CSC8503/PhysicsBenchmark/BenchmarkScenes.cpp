@@ -0,0 +1,276 @@
+#include "BenchmarkScenes.h"
+#include "../CSC8503Common/GameObject.h"
+#include "../CSC8503Common/PositionConstraint.h"
+#include <cmath>
+
+using namespace NCL;
+using namespace CSC8503;
+
+static const char* sceneNames[(int)BenchmarkSceneType::MAX_SCENES] = {
+	"sphere",
+	"cube",
+	"mixed",
+	"bridge",
+	"ropes",
+	"cloth"
+};
+
+const char* BenchmarkScenes::GetSceneName(BenchmarkSceneType type) {
+	if (type >= BenchmarkSceneType::MAX_SCENES) {
+		return "invalid";
+	}
+	return sceneNames[(int)type];
+}
+
+bool BenchmarkScenes::GetSceneFromName(const std::string& name, BenchmarkSceneType& type) {
+	for (int i = 0; i < (int)BenchmarkSceneType::MAX_SCENES; ++i) {
+		if (name == sceneNames[i]) {
+			type = (BenchmarkSceneType)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+The grids are centred on the origin so that even the largest scenes stay
+inside the 1024 unit QuadTree the broadphase builds every frame - anything
+outside of it would never generate a collision pair, and would make the
+larger runs look far cheaper than they really are.
+*/
+int BenchmarkScenes::BuildScene(GameWorld& world, XPBDSystem& xpbd, BenchmarkSceneType type, int numBodies) {
+	int gridSize	= (int)ceil(sqrt((float)numBodies));
+	float spacing	= 3.5f;
+	float extent	= gridSize * spacing * 0.5f + 10.0f;
+	int added		= 0;
+
+	switch (type) {
+		case BenchmarkSceneType::SphereGrid: {
+			added = BuildSphereGrid(world, gridSize, gridSize, spacing, spacing, 1.0f);
+		}break;
+		case BenchmarkSceneType::CubeGrid: {
+			added = BuildCubeGrid(world, gridSize, gridSize, spacing, spacing, Vector3(1, 1, 1));
+		}break;
+		case BenchmarkSceneType::MixedGrid: {
+			added = BuildMixedGrid(world, gridSize, gridSize, spacing, spacing);
+		}break;
+		case BenchmarkSceneType::Bridge: {
+			int numLinks	= 10;
+			int numBridges	= std::max(1, numBodies / (numLinks + 2));
+			added	= BuildBridges(world, numBridges, numLinks);
+			extent	= sqrt((float)numBridges * 35.0f * 4.0f) * 0.5f + 40.0f;
+		}break;
+		case BenchmarkSceneType::XPBDRopes: {
+			int numLinks	= 50;
+			added	= BuildRopes(xpbd, std::max(1, numBodies / numLinks), numLinks);
+		}break;
+		case BenchmarkSceneType::XPBDCloth: {
+			int width		= 20;
+			int height		= 30;
+			added	= BuildCloth(xpbd, std::max(1, numBodies / (width * height)), width, height);
+		}break;
+		default:
+			return 0;
+	}
+	AddFloor(world, Vector3(0, -2, 0), Vector3(extent, 2, extent));
+	return added;
+}
+
+int BenchmarkScenes::BuildSphereGrid(GameWorld& world, int numRows, int numCols, float rowSpacing, float colSpacing, float radius) {
+	Vector3 offset = Vector3(numCols * colSpacing, 0, numRows * rowSpacing) * -0.5f;
+	for (int x = 0; x < numCols; ++x) {
+		for (int z = 0; z < numRows; ++z) {
+			Vector3 position = Vector3(x * colSpacing, 10.0f, z * rowSpacing) + offset;
+			AddSphere(world, position, radius, 1.0f);
+		}
+	}
+	return numRows * numCols;
+}
+
+int BenchmarkScenes::BuildCubeGrid(GameWorld& world, int numRows, int numCols, float rowSpacing, float colSpacing, const Vector3& cubeDims) {
+	Vector3 offset = Vector3(numCols * colSpacing, 0, numRows * rowSpacing) * -0.5f;
+	for (int x = 0; x < numCols; ++x) {
+		for (int z = 0; z < numRows; ++z) {
+			Vector3 position = Vector3(x * colSpacing, 10.0f, z * rowSpacing) + offset;
+			AddCube(world, position, cubeDims, 1.0f);
+		}
+	}
+	return numRows * numCols;
+}
+
+int BenchmarkScenes::BuildMixedGrid(GameWorld& world, int numRows, int numCols, float rowSpacing, float colSpacing) {
+	float sphereRadius	= 1.0f;
+	Vector3 cubeDims	= Vector3(1, 1, 1);
+	Vector3 offset		= Vector3(numCols * colSpacing, 0, numRows * rowSpacing) * -0.5f;
+
+	for (int x = 0; x < numCols; ++x) {
+		for (int z = 0; z < numRows; ++z) {
+			Vector3 position = Vector3(x * colSpacing, 10.0f, z * rowSpacing) + offset;
+			//Alternate rather than use rand(), so every run builds the same scene
+			if ((x + z) % 2) {
+				AddCube(world, position, cubeDims);
+			}
+			else {
+				AddSphere(world, position, sphereRadius);
+			}
+		}
+	}
+	return numRows * numCols;
+}
+
+/*
+Each bridge is the same chain as TutorialGame::BridgeConstraintTest (static
+ends, 10 links) but scaled down by 8, so that many of them can be laid out
+side by side inside the broadphase bounds.
+*/
+int BenchmarkScenes::BuildBridges(GameWorld& world, int numBridges, int numLinks) {
+	Vector3 cubeSize	= Vector3(1, 1, 1);
+	float invCubeMass	= 5;		//how heavy the middle pieces are
+	float maxDistance	= 3.75f;	//constraint distance
+	float cubeDistance	= 2.5f;		//distance between links
+
+	float bridgeLength	= (numLinks + 2) * cubeDistance + 5.0f;
+	float bridgeGap		= 4.0f;
+
+	int numAcross	= std::max(1, (int)ceil(sqrt(numBridges * bridgeGap / bridgeLength)));
+	int numDown		= (numBridges + numAcross - 1) / numAcross;
+
+	Vector3 offset = Vector3(numAcross * bridgeLength, 0, numDown * bridgeGap) * -0.5f;
+
+	int added = 0;
+	for (int b = 0; b < numBridges; ++b) {
+		Vector3 startPos = offset + Vector3((b % numAcross) * bridgeLength, 10.0f, (b / numAcross) * bridgeGap);
+
+		GameObject* start	= AddCube(world, startPos, cubeSize, 0);
+		GameObject* end		= AddCube(world, startPos + Vector3((numLinks + 2) * cubeDistance, 0, 0), cubeSize, 0);
+
+		GameObject* previous = start;
+
+		for (int i = 0; i < numLinks; ++i) {
+			GameObject* block = AddCube(world, startPos + Vector3((i + 1) * cubeDistance, 0, 0), cubeSize, invCubeMass);
+			world.AddConstraint(new PositionConstraint(previous, block, maxDistance));
+			previous = block;
+		}
+		world.AddConstraint(new PositionConstraint(previous, end, maxDistance));
+		added += numLinks + 2;
+	}
+	return added;
+}
+
+/*
+Ropes hang from a fixed first particle, starting out horizontal so that
+they swing down - the bending constraints between every third particle
+stop them from folding up completely.
+*/
+int BenchmarkScenes::BuildRopes(XPBDSystem& xpbd, int numRopes, int numLinks) {
+	float linkLength	= 0.5f;
+	float ropeGap		= 2.0f;
+	int numAcross		= std::max(1, (int)ceil(sqrt((float)numRopes)));
+
+	Vector3 offset = Vector3(numAcross * ropeGap, 0, numAcross * ropeGap) * -0.5f;
+
+	for (int r = 0; r < numRopes; ++r) {
+		Vector3 startPos = offset + Vector3((r % numAcross) * ropeGap, 50.0f, (r / numAcross) * ropeGap);
+
+		xpbd.AddParticle(startPos, 0.0f);
+		for (int i = 1; i < numLinks; ++i) {
+			int p = xpbd.AddParticle(startPos + Vector3(i * linkLength, 0, 0), 1.0f);
+			xpbd.AddDistanceConstraint(p - 1, p);
+			if (i > 1) {
+				xpbd.AddBendingConstraint(p - 2, p - 1, p, 0.001f);
+			}
+		}
+	}
+	return numRopes * numLinks;
+}
+
+/*
+Banners are pinned along their top edge, and have stretch constraints along
+each row and column, plus bending constraints across every pair of them.
+*/
+int BenchmarkScenes::BuildCloth(XPBDSystem& xpbd, int numBanners, int width, int height) {
+	float spacing	= 0.25f;
+	float gap		= 2.0f;
+	int numAcross	= std::max(1, (int)ceil(sqrt((float)numBanners)));
+
+	Vector3 offset = Vector3(numAcross * (width * spacing + gap), 0, numAcross * gap) * -0.5f;
+
+	for (int b = 0; b < numBanners; ++b) {
+		Vector3 corner = offset + Vector3((b % numAcross) * (width * spacing + gap), 20.0f, (b / numAcross) * gap);
+
+		int first = xpbd.GetParticleCount();
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				//Lie flat to start with, so the banners have to fall into place
+				xpbd.AddParticle(corner + Vector3(x * spacing, 0, y * spacing), y == 0 ? 0.0f : 1.0f);
+			}
+		}
+		auto Index = [&](int x, int y) {
+			return first + (y * width) + x;
+		};
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				if (x > 0) {
+					xpbd.AddDistanceConstraint(Index(x - 1, y), Index(x, y));
+				}
+				if (y > 0) {
+					xpbd.AddDistanceConstraint(Index(x, y - 1), Index(x, y));
+				}
+				if (x > 1) {
+					xpbd.AddBendingConstraint(Index(x - 2, y), Index(x - 1, y), Index(x, y), 0.01f);
+				}
+				if (y > 1) {
+					xpbd.AddBendingConstraint(Index(x, y - 2), Index(x, y - 1), Index(x, y), 0.01f);
+				}
+			}
+		}
+	}
+	return numBanners * width * height;
+}
+
+GameObject* BenchmarkScenes::AddFloor(GameWorld& world, const Vector3& position, const Vector3& halfSize) {
+	GameObject* floor = world.CreateObject("floor", (CollisionVolume*)world.CreateAABBVolume(halfSize));
+	floor->GetTransform()
+		.SetScale(halfSize * 2)
+		.SetPosition(position);
+
+	floor->GetPhysicsObject()->SetInverseMass(0);
+	floor->GetPhysicsObject()->InitCubeInertia();
+
+	world.AddGameObject(floor);
+
+	return floor;
+}
+
+GameObject* BenchmarkScenes::AddSphere(GameWorld& world, const Vector3& position, float radius, float inverseMass) {
+	GameObject* sphere = world.CreateObject("sphere", (CollisionVolume*)world.CreateSphereVolume(radius));
+
+	Vector3 sphereSize = Vector3(radius, radius, radius);
+
+	sphere->GetTransform()
+		.SetScale(sphereSize)
+		.SetPosition(position);
+
+	sphere->GetPhysicsObject()->SetInverseMass(inverseMass);
+	sphere->GetPhysicsObject()->InitSphereInertia();
+
+	world.AddGameObject(sphere);
+
+	return sphere;
+}
+
+GameObject* BenchmarkScenes::AddCube(GameWorld& world, const Vector3& position, const Vector3& dimensions, float inverseMass) {
+	GameObject* cube = world.CreateObject("cube", (CollisionVolume*)world.CreateOBBVolume(dimensions));
+
+	cube->GetTransform()
+		.SetPosition(position)
+		.SetScale(dimensions * 2)
+		.SetOrientation(Quaternion(0, 0, 0, 1));
+
+	cube->GetPhysicsObject()->SetInverseMass(inverseMass);
+	cube->GetPhysicsObject()->InitCubeInertia();
+
+	world.AddGameObject(cube);
+
+	return cube;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "../CSC8503Common/GameWorld.h"
+#include "../CSC8503Common/PhysicsSystem.h"
+#include "../CSC8503Common/XPBDSystem.h"
+#include <string>
+
+namespace NCL {
+	namespace CSC8503 {
+		enum class BenchmarkSceneType {
+			SphereGrid = 0,
+			CubeGrid,
+			MixedGrid,
+			Bridge,
+			XPBDRopes,
+			XPBDCloth,
+			MAX_SCENES
+		};
+
+		/*
+		Builds the same scenes as TutorialGame's InitSphereGridWorld, InitCubeGridWorld,
+		InitMixedGridWorld and BridgeConstraintTest, but without any meshes, textures
+		or shaders, so they can be stepped without a window or an OpenGL context.
+		The rope and cloth scenes are made of XPBD particles rather than GameObjects.
+		*/
+		class BenchmarkScenes {
+		public:
+			//Fills the world (or the XPBD system, for the XPBD scenes) with roughly 'numBodies'
+			//dynamic bodies / particles, returns how many were added
+			static int BuildScene(GameWorld& world, XPBDSystem& xpbd, BenchmarkSceneType type, int numBodies);
+
+			static const char*	GetSceneName(BenchmarkSceneType type);
+			static bool			GetSceneFromName(const std::string& name, BenchmarkSceneType& type);
+
+			static int BuildSphereGrid(GameWorld& world, int numRows, int numCols, float rowSpacing, float colSpacing, float radius);
+			static int BuildCubeGrid(GameWorld& world, int numRows, int numCols, float rowSpacing, float colSpacing, const Vector3& cubeDims);
+			static int BuildMixedGrid(GameWorld& world, int numRows, int numCols, float rowSpacing, float colSpacing);
+			static int BuildBridges(GameWorld& world, int numBridges, int numLinks);
+			static int BuildRopes(XPBDSystem& xpbd, int numRopes, int numLinks);
+			static int BuildCloth(XPBDSystem& xpbd, int numBanners, int width, int height);
+
+			static GameObject* AddFloor(GameWorld& world, const Vector3& position, const Vector3& halfSize);
+			static GameObject* AddSphere(GameWorld& world, const Vector3& position, float radius, float inverseMass = 10.0f);
+			static GameObject* AddCube(GameWorld& world, const Vector3& position, const Vector3& dimensions, float inverseMass = 10.0f);
+
+		private:
+			BenchmarkScenes()	{}
+			~BenchmarkScenes()	{}
+		};
+
+		/*
+		A world and its physics, for the checks that step a scene and compare
+		where it ends up. Physics is stepped at a fixed rate, as the adaptive
+		timestep depends on how long each step took, which no two runs will
+		agree on.
+		*/
+		struct BenchmarkWorld {
+			BenchmarkWorld() : physics(world) {
+				physics.UseAdaptiveTimestep(false);
+			}
+			//Filled with one of the scenes
+			BenchmarkWorld(BenchmarkSceneType scene, int numBodies) : BenchmarkWorld() {
+				bodies = BenchmarkScenes::BuildScene(world, physics.GetXPBDSystem(), scene, numBodies);
+			}
+
+			GameWorld		world;
+			PhysicsSystem	physics;
+			int				bodies = 0;	//How many BuildScene added
+		};
+	}
+}
@@ -0,0 +1,133 @@
+#include "DeferredChangesCheck.h"
+#include "../CSC8503Common/GameObject.h"
+#include "../CSC8503Common/PhysicsSystem.h"
+#include "../../Common/FrameArena.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace NCL;
+using namespace CSC8503;
+
+namespace {
+	//Every this many objects is taken out and put back each frame, starting
+	//one further along each time
+	const int churnSpacing = 4;
+
+	//Both worlds get the same parent, so it can't make them differ
+	void AttachFirstTwo(GameWorld& world) {
+		const std::vector<GameObject*>& objects = world.GetGameObjects();
+		if (objects.size() >= 2) {
+			world.GetTransformHierarchy().Attach(&objects[1]->GetTransform(), &objects[0]->GetTransform(), Vector3(0, 2, 0));
+		}
+	}
+}
+
+bool DeferredChangesCheck::Run(BenchmarkSceneType scene, int numBodies, int frames, float frameTime, bool csv) {
+	BenchmarkWorld	changed(scene, numBodies);
+	BenchmarkWorld	untouched(scene, numBodies);
+	GameWorld&		world				= changed.world;
+	PhysicsSystem&	physics				= changed.physics;
+	GameWorld&		untouchedWorld		= untouched.world;
+	PhysicsSystem&	untouchedPhysics	= untouched.physics;
+	AttachFirstTwo(world);
+	AttachFirstTwo(untouchedWorld);
+
+	std::vector<GameObject*> objects(world.GetGameObjects());
+	std::vector<GameObjectHandle> handles;
+	for (GameObject* o : objects) {
+		handles.emplace_back(o->GetHandle());
+	}
+	int removalsReported = 0;
+	world.AddRemovalListener(&removalsReported,
+		[&removalsReported](const std::vector<GameObject*>& removed) { removalsReported += (int)removed.size(); });
+
+	int churned = 0;
+	for (int i = 0; i < frames; ++i) {
+		{
+			GameWorld::DeferScope defer(world);
+			for (size_t j = i % churnSpacing; j < objects.size(); j += churnSpacing) {
+				world.RemoveGameObject(objects[j], false);
+				world.AddGameObject(objects[j]);
+				churned++;
+			}
+		}
+		world.UpdateWorld(frameTime);
+		physics.Update(frameTime);
+		untouchedWorld.UpdateWorld(frameTime);
+		untouchedPhysics.Update(frameTime);
+		FrameArena::EndFrame();
+	}
+
+	std::vector<GameObject*> listed(world.GetGameObjects());
+	std::sort(listed.begin(), listed.end());
+	bool listRight = listed.size() == objects.size() && std::adjacent_find(listed.begin(), listed.end()) == listed.end();
+
+	int lostHandles		= 0;
+	int strayComponents	= 0;
+	for (size_t i = 0; i < objects.size(); ++i) {
+		GameObject* o = objects[i];
+		if (world.GetGameObject(handles[i]) != o || o->GetHandle() != handles[i]) {
+			lostHandles++;
+			continue;
+		}
+		if (o->GetPhysicsObject() && world.GetPhysicsObjects().Get(handles[i].index) != o->GetPhysicsObject()) {
+			strayComponents++;
+		}
+	}
+	bool stillAttached	= objects.size() < 2 || world.GetTransformHierarchy().IsAttached(&objects[1]->GetTransform());
+	bool matched		= physics.GetStateHash() == untouchedPhysics.GetStateHash();
+	int  putBackRemovals = removalsReported;
+
+	//Then some are removed twice before the changes are applied, the second
+	//time to delete them, and they should only come out (and be deleted) once
+	int removedTwice = 0;
+	{
+		GameWorld::DeferScope defer(world);
+		for (size_t j = 0; j < objects.size(); j += churnSpacing) {
+			world.RemoveGameObject(objects[j], (j / churnSpacing) % 2 == 1);
+			world.RemoveGameObject(objects[j], true);
+			removedTwice++;
+		}
+	}
+	bool removedOnce = removalsReported - putBackRemovals == removedTwice && world.GetGameObjects().size() == objects.size() - removedTwice;
+	bool passed		 = listRight && lostHandles == 0 && strayComponents == 0 && putBackRemovals == 0 && stillAttached && matched && removedOnce;
+
+	world.RemoveRemovalListeners(&removalsReported);
+	world.ClearAndErase();
+	untouchedWorld.ClearAndErase();
+
+	const char* name = BenchmarkScenes::GetSceneName(scene);
+	if (csv) {
+		std::cout << name << "," << objects.size() << "," << frames << "," << churned << "," << listRight << "," << lostHandles << ","
+			<< strayComponents << "," << putBackRemovals << "," << stillAttached << "," << matched << "," << removedOnce << "\n";
+		return passed;
+	}
+	std::cout << "Scene " << name << ", " << objects.size() << " objects, " << frames << " frames, "
+		<< churned << " objects taken out and put back\n";
+	if (!listRight) {
+		std::cout << "\tThe object list has " << listed.size() << " entries, or an object in it twice\n";
+	}
+	if (lostHandles > 0) {
+		std::cout << "\t" << lostHandles << " objects lost their handles\n";
+	}
+	if (strayComponents > 0) {
+		std::cout << "\t" << strayComponents << " objects' physics are no longer in the world's store\n";
+	}
+	if (putBackRemovals > 0) {
+		std::cout << "\tThe removal listeners were told of " << putBackRemovals << " removals\n";
+	}
+	if (!stillAttached) {
+		std::cout << "\tThe attached object was taken out of the hierarchy\n";
+	}
+	if (!matched) {
+		std::cout << "\tThe world ended up different to the one left alone\n";
+	}
+	if (!removedOnce) {
+		std::cout << "\tRemoving " << removedTwice << " objects twice didn't take each out once\n";
+	}
+	if (passed) {
+		std::cout << "\tNothing changed, the world matches the one left alone, and objects removed twice came out once\n";
+	}
+	return passed;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "BenchmarkScenes.h"
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Every frame, takes some of a scene's objects out of the world and puts
+		them straight back, inside a DeferScope, and steps it alongside the
+		same scene left alone. As the removals never get applied, nothing
+		should change - each object should still be in the list once, with
+		the handle and components it had, and still attached to its parent,
+		the removal listeners should never hear of it, and both worlds should
+		end up the same. Then it removes some twice in one DeferScope, the
+		second time to delete them, and checks each only comes out once.
+		*/
+		class DeferredChangesCheck {
+		public:
+			//Returns false if putting the objects back changed anything
+			static bool Run(BenchmarkSceneType scene, int numBodies, int frames, float frameTime, bool csv);
+
+		private:
+			DeferredChangesCheck()	{}
+			~DeferredChangesCheck()	{}
+		};
+	}
+}
@@ -0,0 +1,71 @@
+#include "DeterminismCheck.h"
+#include "../CSC8503Common/PhysicsSystem.h"
+#include "../../Common/SIMD.h"
+#include "../../Common/JobSystem.h"
+#include "../../Common/FrameArena.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace NCL;
+using namespace CSC8503;
+
+namespace {
+	void RunScene(BenchmarkSceneType scene, int numBodies, int frames, float frameTime, std::vector<unsigned long long>& hashes) {
+		BenchmarkWorld	run(scene, numBodies);
+		GameWorld&		world	= run.world;
+		PhysicsSystem&	physics	= run.physics;
+
+		hashes.clear();
+		for (int i = 0; i < frames; ++i) {
+			physics.Update(frameTime);
+			hashes.emplace_back(physics.GetStateHash());
+			FrameArena::EndFrame();
+		}
+		world.ClearAndErase();
+	}
+}
+
+bool DeterminismCheck::Run(BenchmarkSceneType scene, int numBodies, int frames, float frameTime, bool csv) {
+	int maxThreads = JobSystem::GetThreadCount();
+	JobSystem::Initialise(1);
+
+	std::vector<unsigned long long> serialHashes;
+	RunScene(scene, numBodies, frames, frameTime, serialHashes);
+
+	std::vector<unsigned long long> threadedHashes;
+	JobSystem::Initialise(maxThreads);
+	RunScene(scene, numBodies, frames, frameTime, threadedHashes);
+
+	int firstMismatch = -1;
+	for (int i = 0; i < frames; ++i) {
+		if (serialHashes[i] != threadedHashes[i]) {
+			firstMismatch = i;
+			break;
+		}
+	}
+
+	const char* name = BenchmarkScenes::GetSceneName(scene);
+	if (csv) {
+		for (int i = 0; i < frames; ++i) {
+			std::cout << name << "," << numBodies << "," << i << "," << std::hex << std::setw(16) << std::setfill('0')
+				<< serialHashes[i] << std::dec << std::setfill(' ') << "," << (serialHashes[i] == threadedHashes[i] ? 1 : 0) << "\n";
+		}
+		return firstMismatch < 0;
+	}
+
+	std::cout << "Scene " << name << ": " << numBodies << " bodies, " << frames << " frames, " << SIMD::GetBackendName()
+#if defined(NCL_DETERMINISTIC)
+		<< " (deterministic)"
+#endif
+		<< "\n";
+	std::cout << "\tFinal hash         " << std::hex << std::setw(16) << std::setfill('0') << serialHashes.back() << std::dec << std::setfill(' ') << "\n";
+	if (firstMismatch < 0) {
+		std::cout << "\t1 and " << maxThreads << " threads match on every frame\n";
+	}
+	else {
+		std::cout << "\t1 and " << maxThreads << " threads first differ on frame " << firstMismatch << "\n";
+	}
+	return firstMismatch < 0;
+}
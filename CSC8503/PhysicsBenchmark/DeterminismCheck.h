@@ -0,0 +1,26 @@
+#pragma once
+#include "BenchmarkScenes.h"
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Steps one of the benchmark scenes twice - once on a single thread and
+		once on every thread the JobSystem has - hashing the whole physics
+		state after every frame, and reports the first frame the two runs stop
+		matching, if they ever do.
+
+		To check two different builds (SIMD against NCL_SIMD_SCALAR, MSVC against
+		GCC, one machine against another), build both with NCL_DETERMINISTIC
+		defined, run each with -csv, and diff the per-frame hashes.
+		*/
+		class DeterminismCheck {
+		public:
+			//Returns false if the single and multi threaded runs didn't match
+			static bool Run(BenchmarkSceneType scene, int numBodies, int frames, float frameTime, bool csv);
+
+		private:
+			DeterminismCheck()	{}
+			~DeterminismCheck()	{}
+		};
+	}
+}
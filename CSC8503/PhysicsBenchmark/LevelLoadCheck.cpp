@@ -0,0 +1,101 @@
+#include "LevelLoadCheck.h"
+#include "../CSC8503Common/PhysicsSystem.h"
+#include "../CSC8503Common/LevelFile.h"
+#include "../../Common/GameTimer.h"
+#include "../../Common/FrameArena.h"
+
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+
+using namespace NCL;
+using namespace CSC8503;
+
+namespace {
+	const char* levelFilename = "PhysicsBenchmark.level";
+}
+
+bool LevelLoadCheck::Run(BenchmarkSceneType scene, int numBodies, int frames, float frameTime, bool csv) {
+	BenchmarkWorld	built;
+	BenchmarkWorld	loaded;
+	GameWorld&		builtWorld		= built.world;
+	PhysicsSystem&	builtPhysics	= built.physics;
+	GameWorld&		loadedWorld		= loaded.world;
+	PhysicsSystem&	loadedPhysics	= loaded.physics;
+
+	GameTimer timer;
+	timer.Tick();
+	BenchmarkScenes::BuildScene(builtWorld, builtPhysics.GetXPBDSystem(), scene, numBodies);
+	timer.Tick();
+	double buildTime = timer.GetTimeDeltaSeconds();
+
+	LevelFile::Bindings bindings;
+	LevelFile saved;
+	saved.Capture(builtWorld, bindings);
+	timer.Tick();
+	bool wrote = saved.Save(levelFilename);
+	timer.Tick();
+	double saveTime = timer.GetTimeDeltaSeconds();
+
+	LevelFile level;
+	timer.Tick();
+	bool read = wrote && level.Load(levelFilename);
+	timer.Tick();
+	double readTime = timer.GetTimeDeltaSeconds();
+	std::remove(levelFilename);
+
+	timer.Tick();
+	size_t objects = level.AddToWorld(loadedWorld, bindings);
+	timer.Tick();
+	double addTime = timer.GetTimeDeltaSeconds();
+
+	std::vector<Constraint*>::const_iterator firstConstraint;
+	std::vector<Constraint*>::const_iterator lastConstraint;
+	builtWorld.GetConstraintIterators(firstConstraint, lastConstraint);
+	bool stepped = firstConstraint == lastConstraint && builtPhysics.GetXPBDSystem().GetParticleCount() == 0;
+
+	//Particles are left out of the first hash, as they aren't in the level
+	int particles = builtPhysics.GetXPBDSystem().GetParticleCount();
+	builtPhysics.GetXPBDSystem().Clear();
+	bool matched = read && objects == builtWorld.GetGameObjects().size() &&
+		builtPhysics.GetStateHash() == loadedPhysics.GetStateHash();
+
+	if (matched && stepped) {
+		for (int i = 0; i < frames; ++i) {
+			builtPhysics.Update(frameTime);
+			loadedPhysics.Update(frameTime);
+			FrameArena::EndFrame();
+		}
+		matched = builtPhysics.GetStateHash() == loadedPhysics.GetStateHash();
+	}
+	builtWorld.ClearAndErase();
+	loadedWorld.ClearAndErase();
+
+	const char* name = BenchmarkScenes::GetSceneName(scene);
+	if (csv) {
+		std::cout << name << "," << objects << "," << level.GetTables().size() << "," << level.GetByteSize() << ","
+			<< buildTime * 1000.0 << "," << saveTime * 1000.0 << "," << readTime * 1000.0 << "," << addTime * 1000.0 << ","
+			<< (matched ? 1 : 0) << "\n";
+		return matched;
+	}
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "Scene " << name << ": " << objects << " objects in " << level.GetTables().size() << " tables, "
+		<< level.GetByteSize() / 1024 << " KB\n";
+	std::cout << "\tBuild one by one   " << buildTime * 1000.0 << " ms\n";
+	std::cout << "\tSave               " << saveTime * 1000.0 << " ms\n";
+	std::cout << "\tRead file          " << readTime * 1000.0 << " ms\n";
+	std::cout << "\tAdd to world       " << addTime * 1000.0 << " ms\n";
+	if (!read) {
+		std::cout << "\tCouldn't save and load " << levelFilename << "\n";
+	}
+	else if (!matched) {
+		std::cout << "\tThe loaded level doesn't match the scene it was saved from\n";
+	}
+	else if (stepped) {
+		std::cout << "\tThe loaded level matches the scene after " << frames << " frames\n";
+	}
+	else {
+		std::cout << "\tThe loaded objects match the scene (" << particles << " particles and the constraints aren't saved)\n";
+	}
+	return matched;
+}
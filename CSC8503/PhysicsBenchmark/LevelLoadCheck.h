@@ -0,0 +1,25 @@
+#pragma once
+#include "BenchmarkScenes.h"
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Builds one of the benchmark scenes the usual way, one object at a
+		time, then saves it as a LevelFile and loads it back into a second
+		world, timing each part. Both worlds are then stepped side by side
+		to check the level came back exactly as it went out.
+
+		Constraints and XPBD particles aren't part of a level, so for the
+		bridge, rope and cloth scenes only the objects are checked.
+		*/
+		class LevelLoadCheck {
+		public:
+			//Returns false if the loaded world didn't match the one it was saved from
+			static bool Run(BenchmarkSceneType scene, int numBodies, int frames, float frameTime, bool csv);
+
+		private:
+			LevelLoadCheck()	{}
+			~LevelLoadCheck()	{}
+		};
+	}
+}
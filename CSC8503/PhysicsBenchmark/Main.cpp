@@ -0,0 +1,405 @@
+#include "BenchmarkScenes.h"
+#include "MathsBenchmark.h"
+#include "DeterminismCheck.h"
+#include "RollbackCheck.h"
+#include "LevelLoadCheck.h"
+#include "StreamingCheck.h"
+#include "BatchCheck.h"
+#include "DeferredChangesCheck.h"
+#include "../CSC8503Common/PhysicsSystem.h"
+#include "../../Common/GameTimer.h"
+#include "../../Common/JobSystem.h"
+#include "../../Common/Profiler.h"
+#include "../../Common/FrameArena.h"
+#include "../../Common/AllocationCounter.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+using namespace NCL;
+using namespace CSC8503;
+
+/*
+
+A windowless benchmark for the physics system. It builds one of the canned
+scenes in BenchmarkScenes, steps it for a fixed number of frames at a fixed
+frame time, and reports how long each physics phase took.
+
+It only needs Common and CSC8503Common - there's no window, renderer or
+input, so it builds and runs on Linux too. From the repository root:
+
+	g++ -std=c++17 -O2 -pthread -o PhysicsBenchmark \
+		Common/{Vector2,Vector3,Vector4,Matrix2,Matrix3,Matrix4,Quaternion,Maths,Plane,CPUFeatures,SIMDKernels}.cpp \
+		Common/{Camera,GameTimer,JobSystem,Profiler,FrameArena,AllocationCounter}.cpp \
+		Common/{Window,NullWindow,InputRecording,Keyboard,Mouse,RendererBase}.cpp \
+		CSC8503/CSC8503Common/{CollisionDetection,ConstraintSolver,Debug,GameObject,GameWorld}.cpp \
+		CSC8503/CSC8503Common/{LevelFile,PhysicsObject,PhysicsSnapshot,PhysicsSystem,PositionConstraint,QuadTree,RenderObject,Transform}.cpp \
+		CSC8503/CSC8503Common/{TransformHierarchy,WorldBatch,WorldPartition,XPBDSystem}.cpp \
+		CSC8503/PhysicsBenchmark/{BenchmarkScenes,MathsBenchmark,DeterminismCheck,RollbackCheck}.cpp \
+		CSC8503/PhysicsBenchmark/{LevelLoadCheck,StreamingCheck,BatchCheck,DeferredChangesCheck,Main}.cpp
+
+Add -mavx2 -mfma (or -msse4.1) to build the maths classes with those instead
+of SSE2, or -DNCL_SIMD_SCALAR to build them without any SIMD at all.
+
+Usage:
+	PhysicsBenchmark [-scene sphere|cube|mixed|bridge|ropes|cloth|all] [-bodies 1000,10000,...]
+	                 [-frames 300] [-dt 0.016667] [-csv] [-serialconstraints] [-lod] [-threads N]
+	                 [-profile trace.json] [-allocs]
+	PhysicsBenchmark -maths [-csv]
+	PhysicsBenchmark -determinism [-scene ...] [-bodies ...] [-frames 300] [-dt 0.016667] [-csv] [-threads N]
+	PhysicsBenchmark -rollback [-scene ...] [-bodies ...] [-frames 300] [-dt 0.016667] [-csv] [-threads N]
+	PhysicsBenchmark -level [-scene ...] [-bodies ...] [-frames 300] [-dt 0.016667] [-csv] [-threads N]
+	PhysicsBenchmark -streaming [-bodies ...] [-frames 300] [-dt 0.016667] [-csv] [-threads N]
+	PhysicsBenchmark -batch N [-scene ...] [-bodies ...] [-frames 300] [-dt 0.016667] [-csv] [-threads N]
+	PhysicsBenchmark -deferred [-scene ...] [-bodies ...] [-frames 300] [-dt 0.016667] [-csv] [-threads N]
+
+-serialconstraints solves constraints one at a time in world order, rather
+than with the batched ConstraintSolver.
+-lod turns on physics level of detail, with the camera left at the origin,
+in the middle of the scene.
+-threads sets how many threads the JobSystem uses, rather than one per core.
+-profile writes every frame's Profiler scopes to a Chrome tracing file. Build
+with -DNCL_NO_PROFILER to leave the scopes out completely.
+-allocs reports how many heap allocations each frame makes once the scene has
+settled (over the second half of the frames), and how much of the frame
+arena it uses. Build with -DNCL_COUNT_ALLOCATIONS for the heap counts.
+-maths skips the physics scenes, and times the vector and quaternion
+operations instead (see MathsBenchmark.h).
+-determinism checks that the physics gives the same results on 1 thread as
+on many, rather than timing it (see DeterminismCheck.h). Add
+-DNCL_DETERMINISTIC -ffp-contract=off when building to check it gives the same
+results with any SIMD backend too.
+-rollback checks that restoring a PhysicsSnapshot and stepping on from it
+gets the same results as the first time, and times the snapshots (see
+RollbackCheck.h). Use -dt 0.008333 for one 120Hz physics step per frame.
+-level times saving each scene as a LevelFile and loading it back, against
+building it the usual way, and checks the loaded scene steps the same (see
+LevelLoadCheck.h).
+-streaming moves across a map split into WorldPartition cells, streaming them
+in and out, and times it against stepping the whole map (see
+StreamingCheck.h). The scene is ignored.
+-batch steps N copies of each scene side by side in a WorldBatch, and
+reports how many world steps a second that gets through, against one world
+on its own (see BatchCheck.h).
+-deferred takes objects out and puts them straight back inside a DeferScope
+every frame, and checks that changes nothing, then that removing objects
+twice only takes them out once (see DeferredChangesCheck.h).
+
+*/
+
+struct BenchmarkSettings {
+	std::vector<BenchmarkSceneType> scenes;
+	std::vector<int>	bodyCounts;
+	int		frames		= 300;
+	float	frameTime	= 1.0f / 60.0f;
+	bool	csv			= false;
+	bool	serialConstraints = false;
+	bool	lod			= false;
+	bool	maths		= false;
+	bool	determinism	= false;
+	bool	rollback	= false;
+	bool	level		= false;
+	bool	streaming	= false;
+	int		batchWorlds	= 0;
+	bool	deferred	= false;
+	int		threads		= 0;
+	bool	allocs		= false;
+	std::string	profileFile;
+};
+
+struct BenchmarkResult {
+	BenchmarkSceneType	scene;
+	int					bodies;
+	float				buildTime;
+	PhysicsTimings		totals;
+	float				heapAllocations	= 0.0f;	//Per frame, over the second half of the run
+	size_t				arenaBytes		= 0;	//Frame arena used by the last frame
+};
+
+void PrintUsage() {
+	std::cout << "Usage: PhysicsBenchmark [-scene sphere|cube|mixed|bridge|ropes|cloth|all] [-bodies N[,N...]] [-frames N] [-dt seconds] [-csv] [-serialconstraints] [-lod] [-threads N] [-profile file] [-allocs] [-maths] [-determinism] [-rollback] [-level] [-streaming] [-batch N] [-deferred]\n";
+}
+
+bool ParseArguments(int argc, char** argv, BenchmarkSettings& settings) {
+	for (int i = 1; i < argc; ++i) {
+		std::string arg		= argv[i];
+		bool hasValue		= i + 1 < argc;
+
+		if (arg == "-scene" && hasValue) {
+			std::string name = argv[++i];
+			if (name == "all") {
+				settings.scenes.clear();
+				continue;
+			}
+			BenchmarkSceneType type;
+			if (!BenchmarkScenes::GetSceneFromName(name, type)) {
+				std::cout << "Unknown scene " << name << "\n";
+				return false;
+			}
+			settings.scenes.emplace_back(type);
+		}
+		else if (arg == "-bodies" && hasValue) {
+			std::string list = argv[++i];
+			size_t start = 0;
+			while (start < list.size()) {
+				size_t end = list.find(',', start);
+				if (end == std::string::npos) {
+					end = list.size();
+				}
+				settings.bodyCounts.emplace_back(atoi(list.substr(start, end - start).c_str()));
+				start = end + 1;
+			}
+		}
+		else if (arg == "-frames" && hasValue) {
+			settings.frames = atoi(argv[++i]);
+		}
+		else if (arg == "-dt" && hasValue) {
+			settings.frameTime = (float)atof(argv[++i]);
+		}
+		else if (arg == "-csv") {
+			settings.csv = true;
+		}
+		else if (arg == "-serialconstraints") {
+			settings.serialConstraints = true;
+		}
+		else if (arg == "-lod") {
+			settings.lod = true;
+		}
+		else if (arg == "-threads" && hasValue) {
+			settings.threads = atoi(argv[++i]);
+		}
+		else if (arg == "-profile" && hasValue) {
+			settings.profileFile = argv[++i];
+		}
+		else if (arg == "-allocs") {
+			settings.allocs = true;
+		}
+		else if (arg == "-maths") {
+			settings.maths = true;
+		}
+		else if (arg == "-determinism") {
+			settings.determinism = true;
+		}
+		else if (arg == "-rollback") {
+			settings.rollback = true;
+		}
+		else if (arg == "-level") {
+			settings.level = true;
+		}
+		else if (arg == "-streaming") {
+			settings.streaming = true;
+		}
+		else if (arg == "-deferred") {
+			settings.deferred = true;
+		}
+		else if (arg == "-batch" && hasValue) {
+			settings.batchWorlds = atoi(argv[++i]);
+			if (settings.batchWorlds < 1) {
+				return false;
+			}
+		}
+		else {
+			return false;
+		}
+	}
+	if (settings.scenes.empty()) {
+		for (int i = 0; i < (int)BenchmarkSceneType::MAX_SCENES; ++i) {
+			settings.scenes.emplace_back((BenchmarkSceneType)i);
+		}
+	}
+	if (settings.bodyCounts.empty()) {
+		settings.bodyCounts.emplace_back(1000);
+	}
+	return settings.frames > 0 && settings.frameTime > 0.0f;
+}
+
+BenchmarkResult RunBenchmark(BenchmarkSceneType scene, int numBodies, const BenchmarkSettings& settings) {
+	BenchmarkResult result;
+	result.scene = scene;
+
+	BenchmarkWorld	run;
+	GameWorld&		world	= run.world;
+	PhysicsSystem&	physics	= run.physics;
+	physics.UseBatchedConstraints(!settings.serialConstraints);
+	physics.UseLOD(settings.lod);
+
+	GameTimer timer;
+	result.bodies = BenchmarkScenes::BuildScene(world, physics.GetXPBDSystem(), scene, numBodies);
+	timer.Tick();
+	result.buildTime = timer.GetTimeDeltaSeconds();
+
+	const int settledFrame = settings.frames / 2;
+	size_t allocationsAtSettle = 0;
+
+	for (int i = 0; i < settings.frames; ++i) {
+		if (i == settledFrame) {
+			allocationsAtSettle = AllocationCounter::GetAllocations();
+		}
+		physics.Update(settings.frameTime);
+		result.arenaBytes = FrameArena::GetFrameBytes();
+		NCL_PROFILE_FRAME();
+		FrameArena::EndFrame();
+		const PhysicsTimings& t = physics.GetTimings();
+
+		result.totals.integrateAccel	+= t.integrateAccel;
+		result.totals.broadPhase		+= t.broadPhase;
+		result.totals.narrowPhase		+= t.narrowPhase;
+		result.totals.constraints		+= t.constraints;
+		result.totals.integrateVelocity	+= t.integrateVelocity;
+		result.totals.xpbd				+= t.xpbd;
+		result.totals.collisionList		+= t.collisionList;
+		result.totals.total				+= t.total;
+		result.totals.substeps			+= t.substeps;
+		result.totals.bodySteps			+= t.bodySteps;
+		result.totals.particleSteps		+= t.particleSteps;
+	}
+	result.heapAllocations = (float)(AllocationCounter::GetAllocations() - allocationsAtSettle) / (settings.frames - settledFrame);
+
+	world.ClearAndErase();
+	return result;
+}
+
+void PrintResult(const BenchmarkResult& r, const BenchmarkSettings& settings) {
+	float toMS		= 1000.0f / settings.frames;
+	double stepsPerSecond = r.totals.total > 0.0f ? (double)r.totals.bodySteps / r.totals.total : 0.0;
+	double particleStepsPerSecond = r.totals.total > 0.0f ? (double)r.totals.particleSteps / r.totals.total : 0.0;
+
+	if (settings.csv) {
+		std::cout << BenchmarkScenes::GetSceneName(r.scene) << "," << r.bodies << "," << settings.frames << "," << r.totals.substeps << ","
+			<< r.buildTime * 1000.0f << ","
+			<< r.totals.integrateAccel * toMS << "," << r.totals.broadPhase * toMS << "," << r.totals.narrowPhase * toMS << ","
+			<< r.totals.constraints * toMS << "," << r.totals.integrateVelocity * toMS << "," << r.totals.xpbd * toMS << "," << r.totals.collisionList * toMS << ","
+			<< r.totals.total * toMS << "," << stepsPerSecond << "," << particleStepsPerSecond;
+		if (settings.allocs) {
+			std::cout << "," << r.heapAllocations << "," << r.arenaBytes;
+		}
+		std::cout << "\n";
+		return;
+	}
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "Scene " << BenchmarkScenes::GetSceneName(r.scene) << ": " << r.bodies << " bodies, "
+		<< settings.frames << " frames, " << r.totals.substeps << " substeps (built in " << r.buildTime * 1000.0f << "ms)\n";
+	std::cout << "\tIntegrate accel    " << r.totals.integrateAccel		* toMS << " ms/frame\n";
+	std::cout << "\tBroadphase         " << r.totals.broadPhase			* toMS << " ms/frame\n";
+	std::cout << "\tNarrowphase        " << r.totals.narrowPhase		* toMS << " ms/frame\n";
+	std::cout << "\tConstraints        " << r.totals.constraints		* toMS << " ms/frame\n";
+	std::cout << "\tIntegrate velocity " << r.totals.integrateVelocity	* toMS << " ms/frame\n";
+	std::cout << "\tXPBD               " << r.totals.xpbd				* toMS << " ms/frame\n";
+	std::cout << "\tCollision list     " << r.totals.collisionList		* toMS << " ms/frame\n";
+	std::cout << "\tTotal              " << r.totals.total				* toMS << " ms/frame\n";
+	std::cout << "\tThroughput         " << std::setprecision(0) << stepsPerSecond << " body steps/s\n";
+	if (r.totals.particleSteps > 0) {
+		std::cout << "\t                   " << particleStepsPerSecond << " particle steps/s\n";
+	}
+	if (settings.allocs) {
+		std::cout << "\tHeap allocations   " << std::setprecision(1) << r.heapAllocations << " /frame\n";
+		std::cout << "\tFrame arena        " << r.arenaBytes / 1024 << " KB/frame\n";
+	}
+}
+
+int main(int argc, char** argv) {
+	BenchmarkSettings settings;
+	if (!ParseArguments(argc, argv, settings)) {
+		PrintUsage();
+		return -1;
+	}
+	JobSystem::Initialise(settings.threads);
+
+	if (settings.maths) {
+		MathsBenchmark::Run(16384, 50, settings.csv);
+		return 0;
+	}
+	if (settings.determinism) {
+		bool matched = true;
+		if (settings.csv) {
+			std::cout << "scene,bodies,frame,hash,threads_match\n";
+		}
+		for (BenchmarkSceneType scene : settings.scenes) {
+			for (int bodies : settings.bodyCounts) {
+				matched &= DeterminismCheck::Run(scene, bodies, settings.frames, settings.frameTime, settings.csv);
+			}
+		}
+		return matched ? 0 : 1;
+	}
+	if (settings.rollback) {
+		bool matched = true;
+		if (settings.csv) {
+			std::cout << "scene,bodies,frames,rollbacks,save_ms_per_frame,restore_ms,delta_save_ms,delta_restore_ms,snapshot_bytes,delta_bytes,mismatches,delta_mismatches\n";
+		}
+		for (BenchmarkSceneType scene : settings.scenes) {
+			for (int bodies : settings.bodyCounts) {
+				matched &= RollbackCheck::Run(scene, bodies, settings.frames, settings.frameTime, settings.csv);
+			}
+		}
+		return matched ? 0 : 1;
+	}
+	if (settings.level) {
+		bool matched = true;
+		if (settings.csv) {
+			std::cout << "scene,objects,tables,level_bytes,build_ms,save_ms,read_ms,add_ms,matched\n";
+		}
+		for (BenchmarkSceneType scene : settings.scenes) {
+			for (int bodies : settings.bodyCounts) {
+				matched &= LevelLoadCheck::Run(scene, bodies, settings.frames, settings.frameTime, settings.csv);
+			}
+		}
+		return matched ? 0 : 1;
+	}
+	if (settings.streaming) {
+		bool matched = true;
+		if (settings.csv) {
+			std::cout << "bodies,objects,cells,most_active_objects,cell_loads,save_ms,first_load_ms,full_frame_ms,streamed_frame_ms,streaming_ms,worst_frame_ms,matched\n";
+		}
+		for (int bodies : settings.bodyCounts) {
+			matched &= StreamingCheck::Run(bodies, settings.frames, settings.frameTime, settings.csv);
+		}
+		return matched ? 0 : 1;
+	}
+	if (settings.deferred) {
+		bool matched = true;
+		if (settings.csv) {
+			std::cout << "scene,objects,frames,put_back,list_right,lost_handles,stray_components,removals_reported,still_attached,matched,removed_once\n";
+		}
+		for (BenchmarkSceneType scene : settings.scenes) {
+			for (int bodies : settings.bodyCounts) {
+				matched &= DeferredChangesCheck::Run(scene, bodies, settings.frames, settings.frameTime, settings.csv);
+			}
+		}
+		return matched ? 0 : 1;
+	}
+	if (settings.batchWorlds > 0) {
+		bool matched = true;
+		if (settings.csv) {
+			std::cout << "scene,bodies,worlds,frames,single_world_steps_per_second,batch_world_steps_per_second,speed_up,mismatches\n";
+		}
+		for (BenchmarkSceneType scene : settings.scenes) {
+			for (int bodies : settings.bodyCounts) {
+				matched &= BatchCheck::Run(scene, bodies, settings.batchWorlds, settings.frames, settings.frameTime, settings.csv);
+			}
+		}
+		return matched ? 0 : 1;
+	}
+	if (settings.csv) {
+		std::cout << "scene,bodies,frames,substeps,build_ms,integrate_accel_ms,broadphase_ms,narrowphase_ms,constraints_ms,integrate_velocity_ms,xpbd_ms,collision_list_ms,total_ms,body_steps_per_second,particle_steps_per_second";
+		std::cout << (settings.allocs ? ",heap_allocations_per_frame,frame_arena_bytes\n" : "\n");
+	}
+	if (settings.allocs && !AllocationCounter::IsCounting()) {
+		std::cout << "Built without NCL_COUNT_ALLOCATIONS, so heap allocations can't be counted\n";
+	}
+	if (!settings.profileFile.empty()) {
+		Profiler::StartCapture();
+	}
+	for (BenchmarkSceneType scene : settings.scenes) {
+		for (int bodies : settings.bodyCounts) {
+			PrintResult(RunBenchmark(scene, bodies, settings), settings);
+		}
+	}
+	if (!settings.profileFile.empty() && !Profiler::WriteChromeTrace(settings.profileFile)) {
+		std::cout << "Couldn't write " << settings.profileFile << "\n";
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,188 @@
+#include "MathsBenchmark.h"
+#include "../../Common/Vector3.h"
+#include "../../Common/Vector4.h"
+#include "../../Common/PaddedVector3.h"
+#include "../../Common/Quaternion.h"
+#include "../../Common/Matrix4.h"
+#include "../../Common/GameTimer.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace NCL;
+using namespace CSC8503;
+using namespace Maths;
+
+namespace {
+	//Same numbers every run, so checksums can be compared between builds
+	struct Random {
+		unsigned int state = 12345;
+
+		float Next() {
+			state = state * 1664525u + 1013904223u;
+			return ((state >> 8) / 16777216.0f) * 2.0f - 1.0f;
+		}
+	};
+
+	struct Inputs {
+		std::vector<Vector3>		v3;
+		std::vector<PaddedVector3>	p3;
+		std::vector<Vector4>		v4;
+		std::vector<Quaternion>		q;
+		std::vector<Matrix4>		m;	//rotation and translation only
+	};
+
+	void FillInputs(Inputs& in, int count) {
+		Random r;
+		for (int i = 0; i < count; ++i) {
+			Vector3 v(r.Next(), r.Next(), r.Next());
+			in.v3.emplace_back(v);
+			in.p3.emplace_back(v);
+			in.v4.emplace_back(Vector4(v, r.Next()));
+
+			Quaternion q(r.Next(), r.Next(), r.Next(), r.Next());
+			q.Normalise();
+			in.q.emplace_back(q);
+
+			Matrix4 m(q);
+			m.SetPositionVector(v * 10.0f);
+			in.m.emplace_back(m);
+		}
+	}
+
+	float Checksum(const float* f, size_t stride, size_t count) {
+		double sum = 0.0;
+		for (size_t i = 0; i < count; ++i) {
+			for (size_t j = 0; j < stride; ++j) {
+				sum += f[i * stride + j];
+			}
+		}
+		return (float)sum;
+	}
+
+	void PrintResult(const char* name, float seconds, int count, int repeats, float checksum, bool csv) {
+		double nsPerOp = seconds * 1e9 / ((double)count * repeats);
+		if (csv) {
+			std::cout << name << "," << SIMD::GetBackendName() << "," << nsPerOp << "," << checksum << "\n";
+			return;
+		}
+		std::cout << "\t" << std::left << std::setw(24) << name << std::right << std::fixed
+			<< std::setprecision(3) << std::setw(8) << nsPerOp << " ns/op   checksum "
+			<< std::setprecision(6) << checksum << "\n";
+	}
+
+	/*
+	Runs op(i) for every element, 'repeats' times over, and returns the fastest
+	of a few goes at that - anything slower than that was something else getting
+	in the way. The inputs stay the same on every pass, so the results only need
+	checking after the last one.
+	*/
+	template<typename T, typename F>
+	float Time(std::vector<T>& out, int count, int repeats, F op) {
+		const int tries = 5;
+		out.resize(count);
+		float best = 0.0f;
+		for (int t = 0; t < tries; ++t) {
+			GameTimer timer;
+			timer.Tick();
+			for (int r = 0; r < repeats; ++r) {
+				for (int i = 0; i < count; ++i) {
+					out[i] = op(i);
+				}
+			}
+			timer.Tick();
+			if (t == 0 || timer.GetTimeDeltaSeconds() < best) {
+				best = timer.GetTimeDeltaSeconds();
+			}
+		}
+		return best;
+	}
+}
+
+void MathsBenchmark::Run(int count, int repeats, bool csv) {
+	Inputs in;
+	FillInputs(in, count);
+
+	//Pairs each element up with the next one along
+	auto Other = [count](int i) { return (i + 1) % count; };
+
+	std::vector<float>			floats;
+	std::vector<Vector3>		v3s;
+	std::vector<PaddedVector3>	p3s;
+	std::vector<Vector4>		v4s;
+	std::vector<Quaternion>		qs;
+	std::vector<Matrix4>		ms;
+	float t;
+
+	if (csv) {
+		std::cout << "test,backend,ns_per_op,checksum\n";
+	}
+	else {
+		std::cout << "Maths backend " << SIMD::GetBackendName() << ", " << count << " elements x " << repeats << " repeats\n";
+	}
+
+	t = Time(floats, count, repeats, [&](int i) { return Vector3::Dot(in.v3[i], in.v3[Other(i)]); });
+	PrintResult("Vector3::Dot", t, count, repeats, Checksum(floats.data(), 1, count), csv);
+
+	t = Time(floats, count, repeats, [&](int i) { return PaddedVector3::Dot(in.p3[i], in.p3[Other(i)]); });
+	PrintResult("PaddedVector3::Dot", t, count, repeats, Checksum(floats.data(), 1, count), csv);
+
+	t = Time(floats, count, repeats, [&](int i) { return Vector4::Dot(in.v4[i], in.v4[Other(i)]); });
+	PrintResult("Vector4::Dot", t, count, repeats, Checksum(floats.data(), 1, count), csv);
+
+	t = Time(v3s, count, repeats, [&](int i) { return Vector3::Cross(in.v3[i], in.v3[Other(i)]); });
+	PrintResult("Vector3::Cross", t, count, repeats, Checksum(v3s[0].array, 3, count), csv);
+
+	t = Time(p3s, count, repeats, [&](int i) { return PaddedVector3::Cross(in.p3[i], in.p3[Other(i)]); });
+	PrintResult("PaddedVector3::Cross", t, count, repeats, Checksum(p3s[0].array, 4, count), csv);
+
+	t = Time(v3s, count, repeats, [&](int i) { return in.v3[i].Normalised(); });
+	PrintResult("Vector3::Normalise", t, count, repeats, Checksum(v3s[0].array, 3, count), csv);
+
+	t = Time(p3s, count, repeats, [&](int i) { return in.p3[i].Normalised(); });
+	PrintResult("PaddedVector3::Normalise", t, count, repeats, Checksum(p3s[0].array, 4, count), csv);
+
+	t = Time(v4s, count, repeats, [&](int i) { return in.v4[i].Normalised(); });
+	PrintResult("Vector4::Normalise", t, count, repeats, Checksum(v4s[0].array, 4, count), csv);
+
+	t = Time(qs, count, repeats, [&](int i) { return in.q[i] * in.q[Other(i)]; });
+	PrintResult("Quaternion multiply", t, count, repeats, Checksum(qs[0].array, 4, count), csv);
+
+	t = Time(v3s, count, repeats, [&](int i) { return in.q[i] * in.v3[Other(i)]; });
+	PrintResult("Quaternion * Vector3", t, count, repeats, Checksum(v3s[0].array, 3, count), csv);
+
+	t = Time(qs, count, repeats, [&](int i) { return Quaternion::Slerp(in.q[i], in.q[Other(i)], 0.25f); });
+	PrintResult("Quaternion::Slerp", t, count, repeats, Checksum(qs[0].array, 4, count), csv);
+
+	t = Time(ms, count, repeats, [&](int i) { return in.m[i] * in.m[Other(i)]; });
+	PrintResult("Matrix4 multiply", t, count, repeats, Checksum(ms[0].array, 16, count), csv);
+
+	t = Time(v4s, count, repeats, [&](int i) { return in.m[i] * in.v4[Other(i)]; });
+	PrintResult("Matrix4 * Vector4", t, count, repeats, Checksum(v4s[0].array, 4, count), csv);
+
+	t = Time(ms, count, repeats, [&](int i) { return in.m[i].Inverse(); });
+	PrintResult("Matrix4::Inverse", t, count, repeats, Checksum(ms[0].array, 16, count), csv);
+
+	t = Time(ms, count, repeats, [&](int i) { return in.m[i].AffineInverse(); });
+	PrintResult("Matrix4::AffineInverse", t, count, repeats, Checksum(ms[0].array, 16, count), csv);
+
+	t = Time(ms, count, repeats, [&](int i) { return in.m[i].RigidInverse(); });
+	PrintResult("Matrix4::RigidInverse", t, count, repeats, Checksum(ms[0].array, 16, count), csv);
+
+	//The same matrix over every point, as when moving a whole mesh
+	v3s.resize(count);
+	GameTimer timer;
+	float best = 0.0f;
+	for (int attempt = 0; attempt < 5; ++attempt) {
+		timer.Tick();
+		for (int r = 0; r < repeats; ++r) {
+			in.m[r % count].TransformPoints(in.v3.data(), v3s.data(), count);
+		}
+		timer.Tick();
+		if (attempt == 0 || timer.GetTimeDeltaSeconds() < best) {
+			best = timer.GetTimeDeltaSeconds();
+		}
+	}
+	PrintResult("Matrix4::TransformPoints", best, count, repeats, Checksum(v3s[0].array, 3, count), csv);
+}
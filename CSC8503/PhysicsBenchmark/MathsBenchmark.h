@@ -0,0 +1,25 @@
+#pragma once
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Times the maths operations the physics and renderer lean on hardest - vector
+		and quaternion operations, matrix multiplies and inverses - over arrays big
+		enough to not fit in L1, so that loads and stores are counted too. Each
+		test prints a checksum of its results, so that the same test from two
+		different builds can be checked against each other.
+
+		Vector3 is always plain C++, so its results are the 'before' for the
+		PaddedVector3 ones. For everything else, build a second copy with
+		NCL_SIMD_SCALAR defined to get the original implementation to compare to.
+		*/
+		class MathsBenchmark {
+		public:
+			static void Run(int count, int repeats, bool csv);
+
+		private:
+			MathsBenchmark()	{}
+			~MathsBenchmark()	{}
+		};
+	}
+}
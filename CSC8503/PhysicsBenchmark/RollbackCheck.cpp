@@ -0,0 +1,130 @@
+#include "RollbackCheck.h"
+#include "../CSC8503Common/PhysicsSystem.h"
+#include "../../Common/GameTimer.h"
+#include "../../Common/FrameArena.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace NCL;
+using namespace CSC8503;
+
+namespace {
+	const int rollbackFrames	= 8;
+	const int rollbackInterval	= 16;
+
+	void StepFrame(PhysicsSystem& physics, float frameTime) {
+		physics.Update(frameTime);
+		FrameArena::EndFrame();
+	}
+}
+
+bool RollbackCheck::Run(BenchmarkSceneType scene, int numBodies, int frames, float frameTime, bool csv) {
+	BenchmarkWorld	run(scene, numBodies);
+	GameWorld&		world	= run.world;
+	PhysicsSystem&	physics	= run.physics;
+	int				bodies	= run.bodies;
+
+	//One more than gets rolled back, so the oldest isn't overwritten by the newest
+	std::vector<PhysicsSnapshot> history(rollbackFrames + 1);
+	PhysicsSnapshot delta;
+	std::vector<char> deltaData;
+	std::vector<unsigned long long> hashes;
+
+	GameTimer timer;
+	double	saveTime		= 0.0;
+	double	restoreTime		= 0.0;
+	double	deltaSaveTime	= 0.0;
+	double	deltaRestoreTime = 0.0;
+	size_t	snapshotBytes	= 0;
+	size_t	deltaBytes		= 0;
+	int		rollbacks		= 0;
+	int		mismatches		= 0;
+	int		deltaMismatches	= 0;
+
+	for (int frame = 0; frame < frames; ++frame) {
+		StepFrame(physics, frameTime);
+		hashes.emplace_back(physics.GetStateHash());
+
+		timer.Tick();
+		physics.SaveSnapshot(history[frame % history.size()]);
+		timer.Tick();
+		saveTime += timer.GetTimeDeltaSeconds();
+
+		if (frame < rollbackFrames || frame % rollbackInterval != 0) {
+			continue;
+		}
+		const PhysicsSnapshot& base = history[(frame - rollbackFrames) % history.size()];
+
+		timer.Tick();
+		physics.SaveDeltaSnapshot(base, delta);
+		timer.Tick();
+		deltaSaveTime += timer.GetTimeDeltaSeconds();
+
+		//Through bytes and back, as it would be to go anywhere else
+		deltaData.clear();
+		delta.Write(deltaData);
+		if (!delta.Read(deltaData.data(), deltaData.size())) {
+			deltaMismatches++;
+		}
+
+		//Back to where we were 8 frames ago, and forward again
+		timer.Tick();
+		physics.RestoreSnapshot(base);
+		timer.Tick();
+		restoreTime += timer.GetTimeDeltaSeconds();
+
+		for (int i = 0; i < rollbackFrames; ++i) {
+			StepFrame(physics, frameTime);
+		}
+		if (physics.GetStateHash() != hashes[frame]) {
+			mismatches++;
+		}
+
+		//Then back to the same place again, from the older snapshot and the delta
+		physics.RestoreSnapshot(base);
+		timer.Tick();
+		physics.RestoreDeltaSnapshot(base, delta);
+		timer.Tick();
+		deltaRestoreTime += timer.GetTimeDeltaSeconds();
+		if (physics.GetStateHash() != hashes[frame]) {
+			deltaMismatches++;
+		}
+
+		snapshotBytes	= base.GetByteSize();
+		deltaBytes		= delta.GetByteSize();
+		rollbacks++;
+	}
+	world.ClearAndErase();
+
+	const char* name = BenchmarkScenes::GetSceneName(scene);
+	double toMS			= 1000.0 / frames;
+	double perRollback	= rollbacks > 0 ? 1000.0 / rollbacks : 0.0;
+
+	if (csv) {
+		std::cout << name << "," << bodies << "," << frames << "," << rollbacks << ","
+			<< saveTime * toMS << "," << restoreTime * perRollback << ","
+			<< deltaSaveTime * perRollback << "," << deltaRestoreTime * perRollback << ","
+			<< snapshotBytes << "," << deltaBytes << "," << mismatches << "," << deltaMismatches << "\n";
+		return mismatches == 0 && deltaMismatches == 0;
+	}
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "Scene " << name << ": " << bodies << " bodies, " << frames << " frames, "
+		<< rollbacks << " rollbacks of " << rollbackFrames << " frames\n";
+	std::cout << "\tSave               " << saveTime * toMS << " ms/frame\n";
+	std::cout << "\tRestore            " << restoreTime * perRollback << " ms\n";
+	std::cout << "\tSave delta         " << deltaSaveTime * perRollback << " ms\n";
+	std::cout << "\tRestore delta      " << deltaRestoreTime * perRollback << " ms\n";
+	std::cout << "\tSnapshot size      " << snapshotBytes / 1024 << " KB (delta " << deltaBytes / 1024 << " KB)\n";
+	if (rollbacks == 0) {
+		std::cout << "\tToo few frames to roll back\n";
+	}
+	else if (mismatches == 0 && deltaMismatches == 0) {
+		std::cout << "\tEvery rollback stepped forward to the same state\n";
+	}
+	else {
+		std::cout << "\t" << mismatches << " rollbacks and " << deltaMismatches << " delta rollbacks ended up somewhere else\n";
+	}
+	return mismatches == 0 && deltaMismatches == 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "BenchmarkScenes.h"
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Steps one of the benchmark scenes, taking a PhysicsSnapshot after every
+		frame, and every so often rolls back 8 frames, steps them all again,
+		and checks it ends up in exactly the same state it did the first time.
+		It does the same with a delta snapshot against the frame it rolled
+		back to, written out to bytes and read back in, and reports how long saving and restoring took, and how big
+		the snapshots were.
+		*/
+		class RollbackCheck {
+		public:
+			//Returns false if stepping on from a restored snapshot ever gave a different result
+			static bool Run(BenchmarkSceneType scene, int numBodies, int frames, float frameTime, bool csv);
+
+		private:
+			RollbackCheck()		{}
+			~RollbackCheck()	{}
+		};
+	}
+}
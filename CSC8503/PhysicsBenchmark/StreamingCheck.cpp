@@ -0,0 +1,172 @@
+#include "StreamingCheck.h"
+#include "BenchmarkScenes.h"
+#include "../CSC8503Common/PhysicsSystem.h"
+#include "../CSC8503Common/WorldPartition.h"
+#include "../../Common/GameTimer.h"
+#include "../../Common/FrameArena.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+using namespace NCL;
+using namespace CSC8503;
+
+namespace {
+	const char* cellPrefix	= "PhysicsBenchmarkCell";
+	const float cellSize	= 32.0f;
+	const int	mapCells	= 24;	//Along each side, which keeps it inside the broadphase's 1024 units
+
+	//One floor tile per cell, with the spheres spread evenly over them
+	void BuildMap(GameWorld& world, int numBodies) {
+		float mapSize	= cellSize * mapCells;
+		int perSide		= std::max(1, (int)std::ceil(std::sqrt((float)numBodies)));
+		float spacing	= mapSize / perSide;
+
+		for (int x = 0; x < mapCells; ++x) {
+			for (int z = 0; z < mapCells; ++z) {
+				Vector3 centre = Vector3((x + 0.5f) * cellSize, 0, (z + 0.5f) * cellSize) - Vector3(mapSize, 0, mapSize) * 0.5f;
+				BenchmarkScenes::AddFloor(world, centre + Vector3(0, -2, 0), Vector3(cellSize * 0.5f, 2, cellSize * 0.5f));
+			}
+		}
+		for (int i = 0; i < numBodies; ++i) {
+			Vector3 position = Vector3(((i % perSide) + 0.5f) * spacing, 1.5f, ((i / perSide) + 0.5f) * spacing);
+			BenchmarkScenes::AddSphere(world, position - Vector3(mapSize, 0, mapSize) * 0.5f, 1.0f, 1.0f);
+		}
+	}
+
+	//Straight across the middle of the map, from one edge to the other
+	Vector3 GetFocus(int frame, int frames) {
+		float mapSize	= cellSize * mapCells;
+		float along		= (frame + 0.5f) / frames;
+		return Vector3((along - 0.5f) * mapSize, 0, 0.25f * cellSize);
+	}
+}
+
+bool StreamingCheck::Run(int numBodies, int frames, float frameTime, bool csv) {
+	GameTimer timer;
+	LevelFile::Bindings bindings;
+
+	//The whole map, stepped as one
+	double fullTime	= 0.0;
+	size_t mapObjects = 0;
+	{
+		BenchmarkWorld	full;
+		GameWorld&		world	= full.world;
+		PhysicsSystem&	physics	= full.physics;
+		BuildMap(world, numBodies);
+		mapObjects = world.GetGameObjects().size();
+		for (int i = 0; i < frames; ++i) {
+			timer.Tick();
+			physics.Update(frameTime);
+			timer.Tick();
+			fullTime += timer.GetTimeDeltaSeconds();
+			FrameArena::EndFrame();
+		}
+		world.ClearAndErase();
+	}
+
+	BenchmarkWorld	streamed;
+	GameWorld&		world	= streamed.world;
+	PhysicsSystem&	physics	= streamed.physics;
+	int cellCount = 0;
+	double saveTime = 0.0;
+	{
+		GameWorld source;
+		BuildMap(source, numBodies);
+		WorldPartition saver(source, bindings, cellSize);
+		timer.Tick();
+		cellCount = saver.SaveCells(source, cellPrefix);
+		timer.Tick();
+		saveTime = timer.GetTimeDeltaSeconds();
+		source.ClearAndErase();
+	}
+
+	bool matched	= cellCount > 0;
+	double firstLoadTime	= 0.0;
+	double streamTime		= 0.0;
+	double updateTime		= 0.0;
+	double worstFrame		= 0.0;
+	size_t mostObjects		= 0;
+	int loads				= 0;
+	{
+		WorldPartition partition(world, bindings, cellSize);
+		for (int x = 0; x < mapCells; ++x) {
+			for (int z = 0; z < mapCells; ++z) {
+				partition.AddCell(x - mapCells / 2, z - mapCells / 2, WorldPartition::GetCellFilename(cellPrefix, x - mapCells / 2, z - mapCells / 2));
+			}
+		}
+		partition.SetRadii(2, 3);
+		partition.SetBuildsPerUpdate(25); //Enough to fill the whole active area in one go
+
+		//The cells around the start are waited for, as a game would behind a loading screen
+		timer.Tick();
+		partition.Update(GetFocus(0, frames));
+		while (!partition.IsSettled()) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			partition.Update(GetFocus(0, frames));
+		}
+		timer.Tick();
+		firstLoadTime = timer.GetTimeDeltaSeconds();
+		partition.SetBuildsPerUpdate(2);
+		int firstLoads = partition.GetLoadCount();
+
+		for (int i = 0; i < frames; ++i) {
+			timer.Tick();
+			partition.Update(GetFocus(i, frames));
+			timer.Tick();
+			double update = timer.GetTimeDeltaSeconds();
+			physics.Update(frameTime);
+			timer.Tick();
+			double frame = update + timer.GetTimeDeltaSeconds();
+			FrameArena::EndFrame();
+
+			updateTime	+= update;
+			streamTime	+= frame;
+			worstFrame	= std::max(worstFrame, frame);
+
+			size_t active = partition.GetActiveObjectCount();
+			mostObjects = std::max(mostObjects, active);
+			if (world.GetGameObjects().size() != active || world.GetPhysicsObjects().Size() != active) {
+				matched = false;
+			}
+		}
+		loads = partition.GetLoadCount() - firstLoads;
+		partition.Clear();
+		matched &= world.GetGameObjects().empty() && world.GetPhysicsObjects().Size() == 0;
+	}
+	world.ClearAndErase();
+	for (int x = 0; x < mapCells; ++x) {
+		for (int z = 0; z < mapCells; ++z) {
+			std::remove(WorldPartition::GetCellFilename(cellPrefix, x - mapCells / 2, z - mapCells / 2).c_str());
+		}
+	}
+
+	double fullFrame	= fullTime * 1000.0 / frames;
+	double streamFrame	= streamTime * 1000.0 / frames;
+	if (csv) {
+		std::cout << numBodies << "," << mapObjects << "," << cellCount << "," << mostObjects << "," << loads << ","
+			<< saveTime * 1000.0 << "," << firstLoadTime * 1000.0 << "," << fullFrame << "," << streamFrame << ","
+			<< updateTime * 1000.0 / frames << "," << worstFrame * 1000.0 << "," << (matched ? 1 : 0) << "\n";
+		return matched;
+	}
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "Streaming " << mapObjects << " objects in " << cellCount << " cells of " << cellSize << " units\n";
+	std::cout << "\tSave cells          " << saveTime * 1000.0 << " ms\n";
+	std::cout << "\tFirst cells in      " << firstLoadTime * 1000.0 << " ms\n";
+	std::cout << "\tWhole map           " << fullFrame << " ms a frame\n";
+	std::cout << "\tStreamed            " << streamFrame << " ms a frame (" << updateTime * 1000.0 / frames
+		<< " ms streaming, worst frame " << worstFrame * 1000.0 << " ms)\n";
+	std::cout << "\tMost objects in the world at once " << mostObjects << ", " << loads << " cells loaded on the way\n";
+	if (cellCount <= 0) {
+		std::cout << "\tCouldn't save the cells\n";
+	}
+	else if (!matched) {
+		std::cout << "\tThe world didn't hold just the active cells' objects\n";
+	}
+	return matched;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Lays out a map much bigger than anything the camera could see at
+		once - a grid of floor tiles with spheres resting on them - and saves
+		it as WorldPartition cells. A focus point is then moved across the map
+		while the physics is stepped, with only the cells near it streamed in,
+		and each frame is timed against stepping the whole map at once.
+
+		Every frame it checks that the world holds exactly the objects of the
+		active cells, and nothing from any other.
+		*/
+		class StreamingCheck {
+		public:
+			//Returns false if the world ever held objects it shouldn't have
+			static bool Run(int numBodies, int frames, float frameTime, bool csv);
+
+		private:
+			StreamingCheck()	{}
+			~StreamingCheck()	{}
+		};
+	}
+}
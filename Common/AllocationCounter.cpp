@@ -0,0 +1,67 @@
+#include "AllocationCounter.h"
+
+#ifdef NCL_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+	std::atomic<size_t> allocations(0);
+	std::atomic<size_t> allocatedBytes(0);
+
+	void* CountedAllocate(size_t size) {
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		void* memory = malloc(size ? size : 1);
+		if (!memory) {
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+}
+
+void* operator new(size_t size) {
+	return CountedAllocate(size);
+}
+void* operator new[](size_t size) {
+	return CountedAllocate(size);
+}
+void operator delete(void* memory) noexcept {
+	free(memory);
+}
+void operator delete[](void* memory) noexcept {
+	free(memory);
+}
+void operator delete(void* memory, size_t) noexcept {
+	free(memory);
+}
+void operator delete[](void* memory, size_t) noexcept {
+	free(memory);
+}
+#endif
+
+using namespace NCL;
+
+bool AllocationCounter::IsCounting() {
+#ifdef NCL_COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+size_t AllocationCounter::GetAllocations() {
+#ifdef NCL_COUNT_ALLOCATIONS
+	return allocations.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
+
+size_t AllocationCounter::GetAllocatedBytes() {
+#ifdef NCL_COUNT_ALLOCATIONS
+	return allocatedBytes.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
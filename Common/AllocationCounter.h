@@ -0,0 +1,33 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include <cstddef>
+
+namespace NCL {
+	/*
+	Counts every allocation made through the global operator new, on every
+	thread, to check that code that's meant not to touch the heap doesn't.
+
+	The counting operator new and delete are only built with
+	NCL_COUNT_ALLOCATIONS defined - without it IsCounting returns false, and
+	the counts stay at 0.
+	*/
+	class AllocationCounter {
+	public:
+		static bool IsCounting();
+
+		//Totals since the program started
+		static size_t GetAllocations();
+		static size_t GetAllocatedBytes();
+
+	protected:
+		AllocationCounter() {}
+		~AllocationCounter() {}
+	};
+}
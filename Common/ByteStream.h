@@ -0,0 +1,98 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Quaternion.h"
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace NCL {
+	using namespace NCL::Maths;
+
+	/*
+	For saving things as blocks of bytes - values go one after the other,
+	with no padding, in the machine's own byte order, so they're only for
+	reading back on the same kind of machine. Anything trivially copyable is
+	copied whole. The maths types have user-declared destructors, so aren't
+	trivially copyable, and go through their float arrays instead.
+	*/
+	class ByteWriter {
+	public:
+		ByteWriter(std::vector<char>& out) : out(out) {}
+
+		template<typename T>
+		void Write(const T& v) {
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be copied whole");
+			WriteBytes(&v, sizeof(T));
+		}
+
+		void Write(const Vector2& v)	{ Write(v.array); }
+		void Write(const Vector3& v)	{ Write(v.array); }
+		void Write(const Vector4& v)	{ Write(v.array); }
+		void Write(const Quaternion& q)	{ Write(q.array); }
+
+		void WriteBytes(const void* data, size_t size) {
+			const char* bytes = (const char*)data;
+			out.insert(out.end(), bytes, bytes + size);
+		}
+
+		//Where the next value will go, for filling in later with Overwrite
+		size_t GetOffset() const {
+			return out.size();
+		}
+
+		template<typename T>
+		void Overwrite(size_t offset, const T& v) {
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be copied whole");
+			memcpy(&out[offset], &v, sizeof(T));
+		}
+
+	protected:
+		std::vector<char>& out;
+	};
+
+	class ByteReader {
+	public:
+		ByteReader(const char* data, size_t size) : next(data), end(data + size) {}
+
+		//False, and v is left alone, if there aren't enough bytes left
+		template<typename T>
+		bool Read(T& v) {
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be copied whole");
+			return ReadBytes(&v, sizeof(T));
+		}
+
+		bool Read(Vector2& v)		{ return Read(v.array); }
+		bool Read(Vector3& v)		{ return Read(v.array); }
+		bool Read(Vector4& v)		{ return Read(v.array); }
+		bool Read(Quaternion& q)	{ return Read(q.array); }
+
+		bool ReadBytes(void* data, size_t size) {
+			if (GetRemaining() < size) {
+				return false;
+			}
+			if (size > 0) {
+				memcpy(data, next, size);
+				next += size;
+			}
+			return true;
+		}
+
+		size_t GetRemaining() const {
+			return (size_t)(end - next);
+		}
+
+	protected:
+		const char* next;
+		const char* end;
+	};
+}
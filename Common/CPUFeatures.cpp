@@ -0,0 +1,128 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#include "CPUFeatures.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(NCL_CPU_X86)
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+using namespace NCL;
+using namespace NCL::Maths;
+
+namespace {
+	const char* levelNames[] = { "scalar", "sse2", "sse4", "avx2", "avx512" };
+
+#if defined(NCL_CPU_X86)
+	void CPUID(unsigned int leaf, unsigned int subLeaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+		__cpuidex((int*)regs, (int)leaf, (int)subLeaf);
+#else
+		__cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+	}
+
+	//Which register sets the OS saves on a context switch - the CPU having
+	//AVX isn't enough, if the OS would trash the upper halves of the registers
+	unsigned long long GetEnabledRegisterState() {
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		unsigned int eax;
+		unsigned int edx;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((unsigned long long)edx << 32) | eax;
+#endif
+	}
+#endif
+}
+
+SIMD::Level SIMD::DetectLevel() {
+#if defined(NCL_CPU_X86)
+	unsigned int regs[4];
+	CPUID(0, 0, regs);
+	const unsigned int maxLeaf = regs[0];
+
+	CPUID(1, 0, regs);
+	const bool sse2		= (regs[3] & (1u << 26)) != 0;
+	const bool sse41	= (regs[2] & (1u << 19)) != 0;
+	const bool osxsave	= (regs[2] & (1u << 27)) != 0;
+	const bool avx		= (regs[2] & (1u << 28)) != 0;
+	const bool fma		= (regs[2] & (1u << 12)) != 0;
+
+	if (!sse2) {
+		return Level::Scalar;
+	}
+	if (!sse41) {
+		return Level::SSE2;
+	}
+	if (!osxsave || !avx || !fma || maxLeaf < 7) {
+		return Level::SSE41;
+	}
+	const unsigned long long state = GetEnabledRegisterState();
+	if ((state & 0x6) != 0x6) {	//SSE and AVX state
+		return Level::SSE41;
+	}
+	CPUID(7, 0, regs);
+	const bool avx2		= (regs[1] & (1u << 5)) != 0;
+	const bool avx512f	= (regs[1] & (1u << 16)) != 0;
+
+	if (!avx2) {
+		return Level::SSE41;
+	}
+	if (!avx512f || (state & 0xE6) != 0xE6) {	//plus the mask and upper ZMM state
+		return Level::AVX2;
+	}
+	return Level::AVX512;
+#else
+	return Level::Scalar;
+#endif
+}
+
+SIMD::Level SIMD::GetStartupLevel() {
+	Level detected = DetectLevel();
+
+	const char* env = getenv("NCL_SIMD_LEVEL");
+	if (!env || !*env) {
+		return detected;
+	}
+	Level requested;
+	if (!GetLevelFromName(env, requested)) {
+		std::cout << "NCL_SIMD_LEVEL " << env << " isn't one of scalar, sse2, sse4, avx2 or avx512, using " << GetLevelName(detected) << "\n";
+		return detected;
+	}
+	if (requested > detected) {
+		std::cout << "NCL_SIMD_LEVEL " << env << " isn't supported by this CPU, using " << GetLevelName(detected) << "\n";
+		return detected;
+	}
+	return requested;
+}
+
+const char* SIMD::GetLevelName(Level level) {
+	if (level < Level::Scalar || level >= Level::MAX_LEVELS) {
+		return "unknown";
+	}
+	return levelNames[(int)level];
+}
+
+bool SIMD::GetLevelFromName(const char* name, Level& level) {
+	for (int i = 0; i < (int)Level::MAX_LEVELS; ++i) {
+		if (strcmp(name, levelNames[i]) == 0) {
+			level = (Level)i;
+			return true;
+		}
+	}
+	return false;
+}
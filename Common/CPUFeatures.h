@@ -0,0 +1,49 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define NCL_CPU_X86
+#endif
+
+namespace NCL {
+	namespace Maths {
+		namespace SIMD {
+			/*
+			The instruction sets the SIMDKernels functions have versions for, from
+			oldest to newest. Unlike the compile time choice in SIMD.h, these are
+			picked when the program starts, from what the CPU it's running on says
+			it can do - so a build made for SSE2 can still use AVX2 for its
+			heaviest loops, without crashing on machines that don't have it.
+			*/
+			enum class Level {
+				Scalar,
+				SSE2,
+				SSE41,
+				AVX2,
+				AVX512,
+				MAX_LEVELS
+			};
+
+			//The best level this CPU (and OS) supports
+			Level DetectLevel();
+
+			/*
+			The level the kernels should use - the detected one, unless the
+			NCL_SIMD_LEVEL environment variable asks for a lower one (scalar, sse2,
+			sse4, avx2 or avx512), for comparing them in benchmarks. Asking for a
+			higher level than the CPU has just gets the detected one.
+			*/
+			Level GetStartupLevel();
+
+			const char* GetLevelName(Level level);
+			bool		GetLevelFromName(const char* name, Level& level);
+		}
+	}
+}
@@ -0,0 +1,156 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+using namespace NCL;
+
+std::atomic<unsigned int>	FrameArena::frameNumber(0);
+size_t						FrameArena::initialSize = 256 * 1024;
+
+namespace {
+	struct ArenaBlock {
+		char*	data;
+		size_t	size;
+	};
+
+	/*
+	Allocations come out of the last block, and a new one twice the size gets
+	added whenever it runs out. When the half is next reused, the blocks are
+	swapped for a single one big enough to hold them all, so a half only ever
+	grows for the first few frames, until it's big enough for a whole frame.
+	*/
+	struct ArenaHalf {
+		std::vector<ArenaBlock>		blocks;
+		size_t						used = 0;	//How far into the last block we are
+		std::atomic<size_t>			allocated;	//Everything handed out this frame
+		std::atomic<unsigned int>	frame;		//The frame it was last used in
+	};
+
+	struct ThreadArena {
+		ArenaHalf			halves[2];
+		std::atomic<bool>	inUse;
+	};
+
+	std::mutex									arenasLock;
+	std::vector<ThreadArena*>					arenas;	//Never freed, same as the blocks
+	std::atomic<size_t>							capacity(0);
+
+	//Hands the arena back when its thread finishes, for the next new thread to use.
+	//Neither the arenas nor their blocks are ever freed, as containers in other
+	//statics might still be pointing at them when the program ends, and worker
+	//threads can still be finishing while the statics are being destroyed
+	struct ThreadArenaHandle {
+		ThreadArena* arena = nullptr;
+		~ThreadArenaHandle() {
+			if (arena) {
+				arena->inUse = false;
+			}
+		}
+	};
+	thread_local ThreadArenaHandle threadArena;
+
+	ThreadArena* GetThreadArena() {
+		if (threadArena.arena) {
+			return threadArena.arena;
+		}
+		std::lock_guard<std::mutex> lock(arenasLock);
+		ThreadArena* a = nullptr;
+		for (auto& i : arenas) {
+			if (!i->inUse) {
+				a = i;
+				break;
+			}
+		}
+		if (!a) {
+			a = new ThreadArena();
+			for (ArenaHalf& h : a->halves) {
+				h.allocated	= 0;
+				h.frame		= FrameArena::GetFrameNumber();
+			}
+			arenas.emplace_back(a);
+		}
+		a->inUse = true;
+		threadArena.arena = a;
+		return a;
+	}
+
+	void AddBlock(ArenaHalf& h, size_t size) {
+		h.blocks.push_back({ new char[size], size });
+		h.used = 0;
+		capacity += size;
+	}
+
+	void ResetHalf(ArenaHalf& h, unsigned int frame) {
+		if (h.blocks.size() > 1) {
+			size_t total = 0;
+			for (ArenaBlock& b : h.blocks) {
+				total += b.size;
+				delete[] b.data;
+			}
+			capacity -= total;
+			h.blocks.clear();
+			AddBlock(h, total);
+		}
+		h.used		= 0;
+		h.allocated	= 0;
+		h.frame		= frame;
+	}
+
+	void* AllocateFromBlock(ArenaHalf& h, size_t bytes, size_t alignment) {
+		ArenaBlock& b = h.blocks.back();
+		uintptr_t start		= (uintptr_t)(b.data + h.used);
+		uintptr_t aligned	= (start + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		size_t offset		= (size_t)(aligned - (uintptr_t)b.data);
+		if (offset + bytes > b.size) {
+			return nullptr;
+		}
+		h.used = offset + bytes;
+		return (void*)aligned;
+	}
+}
+
+void FrameArena::EndFrame() {
+	frameNumber.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*
+Each thread works out for itself that its half for this frame was last used
+two (or more) frames ago, and resets it - that way EndFrame doesn't need to
+go near the other threads' arenas.
+*/
+void* FrameArena::Allocate(size_t bytes, size_t alignment) {
+	if (bytes == 0) {
+		bytes = 1;
+	}
+	const unsigned int frame = GetFrameNumber();
+	ArenaHalf& h = GetThreadArena()->halves[frame & 1];
+	if (h.frame.load(std::memory_order_relaxed) != frame) {
+		ResetHalf(h, frame);
+	}
+	void* memory = h.blocks.empty() ? nullptr : AllocateFromBlock(h, bytes, alignment);
+	if (!memory) {
+		size_t size = h.blocks.empty() ? initialSize : h.blocks.back().size * 2;
+		AddBlock(h, std::max(size, bytes + alignment));
+		memory = AllocateFromBlock(h, bytes, alignment);
+	}
+	h.allocated.fetch_add(bytes, std::memory_order_relaxed);
+	return memory;
+}
+
+size_t FrameArena::GetFrameBytes() {
+	const unsigned int frame = GetFrameNumber();
+	size_t total = 0;
+	std::lock_guard<std::mutex> lock(arenasLock);
+	for (auto& a : arenas) {
+		const ArenaHalf& h = a->halves[frame & 1];
+		if (h.frame.load(std::memory_order_relaxed) == frame) {
+			total += h.allocated.load(std::memory_order_relaxed);
+		}
+	}
+	return total;
+}
+
+size_t FrameArena::GetCapacity() {
+	return capacity.load(std::memory_order_relaxed);
+}
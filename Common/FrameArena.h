@@ -0,0 +1,135 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace NCL {
+	/*
+	Memory for things that only have to last a frame or so - lists of what to
+	draw, debug text and the like. Allocating is just moving a pointer along,
+	and nothing is ever freed on its own: the whole lot is reused two frames
+	later instead, so once the arena has grown to fit a frame's worth of
+	data, the heap doesn't get touched at all.
+
+	There are two halves, swapped over by EndFrame, so anything allocated is
+	good until the end of the next frame, not just this one. Each thread has
+	its own pair of halves, so jobs can allocate without any locking.
+
+	Containers using FrameAllocator mustn't be kept from one frame to the next
+	- even an empty one can still be pointing into the arena. Class members
+	should be wrapped in a FrameLocal instead, which starts a new one each frame.
+	*/
+	class FrameArena {
+	public:
+		//Called once a frame, on the main thread, with no jobs running
+		static void EndFrame();
+
+		static void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		static T* Allocate(size_t count) {
+			return (T*)Allocate(count * sizeof(T), alignof(T));
+		}
+
+		static unsigned int GetFrameNumber() {
+			return frameNumber.load(std::memory_order_relaxed);
+		}
+
+		//Bytes handed out on all threads since the last EndFrame
+		static size_t GetFrameBytes();
+		//Bytes the arenas are holding on to, on all threads
+		static size_t GetCapacity();
+
+		//How big the first block of a new thread's arena is - they grow to fit
+		static void SetInitialSize(size_t bytes) {
+			initialSize = bytes;
+		}
+
+	protected:
+		FrameArena() {}
+		~FrameArena() {}
+
+		static std::atomic<unsigned int>	frameNumber;
+		static size_t						initialSize;
+	};
+
+	//Lets the standard containers use the frame arena, see the typedefs below
+	template<typename T>
+	class FrameAllocator {
+	public:
+		typedef T value_type;
+
+		FrameAllocator() noexcept {}
+		template<typename U>
+		FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+		T* allocate(size_t count) {
+			return FrameArena::Allocate<T>(count);
+		}
+		void deallocate(T*, size_t) noexcept {
+			//Nothing to do - it all goes at once, two frames from now
+		}
+	};
+
+	template<typename T, typename U>
+	bool operator==(const FrameAllocator<T>&, const FrameAllocator<U>&) noexcept {
+		return true;
+	}
+	template<typename T, typename U>
+	bool operator!=(const FrameAllocator<T>&, const FrameAllocator<U>&) noexcept {
+		return false;
+	}
+
+	template<typename T>
+	using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+	template<typename T, typename Compare = std::less<T>>
+	using FrameSet = std::set<T, Compare, FrameAllocator<T>>;
+
+	typedef std::basic_string<char, std::char_traits<char>, FrameAllocator<char>> FrameString;
+
+	/*
+	Holds a container that uses the frame arena, so that it can be kept as a
+	class member. The first Get each frame makes a new, empty container, and
+	the last frame's is just forgotten about, rather than destroyed - its
+	memory went back to the arena along with everything else. That means
+	that what it holds must only ever own frame memory too.
+	*/
+	template<typename C>
+	class FrameLocal {
+	public:
+		FrameLocal() : frame(0), made(false) {}
+		~FrameLocal() {}
+
+		C& Get() {
+			const unsigned int now = FrameArena::GetFrameNumber();
+			if (!made || frame != now) {
+				new (&storage) C();
+				frame	= now;
+				made	= true;
+			}
+			return *reinterpret_cast<C*>(&storage);
+		}
+
+	protected:
+		FrameLocal(const FrameLocal&) = delete;
+		FrameLocal& operator=(const FrameLocal&) = delete;
+
+		typename std::aligned_storage<sizeof(C), alignof(C)>::type storage;
+		unsigned int	frame;
+		bool			made;
+	};
+}
@@ -11,13 +11,14 @@ https://research.ncl.ac.uk/game/
 using namespace NCL;
 
 GameTimer::GameTimer(void) {
+	fixedDelta = 0.0f;
 	firstPoint = std::chrono::high_resolution_clock::now();
 	nowPoint = firstPoint;
 	Tick();
 }
 
 double	GameTimer::GetTotalTimeSeconds()	const {
-	Timepoint time = std::chrono::high_resolution_clock::now();
+	Timepoint time = fixedDelta > 0.0f ? nowPoint : std::chrono::high_resolution_clock::now();
 
 	std::chrono::duration<double> diff = time - firstPoint;
 
@@ -25,7 +26,7 @@ double	GameTimer::GetTotalTimeSeconds()	const {
 };
 
 double	GameTimer::GetTotalTimeMSec()		const {
-	Timepoint time = std::chrono::high_resolution_clock::now();
+	Timepoint time = fixedDelta > 0.0f ? nowPoint : std::chrono::high_resolution_clock::now();
 
 	std::chrono::duration<double, std::milli> diff = time - firstPoint;
 
@@ -33,6 +34,11 @@ double	GameTimer::GetTotalTimeMSec()		const {
 }
 
 void	GameTimer::Tick() {
+	if (fixedDelta > 0.0f) {
+		nowPoint += std::chrono::duration_cast<Timepoint::duration>(std::chrono::duration<float>(fixedDelta));
+		timeDelta = fixedDelta;
+		return;
+	}
 	Timepoint latestTime = std::chrono::high_resolution_clock::now();
 
 	std::chrono::duration<float> diff = latestTime - nowPoint;
@@ -25,8 +25,15 @@ namespace NCL {
 		float	GetTimeDeltaMSec()		const { return timeDelta * 1000.0f; };
 
 		void	Tick();
+
+		//Makes every Tick move the timer on by exactly this many seconds, rather
+		//than however long it's really been - 0 goes back to the real time
+		void	SetFixedTimeDelta(float seconds) {
+			fixedDelta = seconds;
+		}
 	protected:
 		float		timeDelta;
+		float		fixedDelta;
 		Timepoint	firstPoint;
 		Timepoint	nowPoint;
 	};
@@ -0,0 +1,218 @@
+#include "InputRecording.h"
+#include "ByteStream.h"
+#include <cstring>
+#include <fstream>
+
+using namespace NCL;
+
+namespace {
+	const uint32_t recordingMagic	= 0x52434e49; //"INCR"
+	const uint32_t recordingVersion	= 1;
+
+	struct RecordingHeader {
+		uint32_t	magic;
+		uint32_t	version;
+		uint32_t	frameCount;
+		uint32_t	seed;
+		int32_t		options;
+		uint32_t	dataSize;
+	};
+
+	//Which of the mouse's values are in a frame
+	const uint8_t relativeChanged	= 1;
+	const uint8_t absoluteChanged	= 2;
+	const uint8_t wheelChanged		= 4;
+
+	//Each changed key or button is a code and a set of these
+	const uint8_t changeDown		= 1;
+	const uint8_t changeHeld		= 2;
+	const uint8_t changeDoubleClick	= 4;
+	const uint8_t changeIsButton	= 128;
+
+	bool SameVector(const Vector2& a, const Vector2& b) {
+		return memcmp(a.array, b.array, sizeof(float) * 2) == 0;
+	}
+}
+
+InputRecording::FrameState::FrameState() {
+	timeStep = 0.0f;
+	memset(keys,			0, sizeof(keys));
+	memset(heldKeys,		0, sizeof(heldKeys));
+	memset(buttons,			0, sizeof(buttons));
+	memset(heldButtons,		0, sizeof(heldButtons));
+	memset(doubleClicks,	0, sizeof(doubleClicks));
+	wheel = 0;
+}
+
+InputRecording::InputRecording() {
+	frameCount	= 0;
+	seed		= 0;
+	options		= 0;
+}
+
+void InputRecording::Clear() {
+	data.clear();
+	lastFrame	= FrameState();
+	frameCount	= 0;
+}
+
+void InputRecording::CaptureFrame(float timeStep, const Keyboard& keyboard, const Mouse& mouse, FrameState& state) {
+	state.timeStep = timeStep;
+	memcpy(state.keys,			keyboard.keyStates,		sizeof(state.keys));
+	memcpy(state.heldKeys,		keyboard.holdStates,	sizeof(state.heldKeys));
+	memcpy(state.buttons,		mouse.buttons,			sizeof(state.buttons));
+	memcpy(state.heldButtons,	mouse.holdButtons,		sizeof(state.heldButtons));
+	memcpy(state.doubleClicks,	mouse.doubleClicks,		sizeof(state.doubleClicks));
+	state.relativePosition = mouse.relativePosition;
+	state.absolutePosition = mouse.absolutePosition;
+	state.wheel = mouse.frameWheel;
+}
+
+void InputRecording::ApplyFrame(const FrameState& state, Keyboard& keyboard, Mouse& mouse) {
+	memcpy(keyboard.keyStates,	state.keys,			sizeof(state.keys));
+	memcpy(keyboard.holdStates,	state.heldKeys,		sizeof(state.heldKeys));
+	memcpy(mouse.buttons,		state.buttons,		sizeof(state.buttons));
+	memcpy(mouse.holdButtons,	state.heldButtons,	sizeof(state.heldButtons));
+	memcpy(mouse.doubleClicks,	state.doubleClicks,	sizeof(state.doubleClicks));
+	mouse.relativePosition = state.relativePosition;
+	mouse.absolutePosition = state.absolutePosition;
+	mouse.frameWheel = state.wheel;
+}
+
+/*
+A frame is its time step, which of the mouse's values changed, how many keys
+and buttons changed, each of those changes, and then the mouse values.
+*/
+void InputRecording::RecordFrame(float timeStep, const Keyboard& keyboard, const Mouse& mouse) {
+	FrameState frame;
+	CaptureFrame(timeStep, keyboard, mouse, frame);
+
+	uint8_t mouseFlags = 0;
+	mouseFlags |= SameVector(frame.relativePosition, lastFrame.relativePosition) ? 0 : relativeChanged;
+	mouseFlags |= SameVector(frame.absolutePosition, lastFrame.absolutePosition) ? 0 : absoluteChanged;
+	mouseFlags |= (frame.wheel == lastFrame.wheel) ? 0 : wheelChanged;
+
+	ByteWriter writer(data);
+	writer.Write(frame.timeStep);
+	writer.Write(mouseFlags);
+
+	size_t countOffset = writer.GetOffset();
+	uint16_t changeCount = 0;
+	writer.Write(changeCount);
+
+	for (int i = 0; i < (int)KeyboardKeys::MAXVALUE; ++i) {
+		if (frame.keys[i] != lastFrame.keys[i] || frame.heldKeys[i] != lastFrame.heldKeys[i]) {
+			writer.Write((uint8_t)i);
+			writer.Write((uint8_t)((frame.keys[i] ? changeDown : 0) | (frame.heldKeys[i] ? changeHeld : 0)));
+			changeCount++;
+		}
+	}
+	for (int i = 0; i < (int)MouseButtons::MAXVAL; ++i) {
+		if (frame.buttons[i] != lastFrame.buttons[i] || frame.heldButtons[i] != lastFrame.heldButtons[i] ||
+			frame.doubleClicks[i] != lastFrame.doubleClicks[i]) {
+			writer.Write((uint8_t)i);
+			writer.Write((uint8_t)(changeIsButton | (frame.buttons[i] ? changeDown : 0) |
+				(frame.heldButtons[i] ? changeHeld : 0) | (frame.doubleClicks[i] ? changeDoubleClick : 0)));
+			changeCount++;
+		}
+	}
+	writer.Overwrite(countOffset, changeCount);
+
+	if (mouseFlags & relativeChanged) {
+		writer.Write(frame.relativePosition);
+	}
+	if (mouseFlags & absoluteChanged) {
+		writer.Write(frame.absolutePosition);
+	}
+	if (mouseFlags & wheelChanged) {
+		writer.Write((int32_t)frame.wheel);
+	}
+	lastFrame = frame;
+	frameCount++;
+}
+
+bool InputRecording::ReadFrame(size_t& offset, FrameState& state) const {
+	ByteReader	reader(data.data() + offset, data.size() - offset);
+	uint8_t		mouseFlags;
+	uint16_t	changeCount;
+	if (!reader.Read(state.timeStep) || !reader.Read(mouseFlags) || !reader.Read(changeCount)) {
+		return false;
+	}
+	for (uint16_t i = 0; i < changeCount; ++i) {
+		uint8_t code;
+		uint8_t change;
+		if (!reader.Read(code) || !reader.Read(change)) {
+			return false;
+		}
+		if (change & changeIsButton) {
+			if (code >= (int)MouseButtons::MAXVAL) {
+				return false;
+			}
+			state.buttons[code]			= (change & changeDown) != 0;
+			state.heldButtons[code]		= (change & changeHeld) != 0;
+			state.doubleClicks[code]	= (change & changeDoubleClick) != 0;
+		}
+		else {
+			if (code >= (int)KeyboardKeys::MAXVALUE) {
+				return false;
+			}
+			state.keys[code]		= (change & changeDown) != 0;
+			state.heldKeys[code]	= (change & changeHeld) != 0;
+		}
+	}
+	if ((mouseFlags & relativeChanged) && !reader.Read(state.relativePosition)) {
+		return false;
+	}
+	if ((mouseFlags & absoluteChanged) && !reader.Read(state.absolutePosition)) {
+		return false;
+	}
+	if (mouseFlags & wheelChanged) {
+		int32_t wheel;
+		if (!reader.Read(wheel)) {
+			return false;
+		}
+		state.wheel = wheel;
+	}
+	offset = data.size() - reader.GetRemaining();
+	return true;
+}
+
+bool InputRecording::Save(const std::string& filename) const {
+	std::ofstream file(filename, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	RecordingHeader header;
+	header.magic		= recordingMagic;
+	header.version		= recordingVersion;
+	header.frameCount	= (uint32_t)frameCount;
+	header.seed			= seed;
+	header.options		= options;
+	header.dataSize		= (uint32_t)data.size();
+
+	file.write((const char*)&header, sizeof(header));
+	file.write(data.data(), data.size());
+	return file.good();
+}
+
+bool InputRecording::Load(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	RecordingHeader header;
+	if (!file.read((char*)&header, sizeof(header)) ||
+		header.magic != recordingMagic || header.version != recordingVersion) {
+		return false;
+	}
+	Clear();
+	data.resize(header.dataSize);
+	if (!file.read(data.data(), data.size())) {
+		Clear();
+		return false;
+	}
+	frameCount	= (int)header.frameCount;
+	seed		= header.seed;
+	options		= header.options;
+	return true;
+}
@@ -0,0 +1,96 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include "Keyboard.h"
+#include "Mouse.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NCL {
+	/*
+	A frame by frame log of the keyboard and mouse, along with each frame's
+	time step, so that a session can be played back exactly - NullWindow can
+	play one back in place of a real keyboard and mouse.
+
+	Each frame only stores what changed since the one before, so a frame
+	where nothing is touched is just its time step and a couple of bytes.
+	Whatever the game needs to start off the same way (the rand seed, which
+	game mode) goes in the seed and options, which are saved along with it.
+	*/
+	class InputRecording {
+	public:
+		//Everything the keyboard and mouse report in one frame
+		struct FrameState {
+			float	timeStep;
+			bool	keys[(int)KeyboardKeys::MAXVALUE];
+			bool	heldKeys[(int)KeyboardKeys::MAXVALUE];
+			bool	buttons[(int)MouseButtons::MAXVAL];
+			bool	heldButtons[(int)MouseButtons::MAXVAL];
+			bool	doubleClicks[(int)MouseButtons::MAXVAL];
+			Vector2	relativePosition;
+			Vector2	absolutePosition;
+			int		wheel;
+
+			FrameState();
+		};
+
+		InputRecording();
+		~InputRecording() {}
+
+		void Clear();
+
+		//Adds a frame, with the keyboard and mouse as they are right now
+		void RecordFrame(float timeStep, const Keyboard& keyboard, const Mouse& mouse);
+
+		int GetFrameCount() const {
+			return frameCount;
+		}
+
+		size_t GetByteSize() const {
+			return data.size();
+		}
+
+		/*
+		Playing back goes through the frames in order - start with a default
+		FrameState and an offset of 0, and each call moves both on a frame.
+		Returns false once there are no frames left.
+		*/
+		bool ReadFrame(size_t& offset, FrameState& state) const;
+
+		//Puts the keyboard and mouse into the state of a frame read back
+		static void ApplyFrame(const FrameState& state, Keyboard& keyboard, Mouse& mouse);
+
+		void SetSeed(uint32_t s) {
+			seed = s;
+		}
+		uint32_t GetSeed() const {
+			return seed;
+		}
+
+		void SetOptions(int32_t o) {
+			options = o;
+		}
+		int32_t GetOptions() const {
+			return options;
+		}
+
+		bool Save(const std::string& filename) const;
+		bool Load(const std::string& filename);
+
+	protected:
+		static void CaptureFrame(float timeStep, const Keyboard& keyboard, const Mouse& mouse, FrameState& state);
+
+		std::vector<char> data;
+		FrameState	lastFrame;	//What the next recorded frame is compared against
+		int			frameCount;
+		uint32_t	seed;
+		int32_t		options;
+	};
+}
@@ -0,0 +1,245 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+
+using namespace NCL;
+
+namespace {
+	struct JobQueue {
+		std::mutex		lock;
+		std::deque<Job>	jobs;
+	};
+
+	std::vector<std::unique_ptr<JobQueue>>	queues;		//One per thread, the main thread's first
+	std::vector<std::thread>				workers;
+	bool									initialised = false;
+
+	std::atomic<int>		queuedJobs(0);
+	std::atomic<int>		sleepingWorkers(0);
+	std::atomic<bool>		quitting(false);
+	std::mutex				sleepLock;
+	std::condition_variable	wakeUp;
+
+	thread_local int threadIndex = 0;
+
+	//Stops the workers before the rest of the above gets destroyed at exit
+	struct JobSystemShutdown {
+		~JobSystemShutdown() {
+			JobSystem::Shutdown();
+		}
+	} jobSystemShutdown;
+}
+
+void JobSystem::Initialise(int threadCount) {
+	Shutdown();
+
+	if (threadCount < 1) {
+		threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+	}
+	quitting = false;
+
+	for (int i = 0; i < threadCount; ++i) {
+		queues.emplace_back(new JobQueue());
+	}
+	initialised = true;
+
+	for (int i = 1; i < threadCount; ++i) {
+		workers.emplace_back(WorkerLoop, i);
+	}
+}
+
+void JobSystem::Shutdown() {
+	if (!initialised) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepLock);
+		quitting = true;
+	}
+	wakeUp.notify_all();
+
+	for (std::thread& t : workers) {
+		t.join();
+	}
+	workers.clear();
+
+	//Workers only stop once there's nothing left to steal, but anything queued
+	//after that still gets run, so that nobody waiting on it gets stuck
+	Job job;
+	while (GetJob(job)) {
+		ExecuteJob(job);
+	}
+	queues.clear();
+	initialised = false;
+}
+
+int JobSystem::GetThreadCount() {
+	if (!initialised) {
+		Initialise();
+	}
+	return (int)queues.size();
+}
+
+int JobSystem::GetThreadIndex() {
+	return threadIndex;
+}
+
+void JobSystem::WorkerLoop(int index) {
+	threadIndex = index;
+
+	Job job;
+	while (true) {
+		if (GetJob(job)) {
+			ExecuteJob(job);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleepLock);
+		if (quitting) {
+			break;
+		}
+		sleepingWorkers++;
+		wakeUp.wait(lock, [] { return queuedJobs > 0 || quitting; });
+		sleepingWorkers--;
+	}
+}
+
+/*
+A thread's own jobs come off the end of its queue, as they're the most
+recently made, and probably still in the cache. Anything stolen comes off
+the front, which is usually the biggest chunk of work left.
+*/
+bool JobSystem::GetJob(Job& job) {
+	const int count = (int)queues.size();
+	if (count == 0) {
+		return false;
+	}
+	const int self = threadIndex < count ? threadIndex : 0;
+	{
+		JobQueue& q = *queues[self];
+		std::lock_guard<std::mutex> lock(q.lock);
+		if (!q.jobs.empty()) {
+			job = std::move(q.jobs.back());
+			q.jobs.pop_back();
+			queuedJobs--;
+			return true;
+		}
+	}
+	for (int i = 1; i < count; ++i) {
+		JobQueue& q = *queues[(self + i) % count];
+		std::lock_guard<std::mutex> lock(q.lock);
+		if (!q.jobs.empty()) {
+			job = std::move(q.jobs.front());
+			q.jobs.pop_front();
+			queuedJobs--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::PushJob(Job&& job) {
+	if (!initialised) {
+		Initialise();
+	}
+	const int self = threadIndex < (int)queues.size() ? threadIndex : 0;
+	{
+		JobQueue& q = *queues[self];
+		std::lock_guard<std::mutex> lock(q.lock);
+		q.jobs.emplace_back(std::move(job));
+	}
+	//A worker going to sleep bumps sleepingWorkers before it checks queuedJobs,
+	//so one of the two of us is sure to see the other's change
+	queuedJobs++;
+	if (sleepingWorkers > 0) {
+		std::lock_guard<std::mutex> lock(sleepLock);
+		wakeUp.notify_one();
+	}
+}
+
+void JobSystem::ExecuteJob(Job& job) {
+	{
+		NCL_PROFILE_SCOPE("Job");
+		job.func();
+		job.func = nullptr;
+	}
+
+	JobCounter* counter = job.counter;
+	if (!counter) {
+		return;
+	}
+	std::vector<Job> released;
+	{
+		std::lock_guard<std::mutex> lock(counter->waitingLock);
+		if (--counter->count == 0) {
+			released.swap(counter->waiting);
+		}
+	}
+	for (Job& j : released) {
+		PushJob(std::move(j));
+	}
+}
+
+void JobSystem::Run(const JobFunc& func, JobCounter* counter, JobCounter* dependency) {
+	Job job;
+	job.func	= func;
+	job.counter	= counter;
+
+	if (counter) {
+		counter->count++;
+	}
+	if (dependency) {
+		std::lock_guard<std::mutex> lock(dependency->waitingLock);
+		if (dependency->count > 0) {
+			dependency->waiting.emplace_back(std::move(job));
+			return;
+		}
+	}
+	PushJob(std::move(job));
+}
+
+void JobSystem::ParallelFor(int start, int end, int grainSize, const JobRangeFunc& func,
+	JobCounter* counter, JobCounter* dependency) {
+	if (end <= start) {
+		return;
+	}
+	const int threadCount = GetThreadCount();
+	if (grainSize < 1) {
+		grainSize = std::max(1, (end - start) / (threadCount * 4));
+	}
+	if (!counter && !dependency && (threadCount == 1 || end - start <= grainSize)) {
+		func(start, end);
+		return;
+	}
+
+	JobCounter localCounter;
+	for (int i = start; i < end; i += grainSize) {
+		const int chunkEnd = std::min(end, i + grainSize);
+		if (counter) {
+			Run([func, i, chunkEnd]() { func(i, chunkEnd); }, counter, dependency);
+		}
+		else {
+			Run([&func, i, chunkEnd]() { func(i, chunkEnd); }, &localCounter, dependency);
+		}
+	}
+	if (!counter) {
+		Wait(localCounter);
+	}
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+	Job job;
+	while (!counter.IsDone()) {
+		if (GetJob(job)) {
+			ExecuteJob(job);
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+	//The job that finished the counter might still be letting go of its lock
+	std::lock_guard<std::mutex> lock(counter.waitingLock);
+}
@@ -0,0 +1,115 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace NCL {
+	typedef std::function<void()>			JobFunc;
+	typedef std::function<void(int, int)>	JobRangeFunc;
+
+	class JobCounter;
+
+	struct Job {
+		JobFunc		func;
+		JobCounter*	counter = nullptr;
+	};
+
+	/*
+	Counts how many jobs that were given it are still to finish. Jobs can also
+	be made to wait for a counter to reach 0 before they start, which is how
+	one lot of work is made to depend on another.
+
+	A counter must have been waited on (JobSystem::Wait) before it goes out of
+	scope, even if IsDone already says it has finished.
+	*/
+	class JobCounter {
+	public:
+		JobCounter() : count(0) {}
+		~JobCounter() {}
+
+		bool IsDone() const {
+			return count.load() == 0;
+		}
+
+	protected:
+		friend class JobSystem;
+
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		std::atomic<int>	count;
+		std::mutex			waitingLock;
+		std::vector<Job>	waiting;	//Jobs that start once count gets to 0
+	};
+
+	/*
+	A pool of worker threads shared by the whole engine. Each thread (including
+	the main one) has its own queue of jobs - new jobs go on the end of the
+	queue of whichever thread made them, and threads take their own work from
+	the end too, so related work tends to stay on the same core. Threads that
+	run out take ('steal') work from the front of the other queues.
+
+	Nothing ever blocks waiting for jobs to finish - Wait runs queued jobs
+	(anyone's) until the counter it's waiting on gets to 0, so the main thread
+	helps out rather than sitting idle, and jobs can wait on jobs of their own.
+
+	With only 1 thread there are no workers at all - ParallelFor just calls its
+	function directly, and Run's jobs are run by the next Wait.
+	*/
+	class JobSystem {
+	public:
+		//Starts threadCount - 1 workers (0 means one thread per core). This gets
+		//called with 0 the first time anything is run, if it hasn't been already.
+		//Should only be called from the main thread, with no jobs in flight
+		static void Initialise(int threadCount = 0);
+		static void Shutdown();
+
+		//How many threads jobs can run on, including the main thread
+		static int GetThreadCount();
+
+		//0 on the main thread, and 1 onwards on the workers
+		static int GetThreadIndex();
+
+		//Queues up a job. If a counter is given, it counts the job until it has
+		//finished, and if a dependency is given the job won't start until it gets to 0
+		static void Run(const JobFunc& func, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+		/*
+		Splits start to end into chunks of grainSize (or a few per thread, if
+		grainSize is 0), and calls func(chunkStart, chunkEnd) for each of them
+		as a job. Without a counter, it waits for them all to finish before it
+		returns - with one, it returns straight away, and func is copied for
+		the jobs to use.
+		*/
+		static void ParallelFor(int start, int end, int grainSize, const JobRangeFunc& func,
+			JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+		//As above, for when it waits - func is only referred to rather than
+		//copied into a std::function, which would need the heap for most lambdas
+		template<typename F>
+		static void ParallelFor(int start, int end, int grainSize, const F& func) {
+			ParallelFor(start, end, grainSize, JobRangeFunc(std::cref(func)), nullptr, nullptr);
+		}
+
+		//Runs jobs until the counter gets to 0
+		static void Wait(JobCounter& counter);
+
+	protected:
+		JobSystem() {}
+		~JobSystem() {}
+
+		static void WorkerLoop(int index);
+		static bool GetJob(Job& job);
+		static void PushJob(Job&& job);
+		static void ExecuteJob(Job& job);
+	};
+}
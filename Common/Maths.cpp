@@ -9,9 +9,146 @@ https://research.ncl.ac.uk/game/
 #include "Maths.h"
 #include "../Common/Vector2.h"
 #include "../Common/Vector3.h"
+#include <cmath>
 
 namespace NCL {
 	namespace Maths {
+#if defined(NCL_DETERMINISTIC)
+		/*
+		These follow the single precision versions in the Cephes maths library -
+		the input is folded down to a small range, and then a short polynomial
+		gets the answer for that range. Every step is written out in full, so
+		there's nothing left for the compiler to reorder.
+		*/
+		namespace {
+			const float FOUR_OVER_PI = 1.27323954473516f;
+
+			//pi / 4, split up so that y * each part is exact for small y
+			const float DP1 = 0.78515625f;
+			const float DP2 = 2.4187564849853515625e-4f;
+			const float DP3 = 3.77489497744594108e-8f;
+
+			//Brings a positive angle to within pi/4 of a multiple of pi/2,
+			//returning which multiple (in eighths of a turn)
+			int ReduceAngle(float x, float& reduced) {
+				int j = (int)(x * FOUR_OVER_PI);
+				j += (j & 1);
+				float y = (float)j;
+				reduced = ((x - y * DP1) - y * DP2) - y * DP3;
+				return j & 7;
+			}
+
+			float SinPolynomial(float x) {
+				float z = x * x;
+				return ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * x + x;
+			}
+
+			float CosPolynomial(float x) {
+				float z = x * x;
+				return ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+			}
+
+			float Atan(float x) {
+				float sign = 1.0f;
+				if (x < 0.0f) {
+					sign	= -1.0f;
+					x		= -x;
+				}
+				float y = 0.0f;
+				if (x > 2.414213562373095f) {	//tan(3pi/8)
+					y = PI * 0.5f;
+					x = -1.0f / x;
+				}
+				else if (x > 0.4142135623730950f) {	//tan(pi/8)
+					y = PI * 0.25f;
+					x = (x - 1.0f) / (x + 1.0f);
+				}
+				float z = x * x;
+				y += (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * x + x;
+				return sign * y;
+			}
+		}
+
+		float Sin(float rads) {
+			float sign = 1.0f;
+			if (rads < 0.0f) {
+				sign = -1.0f;
+				rads = -rads;
+			}
+			float x;
+			int j = ReduceAngle(rads, x);
+			if (j > 3) {
+				sign = -sign;
+				j -= 4;
+			}
+			return sign * (j == 2 ? CosPolynomial(x) : SinPolynomial(x));
+		}
+
+		float Cos(float rads) {
+			float sign = 1.0f;
+			float x;
+			int j = ReduceAngle(rads < 0.0f ? -rads : rads, x);
+			if (j > 3) {
+				sign = -sign;
+				j -= 4;
+			}
+			if (j > 1) {
+				sign = -sign;
+			}
+			return sign * (j == 2 ? SinPolynomial(x) : CosPolynomial(x));
+		}
+
+		float Tan(float rads) {
+			return Sin(rads) / Cos(rads);
+		}
+
+		float Atan2(float y, float x) {
+			if (x == 0.0f) {
+				if (y == 0.0f) {
+					return 0.0f;
+				}
+				return y > 0.0f ? PI * 0.5f : -PI * 0.5f;
+			}
+			float a = Atan(y / x);
+			if (x < 0.0f) {
+				a += (y < 0.0f) ? -PI : PI;
+			}
+			return a;
+		}
+
+		float Asin(float x) {
+			return Atan2(x, std::sqrt((1.0f - x) * (1.0f + x)));
+		}
+
+		float Acos(float x) {
+			return Atan2(std::sqrt((1.0f - x) * (1.0f + x)), x);
+		}
+#else
+		float Sin(float rads) {
+			return std::sin(rads);
+		}
+
+		float Cos(float rads) {
+			return std::cos(rads);
+		}
+
+		float Tan(float rads) {
+			return std::tan(rads);
+		}
+
+		float Asin(float x) {
+			return std::asin(x);
+		}
+
+		float Acos(float x) {
+			return std::acos(x);
+		}
+
+		float Atan2(float y, float x) {
+			return std::atan2(y, x);
+		}
+#endif
+
 		void ScreenBoxOfTri(const Vector3& v0, const Vector3& v1, const Vector3& v2, Vector2& topLeft, Vector2& bottomRight) {
 			topLeft.x = std::min(v0.x, std::min(v1.x, v2.x));
 			topLeft.y = std::min(v0.y, std::min(v1.y, v2.y));
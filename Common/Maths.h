@@ -30,6 +30,21 @@ namespace NCL {
 			return degs * PI / 180.0f;
 		};
 
+		/*
+		The trig functions the maths classes use. Normally these are just the C
+		runtime ones, but those aren't guaranteed to give the same answers on
+		different compilers or platforms, so with NCL_DETERMINISTIC defined (see
+		SIMD.h) they are built only from + - * / and sqrt instead, which always
+		round the same way. They're within a couple of bits of the C runtime ones,
+		for angles up to a few thousand radians.
+		*/
+		float Sin(float rads);
+		float Cos(float rads);
+		float Tan(float rads);
+		float Asin(float x);
+		float Acos(float x);
+		float Atan2(float y, float x);
+
 		template<class T>
 		inline T Clamp(T value, T min, T max) {
 			if (value < min) {
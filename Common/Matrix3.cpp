@@ -104,8 +104,8 @@ Matrix3 Matrix3::Rotation(float degrees, const Vector3 &inaxis)	 {
 
 	axis.Normalise();
 
-	float c = cos(Maths::DegreesToRadians(degrees));
-	float s = sin(Maths::DegreesToRadians(degrees));
+	float c = Maths::Cos(Maths::DegreesToRadians(degrees));
+	float s = Maths::Sin(Maths::DegreesToRadians(degrees));
 
 	m.array[0]  = (axis.x * axis.x) * (1.0f - c) + c;
 	m.array[1]  = (axis.y * axis.x) * (1.0f - c) + (axis.z * s);
@@ -155,16 +155,16 @@ Vector3 Matrix3::ToEuler() const {
 	float testVal = abs(array[2]) + 0.00001f;
 
 	if (testVal < 1.0f) {
-		float theta1 = -asin(array[2]);
+		float theta1 = -Maths::Asin(array[2]);
 		float theta2 = Maths::PI - theta1;
 
-		float cost1 = cos(theta1);
+		float cost1 = Maths::Cos(theta1);
 		//float cost2 = cos(theta2);
 
-		float psi1 = Maths::RadiansToDegrees(atan2(array[5] / cost1, array[8] / cost1));
+		float psi1 = Maths::RadiansToDegrees(Maths::Atan2(array[5] / cost1, array[8] / cost1));
 		//float psi2 = Maths::RadiansToDegrees(atan2(array[5] / cost2, array[8] / cost2));
 
-		float phi1 = Maths::RadiansToDegrees(atan2(array[1] / cost1, array[0] / cost1));
+		float phi1 = Maths::RadiansToDegrees(Maths::Atan2(array[1] / cost1, array[0] / cost1));
 		//float phi2 = Maths::RadiansToDegrees(atan2(array[1] / cost2, array[0] / cost2));
 
 		theta1 = Maths::RadiansToDegrees(theta1);
@@ -179,7 +179,7 @@ Vector3 Matrix3::ToEuler() const {
 		float theta = 0.0f;	//y
 		float psi	= 0.0f;	//z
 
-		float delta = atan2(array[3], array[6]);
+		float delta = Maths::Atan2(array[3], array[6]);
 
 		if (array[2] < 0.0f) {
 			theta = Maths::PI / 2.0f;
@@ -229,12 +229,12 @@ Matrix3 Matrix3::FromEuler(const Vector3 &euler) {
 	float attitude	= Maths::DegreesToRadians(euler.x);
 	float bank		= Maths::DegreesToRadians(euler.z);
 
-	float ch = cos(heading);
-	float sh = sin(heading);
-	float ca = cos(attitude);
-	float sa = sin(attitude);
-	float cb = cos(bank);
-	float sb = sin(bank);
+	float ch = Maths::Cos(heading);
+	float sh = Maths::Sin(heading);
+	float ca = Maths::Cos(attitude);
+	float sa = Maths::Sin(attitude);
+	float cb = Maths::Cos(bank);
+	float sb = Maths::Sin(bank);
 
 	m.array[0] = ch * ca;
 	m.array[3] = sh*sb - ch*sa*cb;
@@ -300,9 +300,16 @@ void	Matrix3::SetDiagonal(const Vector3 &in) {
 Vector3 Matrix3::operator*(const Vector3 &v) const {
 	Vector3 vec;
 
+#if defined(NCL_SIMD_SSE2)
+	__m128 col = _mm_mul_ps(SIMD::Load3(array), _mm_set1_ps(v.x));
+	col = SIMD::MulAdd(SIMD::Load3(array + 3), _mm_set1_ps(v.y), col);
+	col = SIMD::MulAdd(SIMD::Load3(array + 6), _mm_set1_ps(v.z), col);
+	SIMD::Store3(vec.array, col);
+#else
 	vec.x = v.x*array[0] + v.y*array[3] + v.z*array[6];
 	vec.y = v.x*array[1] + v.y*array[4] + v.z*array[7];
 	vec.z = v.x*array[2] + v.y*array[5] + v.z*array[8];
+#endif
 
 	return vec;
 };
\ No newline at end of file
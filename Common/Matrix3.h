@@ -10,6 +10,7 @@ https://research.ncl.ac.uk/game/
 #include <assert.h>
 #include <algorithm>
 #include <iostream>
+#include "SIMD.h"
 
 namespace NCL {
 	namespace Maths {
@@ -79,6 +80,20 @@ namespace NCL {
 
 			inline Matrix3 operator*(const Matrix3 &a) const {
 				Matrix3 out;
+#if defined(NCL_SIMD_SSE2)
+				//Columns are only 3 floats apart, so the 4th lane of each load is
+				//filled in with 0 rather than read from the next column
+				__m128 c0 = SIMD::Load3(array);
+				__m128 c1 = SIMD::Load3(array + 3);
+				__m128 c2 = SIMD::Load3(array + 6);
+				for (unsigned int r = 0; r < 3; ++r) {
+					const float* in = &a.array[r * 3];
+					__m128 col = _mm_mul_ps(c0, _mm_set1_ps(in[0]));
+					col = SIMD::MulAdd(c1, _mm_set1_ps(in[1]), col);
+					col = SIMD::MulAdd(c2, _mm_set1_ps(in[2]), col);
+					SIMD::Store3(&out.array[r * 3], col);
+				}
+#else
 				//Students! You should be able to think up a really easy way of speeding this up...
 				for (unsigned int r = 0; r < 3; ++r) {
 					for (unsigned int c = 0; c < 3; ++c) {
@@ -88,6 +103,7 @@ namespace NCL {
 						}
 					}
 				}
+#endif
 				return out;
 			}
 
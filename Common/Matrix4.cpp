@@ -12,6 +12,7 @@ https://research.ncl.ac.uk/game/
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Quaternion.h"
+#include <cstring>
 
 using namespace NCL;
 using namespace NCL::Maths;
@@ -100,7 +101,7 @@ void	Matrix4::SetDiagonal(const Vector3 &in) {
 Matrix4 Matrix4::Perspective(float znear, float zfar, float aspect, float fov) {
 	Matrix4 m;
 
-	const float h = 1.0f / tan(fov*Maths::PI_OVER_360);
+	const float h = 1.0f / Maths::Tan(fov*Maths::PI_OVER_360);
 	float neg_depth = znear-zfar;
 
 	m.array[0]		= h / aspect;
@@ -163,8 +164,8 @@ Matrix4 Matrix4::Rotation(float degrees, const Vector3 &inaxis)	 {
 
 	axis.Normalise();
 
-	float c = cos((float)Maths::DegreesToRadians(degrees));
-	float s = sin((float)Maths::DegreesToRadians(degrees));
+	float c = Maths::Cos((float)Maths::DegreesToRadians(degrees));
+	float s = Maths::Sin((float)Maths::DegreesToRadians(degrees));
 
 	m.array[0]  = (axis.x * axis.x) * (1.0f - c) + c;
 	m.array[1]  = (axis.y * axis.x) * (1.0f - c) + (axis.z * s);
@@ -281,6 +282,131 @@ Matrix4 Matrix4::Inverse()	const {
 	return temp;
 }
 
+/*
+The inverse of the upper 3x3 has the cross products of its columns as rows,
+divided by the determinant. The new translation is then just the old one
+taken back through that inverse, and flipped.
+*/
+Matrix4 Matrix4::AffineInverse() const {
+	Matrix4 m;
+#if defined(NCL_SIMD_SSE2)
+	__m128 a = SIMD::Load3(array);
+	__m128 b = SIMD::Load3(array + 4);
+	__m128 c = SIMD::Load3(array + 8);
+
+	__m128 r0 = SIMD::Cross3(b, c);
+	__m128 r1 = SIMD::Cross3(c, a);
+	__m128 r2 = SIMD::Cross3(a, b);
+	__m128 r3 = _mm_setzero_ps();
+
+	__m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), SIMD::Dot3(a, r0));
+	r0 = _mm_mul_ps(r0, invDet);
+	r1 = _mm_mul_ps(r1, invDet);
+	r2 = _mm_mul_ps(r2, invDet);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	__m128 t = _mm_mul_ps(r0, _mm_set1_ps(array[12]));
+	t = SIMD::MulAdd(r1, _mm_set1_ps(array[13]), t);
+	t = SIMD::MulAdd(r2, _mm_set1_ps(array[14]), t);
+	t = _mm_sub_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), t);
+
+	SIMD::Store(m.array, r0);
+	SIMD::Store(m.array + 4, r1);
+	SIMD::Store(m.array + 8, r2);
+	SIMD::Store(m.array + 12, t);
+#else
+	Vector3 a(array[0], array[1], array[2]);
+	Vector3 b(array[4], array[5], array[6]);
+	Vector3 c(array[8], array[9], array[10]);
+
+	Vector3 rows[3] = { Vector3::Cross(b, c), Vector3::Cross(c, a), Vector3::Cross(a, b) };
+	float invDet = 1.0f / Vector3::Dot(a, rows[0]);
+
+	Vector3 t(array[12], array[13], array[14]);
+	for (int i = 0; i < 3; ++i) {
+		rows[i] = rows[i] * invDet;
+		m.array[i]		= rows[i].x;
+		m.array[i + 4]	= rows[i].y;
+		m.array[i + 8]	= rows[i].z;
+		m.array[i + 12] = -Vector3::Dot(rows[i], t);
+	}
+#endif
+	return m;
+}
+
+Matrix4 Matrix4::RigidInverse() const {
+	Matrix4 m;
+#if defined(NCL_SIMD_SSE2)
+	__m128 r0 = SIMD::Load3(array);
+	__m128 r1 = SIMD::Load3(array + 4);
+	__m128 r2 = SIMD::Load3(array + 8);
+	__m128 r3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	__m128 t = _mm_mul_ps(r0, _mm_set1_ps(array[12]));
+	t = SIMD::MulAdd(r1, _mm_set1_ps(array[13]), t);
+	t = SIMD::MulAdd(r2, _mm_set1_ps(array[14]), t);
+	t = _mm_sub_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), t);
+
+	SIMD::Store(m.array, r0);
+	SIMD::Store(m.array + 4, r1);
+	SIMD::Store(m.array + 8, r2);
+	SIMD::Store(m.array + 12, t);
+#else
+	for (int c = 0; c < 3; ++c) {
+		for (int r = 0; r < 3; ++r) {
+			m.array[(c * 4) + r] = array[(r * 4) + c];
+		}
+	}
+	for (int i = 0; i < 3; ++i) {
+		m.array[i + 12] = -(m.array[i] * array[12] + m.array[i + 4] * array[13] + m.array[i + 8] * array[14]);
+	}
+#endif
+	return m;
+}
+
+void Matrix4::TransformPoints(const Vector3* in, Vector3* out, size_t count) const {
+#if defined(NCL_SIMD_SSE2)
+	__m128 c0 = SIMD::Load(array);
+	__m128 c1 = SIMD::Load(array + 4);
+	__m128 c2 = SIMD::Load(array + 8);
+	__m128 c3 = SIMD::Load(array + 12);
+	for (size_t i = 0; i < count; ++i) {
+		__m128 v = _mm_mul_ps(c0, _mm_set1_ps(in[i].x));
+		v = SIMD::MulAdd(c1, _mm_set1_ps(in[i].y), v);
+		v = SIMD::MulAdd(c2, _mm_set1_ps(in[i].z), v);
+		SIMD::Store3(out[i].array, _mm_add_ps(v, c3));
+	}
+#else
+	for (size_t i = 0; i < count; ++i) {
+		Vector3 v = in[i];
+		out[i].x = v.x*array[0] + v.y*array[4] + v.z*array[8] + array[12];
+		out[i].y = v.x*array[1] + v.y*array[5] + v.z*array[9] + array[13];
+		out[i].z = v.x*array[2] + v.y*array[6] + v.z*array[10] + array[14];
+	}
+#endif
+}
+
+void Matrix4::TransformPoints(const Vector4* in, Vector4* out, size_t count) const {
+#if defined(NCL_SIMD_SSE2)
+	__m128 c0 = SIMD::Load(array);
+	__m128 c1 = SIMD::Load(array + 4);
+	__m128 c2 = SIMD::Load(array + 8);
+	__m128 c3 = SIMD::Load(array + 12);
+	for (size_t i = 0; i < count; ++i) {
+		__m128 v = _mm_mul_ps(c0, _mm_set1_ps(in[i].x));
+		v = SIMD::MulAdd(c1, _mm_set1_ps(in[i].y), v);
+		v = SIMD::MulAdd(c2, _mm_set1_ps(in[i].z), v);
+		v = SIMD::MulAdd(c3, _mm_set1_ps(in[i].w), v);
+		SIMD::Store(out[i].array, v);
+	}
+#else
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = *this * in[i];
+	}
+#endif
+}
+
 Vector4 Matrix4::GetRow(unsigned int row) const {
 	Vector4 out(0, 0, 0, 1);
 	if (row <= 3) {
@@ -307,6 +433,13 @@ Vector4 Matrix4::GetColumn(unsigned int column) const {
 Vector3 Matrix4::operator*(const Vector3 &v) const {
 	Vector3 vec;
 
+#if defined(NCL_SIMD_SSE2)
+	__m128 r = _mm_mul_ps(SIMD::Load(array), _mm_set1_ps(v.x));
+	r = SIMD::MulAdd(SIMD::Load(array + 4), _mm_set1_ps(v.y), r);
+	r = SIMD::MulAdd(SIMD::Load(array + 8), _mm_set1_ps(v.z), r);
+	r = _mm_add_ps(r, SIMD::Load(array + 12));
+	SIMD::Store3(vec.array, _mm_div_ps(r, SIMD::Swizzle<3, 3, 3, 3>(r)));
+#else
 	float temp;
 
 	vec.x = v.x*array[0] + v.y*array[4] + v.z*array[8] + array[12];
@@ -318,15 +451,22 @@ Vector3 Matrix4::operator*(const Vector3 &v) const {
 	vec.x = vec.x / temp;
 	vec.y = vec.y / temp;
 	vec.z = vec.z / temp;
+#endif
 
 	return vec;
 }
 
 Vector4 Matrix4::operator*(const Vector4 &v) const {
+#if defined(NCL_SIMD_SSE2)
+	Vector4 out;
+	TransformPoints(&v, &out, 1);
+	return out;
+#else
 	return Vector4(
 		v.x*array[0] + v.y*array[4] + v.z*array[8] + v.w * array[12],
 		v.x*array[1] + v.y*array[5] + v.z*array[9] + v.w * array[13],
 		v.x*array[2] + v.y*array[6] + v.z*array[10] + v.w * array[14],
 		v.x*array[3] + v.y*array[7] + v.z*array[11] + v.w * array[15]
 	);
+#endif
 }
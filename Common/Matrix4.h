@@ -9,6 +9,7 @@ https://research.ncl.ac.uk/game/
 #pragma once
 
 #include <iostream>
+#include "SIMD.h"
 
 namespace NCL {
 	namespace Maths {
@@ -17,7 +18,7 @@ namespace NCL {
 		class Matrix3;
 		class Quaternion;
 
-		class Matrix4 {
+		class NCL_SIMD_ALIGN Matrix4 {
 		public:
 			Matrix4(void);
 			Matrix4(float elements[16]);
@@ -69,6 +70,20 @@ namespace NCL {
 			void    Invert();
 			Matrix4 Inverse() const;
 
+			//Inverts a matrix made only of rotation, scale and translation - a
+			//lot less work than Inverse(), which has to handle projections too
+			Matrix4 AffineInverse() const;
+
+			//Inverts a matrix made only of rotation and translation (such as
+			//a view matrix), where the inverse rotation is just the transpose
+			Matrix4 RigidInverse() const;
+
+			//Transforms 'count' points from 'in' into 'out', which can be the same
+			//array. The Vector3 version treats them as points (w of 1), and skips
+			//the divide by w, so it is only for affine matrices
+			void	TransformPoints(const Vector3* in, Vector3* out, size_t count) const;
+			void	TransformPoints(const Vector4* in, Vector4* out, size_t count) const;
+
 
 			Vector4 GetRow(unsigned int row) const;
 			Vector4 GetColumn(unsigned int column) const;
@@ -76,6 +91,20 @@ namespace NCL {
 			//Multiplies 'this' matrix by matrix 'a'. Performs the multiplication in 'OpenGL' order (ie, backwards)
 			inline Matrix4 operator*(const Matrix4& a) const {
 				Matrix4 out;
+#if defined(NCL_SIMD_SSE2)
+				__m128 c0 = SIMD::Load(array);
+				__m128 c1 = SIMD::Load(array + 4);
+				__m128 c2 = SIMD::Load(array + 8);
+				__m128 c3 = SIMD::Load(array + 12);
+				for (unsigned int r = 0; r < 4; ++r) {
+					const float* in = &a.array[r * 4];
+					__m128 col = _mm_mul_ps(c0, _mm_set1_ps(in[0]));
+					col = SIMD::MulAdd(c1, _mm_set1_ps(in[1]), col);
+					col = SIMD::MulAdd(c2, _mm_set1_ps(in[2]), col);
+					col = SIMD::MulAdd(c3, _mm_set1_ps(in[3]), col);
+					SIMD::Store(&out.array[r * 4], col);
+				}
+#else
 				//Students! You should be able to think up a really easy way of speeding this up...
 				for (unsigned int r = 0; r < 4; ++r) {
 					for (unsigned int c = 0; c < 4; ++c) {
@@ -85,6 +114,7 @@ namespace NCL {
 						}
 					}
 				}
+#endif
 				return out;
 			}
 
@@ -246,6 +246,18 @@ void MeshGeometry::SetVertexColours(const vector<Vector4>& newColours) {
 	colours = newColours;
 }
 
+void MeshGeometry::SetVertexPositions(const Vector3* newVerts, size_t count) {
+	positions.assign(newVerts, newVerts + count);
+}
+
+void MeshGeometry::SetVertexTextureCoords(const Vector2* newTex, size_t count) {
+	texCoords.assign(newTex, newTex + count);
+}
+
+void MeshGeometry::SetVertexColours(const Vector4* newColours, size_t count) {
+	colours.assign(newColours, newColours + count);
+}
+
 void MeshGeometry::SetVertexNormals(const vector<Vector3>& newNorms) {
 	normals = newNorms;
 }
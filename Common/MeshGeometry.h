@@ -122,6 +122,11 @@ namespace NCL {
 		void SetVertexSkinWeights(const vector<Vector4>& newSkinWeights);
 		void SetVertexSkinIndices(const vector<Vector4>& newSkinIndices);
 
+		//For vertices that aren't in a std::vector - the frame arena's, say
+		void SetVertexPositions(const Vector3* newVerts, size_t count);
+		void SetVertexTextureCoords(const Vector2* newTex, size_t count);
+		void SetVertexColours(const Vector4* newColours, size_t count);
+
 
 		void	TransformVertices(const Matrix4& byMatrix);
 
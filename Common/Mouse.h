@@ -27,6 +27,7 @@ namespace NCL {
 	class Mouse {
 	public:
 		friend class Window;
+		friend class InputRecording;
 		inline bool ButtonPressed(MouseButtons button) const {
 			return buttons[(int)button] && !holdButtons[(int)button];
 		}
@@ -0,0 +1,110 @@
+#include "NullWindow.h"
+#include <algorithm>
+
+using namespace NCL;
+
+NullWindow* NullWindow::CreateNullWindow(int sizeX, int sizeY, float timeStep) {
+	if (window) {
+		return nullptr;
+	}
+	return new NullWindow("NCL Null Window", sizeX, sizeY, timeStep);
+}
+
+NullWindow::NullWindow(const std::string& title, int sizeX, int sizeY, float timeStep) {
+	windowTitle	= title;
+	size		= Vector2((float)sizeX, (float)sizeY);
+	defaultSize	= size;
+
+	nullKeyboard	= new NullKeyboard();
+	nullMouse		= new NullMouse(size);
+
+	keyboard	= nullKeyboard;
+	mouse		= nullMouse;
+
+	timer->SetFixedTimeDelta(timeStep);
+
+	nextInput	= 0;
+	playback	= nullptr;
+	playbackOffset = 0;
+	frameCount	= 0;
+	frameLimit	= 0;
+	init		= true;
+}
+
+NullWindow::~NullWindow() {
+	//Window's destructor deletes the keyboard and mouse
+}
+
+void NullWindow::AddInput(const ScriptedInput& input) {
+	//Anything for the same frame goes on after what's already there, so a
+	//release and a press of the same key in one frame happen in that order
+	auto i = std::upper_bound(script.begin() + nextInput, script.end(), input,
+		[](const ScriptedInput& a, const ScriptedInput& b) { return a.frame < b.frame; }
+	);
+	script.insert(i, input);
+}
+
+void NullWindow::PressKey(KeyboardKeys key, int frame, int frames) {
+	AddInput({ frame, InputType::Key, (int)key, true, Vector2() });
+	AddInput({ frame + std::max(frames, 1), InputType::Key, (int)key, false, Vector2() });
+}
+
+void NullWindow::PressButton(MouseButtons button, int frame, int frames) {
+	AddInput({ frame, InputType::Button, (int)button, true, Vector2() });
+	AddInput({ frame + std::max(frames, 1), InputType::Button, (int)button, false, Vector2() });
+}
+
+void NullWindow::MoveMouse(const Vector2& amount, int frame) {
+	AddInput({ frame, InputType::Movement, 0, true, amount });
+}
+
+void NullWindow::ScrollWheel(int amount, int frame) {
+	AddInput({ frame, InputType::Wheel, amount, true, Vector2() });
+}
+
+/*
+Each frame is read back a frame early, so that its time step can be given
+to the timer before the Tick that it's meant for.
+*/
+void NullWindow::PlayRecording(const InputRecording* recording) {
+	playback		= recording;
+	playbackFrame	= InputRecording::FrameState();
+	playbackOffset	= 0;
+	if (!playback || !playback->ReadFrame(playbackOffset, playbackFrame)) {
+		playback = nullptr;
+		return;
+	}
+	timer->SetFixedTimeDelta(playbackFrame.timeStep);
+	SetFrameLimit(frameCount + playback->GetFrameCount());
+}
+
+/*
+UpdateWindow has already moved the keyboard and mouse on a frame by the time
+this gets called, so anything set here is new this frame, like a real key
+press arriving from the OS.
+*/
+bool NullWindow::InternalUpdate() {
+	if (frameLimit > 0 && frameCount >= frameLimit) {
+		return false;
+	}
+	for (; nextInput < script.size() && script[nextInput].frame <= frameCount; ++nextInput) {
+		const ScriptedInput& input = script[nextInput];
+		switch (input.type) {
+			case InputType::Key:		nullKeyboard->SetKeyState((KeyboardKeys)input.code, input.down);	break;
+			case InputType::Button:		nullMouse->SetButtonState((MouseButtons)input.code, input.down);	break;
+			case InputType::Movement:	nullMouse->Move(input.movement);									break;
+			case InputType::Wheel:		nullMouse->SetWheel(input.code);									break;
+		}
+	}
+	if (playback) {
+		InputRecording::ApplyFrame(playbackFrame, *nullKeyboard, *nullMouse);
+		if (playback->ReadFrame(playbackOffset, playbackFrame)) {
+			timer->SetFixedTimeDelta(playbackFrame.timeStep);
+		}
+		else {
+			playback = nullptr;
+		}
+	}
+	frameCount++;
+	return true;
+}
@@ -0,0 +1,131 @@
+/******************************************************************************
+Class:NullWindow
+Implements:Window
+Author:Rich Davison
+Description:A window that doesn't open anything, for running the game without
+a display - on servers, or for load tests. Its timer moves on by a fixed step
+each frame, and its keyboard and mouse only do what they're scripted to.
+
+-_-_-_-_-_-_-_,------,
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""
+
+*//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Window.h"
+#include "InputRecording.h"
+#include <vector>
+
+namespace NCL {
+	class NullWindow;
+
+	class NullKeyboard : public Keyboard {
+	public:
+		friend class NullWindow;
+	protected:
+		NullKeyboard() {
+			isAwake = true;
+		}
+		virtual ~NullKeyboard() {}
+
+		void SetKeyState(KeyboardKeys key, bool down) {
+			keyStates[(int)key] = down;
+		}
+	};
+
+	class NullMouse : public Mouse {
+	public:
+		friend class NullWindow;
+	protected:
+		NullMouse(const Vector2& bounds) {
+			SetAbsolutePositionBounds(bounds);
+			SetAbsolutePosition(bounds * 0.5f);
+		}
+		virtual ~NullMouse() {}
+
+		void SetButtonState(MouseButtons button, bool down) {
+			buttons[(int)button] = down;
+		}
+		void Move(const Vector2& amount) {
+			relativePosition = amount * sensitivity;
+			absolutePosition += amount;
+		}
+		void SetWheel(int amount) {
+			frameWheel = amount;
+		}
+	};
+
+	class NullWindow : public Window {
+	public:
+		//Like Window::CreateGameWindow, there can only be one window at a time
+		static NullWindow* CreateNullWindow(int sizeX = 1280, int sizeY = 720, float timeStep = 1.0f / 60.0f);
+
+		NullWindow(const std::string& title, int sizeX, int sizeY, float timeStep);
+		~NullWindow();
+
+		void LockMouseToWindow(bool lock)	override {}
+		void ShowOSPointer(bool show)		override {}
+
+		/*
+		Scripted input. Frames count from 0, the first UpdateWindow - input for a
+		frame is applied during its UpdateWindow, so it's seen by that frame's
+		game update, just as real input would be. Presses are held down for
+		'frames' frames, so the first of them counts as KeyPressed, and the rest
+		as KeyHeld.
+		*/
+		void PressKey(KeyboardKeys key, int frame, int frames = 1);
+		void PressButton(MouseButtons button, int frame, int frames = 1);
+		void MoveMouse(const Vector2& amount, int frame);
+		void ScrollWheel(int amount, int frame);
+
+		/*
+		Plays back a recording from the next frame on, in place of the real
+		keyboard and mouse, with each frame taking the time step it was
+		recorded with. The window stops once the recording runs out. The
+		recording has to stay around until then.
+		*/
+		void PlayRecording(const InputRecording* recording);
+
+		//UpdateWindow returns false once this many frames have gone by (0 to never stop)
+		void SetFrameLimit(int frames) {
+			frameLimit = frames;
+		}
+		int GetFrameCount() const {
+			return frameCount;
+		}
+
+	protected:
+		bool InternalUpdate() override;
+
+		enum class InputType {
+			Key,
+			Button,
+			Movement,
+			Wheel
+		};
+
+		struct ScriptedInput {
+			int			frame;
+			InputType	type;
+			int			code;	//The key or button, or the wheel amount
+			bool		down;
+			Vector2		movement;
+		};
+
+		void AddInput(const ScriptedInput& input);
+
+		std::vector<ScriptedInput>	script;	//In frame order
+		size_t						nextInput;
+
+		const InputRecording*		playback;
+		InputRecording::FrameState	playbackFrame;	//The next frame to be played back
+		size_t						playbackOffset;
+
+		NullKeyboard*	nullKeyboard;
+		NullMouse*		nullMouse;
+
+		int frameCount;
+		int frameLimit;
+	};
+}
@@ -0,0 +1,118 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace NCL {
+	/*
+	Hands out objects of one type from slabs of slots, rather than a trip to
+	the heap each. Freed slots go on a free list, and are the first to be
+	reused, so spawning and despawning lots of the same thing settles down to
+	no heap use at all once the pool is big enough. Slabs are only given back
+	when the pool itself goes.
+
+	Not thread safe - like the GameWorld that owns most of them, it's for the
+	main thread.
+	*/
+	template<typename T, size_t SlabSize = 256>
+	class ObjectPool {
+	public:
+		ObjectPool() : freeList(nullptr), liveCount(0) {}
+		~ObjectPool() {
+			//Anything still alive has its memory pulled out from under it
+			for (Slot* s : slabs) {
+				delete[] s;
+			}
+		}
+
+		template<typename... Args>
+		T* New(Args&&... args) {
+			Slot* s = freeList;
+			if (!s) {
+				AddSlab();
+				s = freeList;
+			}
+			freeList = s->next; //before the object goes over the top of it
+			liveCount++;
+			T* t = new (&s->storage) T(std::forward<Args>(args)...);
+			return t;
+		}
+
+		void Delete(T* t) {
+			if (!t) {
+				return;
+			}
+			t->~T();
+			Slot* s = reinterpret_cast<Slot*>(t);
+			s->next		= freeList;
+			freeList	= s;
+			liveCount--;
+		}
+
+		//Whether t came out of this pool, so that mixed pooled and new'd
+		//objects can each be freed the right way. The slabs are kept in
+		//address order, so only the one just below t needs checking
+		bool Owns(const void* t) const {
+			std::less<const void*> before;
+			auto above = std::upper_bound(slabs.begin(), slabs.end(), t,
+				[&before](const void* p, const Slot* s) { return before(p, s); });
+			if (above == slabs.begin()) {
+				return false;
+			}
+			return before(t, *(above - 1) + SlabSize);
+		}
+
+		//Makes sure there's room for count more objects without growing
+		void Reserve(size_t count) {
+			size_t free = GetCapacity() - liveCount;
+			while (free < count) {
+				AddSlab();
+				free += SlabSize;
+			}
+		}
+
+		size_t GetLiveCount() const {
+			return liveCount;
+		}
+
+		size_t GetCapacity() const {
+			return slabs.size() * SlabSize;
+		}
+
+	protected:
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		union Slot {
+			Slot* next;
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+		};
+
+		//Slots are chained up in order, so a new slab is used front to back
+		void AddSlab() {
+			Slot* slab = new Slot[SlabSize];
+			for (size_t i = 0; i < SlabSize - 1; ++i) {
+				slab[i].next = &slab[i + 1];
+			}
+			slab[SlabSize - 1].next = freeList;
+			freeList = slab;
+			slabs.insert(std::upper_bound(slabs.begin(), slabs.end(), slab, std::less<const Slot*>()), slab);
+		}
+
+		std::vector<Slot*>	slabs;	//In address order
+		Slot*				freeList;
+		size_t				liveCount;
+	};
+}
@@ -0,0 +1,212 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include "Vector3.h"
+#include "SIMD.h"
+
+namespace NCL {
+	namespace Maths {
+		/*
+		A Vector3 with a 4th, unused float on the end, so that it fits exactly in
+		one SIMD register and can be loaded and stored in one go. Vector3 itself
+		stays at 12 bytes, as meshes and the renderer rely on that - this is for
+		big arrays of positions and velocities that get worked on every frame.
+
+		It converts to and from a Vector3 without being asked, so it can be
+		dropped into code written for Vector3 without much else changing. w is
+		kept at 0, so that Dot and Length can safely include it.
+		*/
+		class NCL_SIMD_ALIGN PaddedVector3 {
+		public:
+			union {
+				struct {
+					float x;
+					float y;
+					float z;
+					float w;
+				};
+				float array[4];
+			};
+
+		public:
+			constexpr PaddedVector3(void) : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+
+			constexpr PaddedVector3(float xVal, float yVal, float zVal) : x(xVal), y(yVal), z(zVal), w(0.0f) {}
+
+			constexpr PaddedVector3(const Vector3& v) : x(v.x), y(v.y), z(v.z), w(0.0f) {}
+
+#if defined(NCL_SIMD_SSE2)
+			explicit PaddedVector3(__m128 v) {
+				SIMD::Store(array, v);
+			}
+
+			inline __m128 ToSIMD() const {
+				return SIMD::Load(array);
+			}
+#endif
+
+			operator Vector3() const {
+				return Vector3(x, y, z);
+			}
+
+			PaddedVector3 Normalised() const {
+				PaddedVector3 temp(*this);
+				temp.Normalise();
+				return temp;
+			}
+
+			void			Normalise() {
+#if defined(NCL_SIMD_SSE2)
+				__m128 v		= ToSIMD();
+				__m128 length	= _mm_sqrt_ps(SIMD::Dot3(v, v));
+				if (_mm_cvtss_f32(length) != 0.0f) {
+					SIMD::Store(array, _mm_mul_ps(v, _mm_div_ps(_mm_set1_ps(1.0f), length)));
+				}
+#else
+				float length = Length();
+
+				if (length != 0.0f) {
+					length = 1.0f / length;
+					x = x * length;
+					y = y * length;
+					z = z * length;
+				}
+#endif
+			}
+
+			float	Length() const {
+#if defined(NCL_SIMD_SSE2)
+				__m128 v = ToSIMD();
+				return _mm_cvtss_f32(_mm_sqrt_ss(SIMD::Dot3(v, v)));
+#else
+				return sqrt((x*x) + (y*y) + (z*z));
+#endif
+			}
+
+			constexpr float	LengthSquared() const {
+				return ((x*x) + (y*y) + (z*z));
+			}
+
+			static float	Dot(const PaddedVector3 &a, const PaddedVector3 &b) {
+#if defined(NCL_SIMD_SSE2)
+				return _mm_cvtss_f32(SIMD::Dot3(a.ToSIMD(), b.ToSIMD()));
+#else
+				return (a.x*b.x) + (a.y*b.y) + (a.z*b.z);
+#endif
+			}
+
+			static PaddedVector3	Cross(const PaddedVector3 &a, const PaddedVector3 &b) {
+#if defined(NCL_SIMD_SSE2)
+				return PaddedVector3(SIMD::Cross3(a.ToSIMD(), b.ToSIMD()));
+#else
+				return PaddedVector3((a.y*b.z) - (a.z*b.y), (a.z*b.x) - (a.x*b.z), (a.x*b.y) - (a.y*b.x));
+#endif
+			}
+
+#if defined(NCL_SIMD_SSE2)
+			inline PaddedVector3  operator+(const PaddedVector3  &a) const {
+				return PaddedVector3(_mm_add_ps(ToSIMD(), a.ToSIMD()));
+			}
+
+			inline PaddedVector3  operator-(const PaddedVector3  &a) const {
+				return PaddedVector3(_mm_sub_ps(ToSIMD(), a.ToSIMD()));
+			}
+
+			inline PaddedVector3  operator-() const {
+				return PaddedVector3(_mm_xor_ps(ToSIMD(), _mm_set_ps(0.0f, -0.0f, -0.0f, -0.0f)));
+			}
+
+			inline PaddedVector3  operator*(float a)	const {
+				return PaddedVector3(_mm_mul_ps(ToSIMD(), _mm_set1_ps(a)));
+			}
+
+			inline PaddedVector3  operator*(const PaddedVector3  &a) const {
+				return PaddedVector3(_mm_mul_ps(ToSIMD(), a.ToSIMD()));
+			}
+
+			//w stays at 0 rather than becoming 0/0
+			inline PaddedVector3  operator/(const PaddedVector3  &a) const {
+				return PaddedVector3(_mm_div_ps(ToSIMD(), _mm_set_ps(1.0f, a.z, a.y, a.x)));
+			};
+
+			inline PaddedVector3  operator/(float v) const {
+				return PaddedVector3(_mm_div_ps(ToSIMD(), _mm_set1_ps(v)));
+			};
+#else
+			inline PaddedVector3  operator+(const PaddedVector3  &a) const {
+				return PaddedVector3(x + a.x, y + a.y, z + a.z);
+			}
+
+			inline PaddedVector3  operator-(const PaddedVector3  &a) const {
+				return PaddedVector3(x - a.x, y - a.y, z - a.z);
+			}
+
+			inline PaddedVector3  operator-() const {
+				return PaddedVector3(-x, -y, -z);
+			}
+
+			inline PaddedVector3  operator*(float a)	const {
+				return PaddedVector3(x * a, y * a, z * a);
+			}
+
+			inline PaddedVector3  operator*(const PaddedVector3  &a) const {
+				return PaddedVector3(x * a.x, y * a.y, z * a.z);
+			}
+
+			inline PaddedVector3  operator/(const PaddedVector3  &a) const {
+				return PaddedVector3(x / a.x, y / a.y, z / a.z);
+			};
+
+			inline PaddedVector3  operator/(float v) const {
+				return PaddedVector3(x / v, y / v, z / v);
+			};
+#endif
+
+			inline void operator+=(const PaddedVector3  &a) {
+				*this = *this + a;
+			}
+
+			inline void operator-=(const PaddedVector3  &a) {
+				*this = *this - a;
+			}
+
+			inline void operator*=(const PaddedVector3  &a) {
+				*this = *this * a;
+			}
+
+			inline void operator/=(const PaddedVector3  &a) {
+				*this = *this / a;
+			}
+
+			inline void operator*=(float f) {
+				*this = *this * f;
+			}
+
+			inline void operator/=(float f) {
+				*this = *this / f;
+			}
+
+			inline float operator[](int i) const {
+				return array[i];
+			}
+
+			inline float& operator[](int i) {
+				return array[i];
+			}
+
+			inline bool	operator==(const PaddedVector3 &A)const { return (A.x == x && A.y == y && A.z == z) ? true : false; };
+			inline bool	operator!=(const PaddedVector3 &A)const { return (A.x == x && A.y == y && A.z == z) ? false : true; };
+
+			inline friend std::ostream& operator<<(std::ostream& o, const PaddedVector3& v) {
+				o << "Vector3(" << v.x << "," << v.y << "," << v.z << ")" << std::endl;
+				return o;
+			}
+		};
+	}
+}
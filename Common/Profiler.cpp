@@ -0,0 +1,293 @@
+#include "Profiler.h"
+#include "FrameArena.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+
+using namespace NCL;
+
+std::atomic<bool>	Profiler::enabled(true);
+
+std::vector<ProfileSummaryEntry>	Profiler::summary;
+std::vector<ProfileEvent>			Profiler::frameEvents;
+std::vector<ProfileEvent>			Profiler::capturedEvents;
+std::vector<long long>				Profiler::capturedFrames;
+
+long long	Profiler::frameStart		= 0;
+float		Profiler::frameTimeMS		= 0.0f;
+int			Profiler::mainThread		= 0;
+int			Profiler::droppedEvents		= 0;
+bool		Profiler::capturing			= false;
+int			Profiler::captureFramesLeft	= 0;
+
+namespace {
+	const unsigned int bufferSize = 1 << 16; //Events per thread, per frame
+
+	/*
+	Only the thread a buffer belongs to ever writes to it, and only EndFrame
+	ever reads from it, so the two counters are all it takes to keep them out
+	of each other's way - the writer never gets more than a buffer's worth
+	ahead of the reader, and drops events rather than overwrite unread ones.
+	*/
+	struct ThreadBuffer {
+		std::vector<ProfileEvent>	events;
+		std::atomic<unsigned int>	written;
+		std::atomic<unsigned int>	read;
+		std::atomic<int>			dropped;
+		std::atomic<bool>			inUse;
+		int							depth;
+		int							id;
+	};
+
+	std::mutex									buffersLock;
+	std::vector<ThreadBuffer*>					buffers;	//Never freed, see below
+
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	//Hands the buffer back when its thread finishes, for the next new thread to use.
+	//Worker threads can still be finishing while the statics are being destroyed,
+	//so the buffers are never freed, and are always there to be handed back
+	struct ThreadBufferHandle {
+		ThreadBuffer* buffer = nullptr;
+		~ThreadBufferHandle() {
+			if (buffer) {
+				buffer->inUse = false;
+			}
+		}
+	};
+	thread_local ThreadBufferHandle threadBuffer;
+
+	ThreadBuffer* GetThreadBuffer() {
+		if (threadBuffer.buffer) {
+			return threadBuffer.buffer;
+		}
+		std::lock_guard<std::mutex> lock(buffersLock);
+		ThreadBuffer* b = nullptr;
+		for (auto& i : buffers) {
+			if (!i->inUse) {
+				b = i;
+				break;
+			}
+		}
+		if (!b) {
+			b = new ThreadBuffer();
+			b->events.resize(bufferSize);
+			b->written	= 0;
+			b->read		= 0;
+			b->dropped	= 0;
+			b->id		= (int)buffers.size();
+			buffers.emplace_back(b);
+		}
+		b->inUse	= true;
+		b->depth	= 0;
+		threadBuffer.buffer = b;
+		return b;
+	}
+
+	void WriteJSONString(std::ostream& o, const char* text) {
+		o << '"';
+		for (const char* c = text; *c; ++c) {
+			if (*c == '"' || *c == '\\') {
+				o << '\\' << *c;
+			}
+			else if ((unsigned char)*c < 0x20) {
+				o << ' ';
+			}
+			else {
+				o << *c;
+			}
+		}
+		o << '"';
+	}
+}
+
+long long Profiler::GetTime() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+int Profiler::EnterScope() {
+	return GetThreadBuffer()->depth++;
+}
+
+void Profiler::RecordEvent(const char* name, long long start, long long end, int depth) {
+	ThreadBuffer* b = GetThreadBuffer();
+	b->depth = depth;
+
+	unsigned int w = b->written.load(std::memory_order_relaxed);
+	if (w - b->read.load(std::memory_order_acquire) >= bufferSize) {
+		b->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	ProfileEvent& e = b->events[w & (bufferSize - 1)];
+	e.name		= name;
+	e.start		= start;
+	e.end		= end;
+	e.depth		= depth;
+	e.thread	= b->id;
+	b->written.store(w + 1, std::memory_order_release);
+}
+
+void Profiler::EndFrame() {
+	const long long now = GetTime();
+	mainThread = GetThreadBuffer()->id;
+
+	frameEvents.clear();
+	droppedEvents = 0;
+	{
+		std::lock_guard<std::mutex> lock(buffersLock);
+		for (auto& b : buffers) {
+			unsigned int r = b->read.load(std::memory_order_relaxed);
+			unsigned int w = b->written.load(std::memory_order_acquire);
+			for (; r != w; ++r) {
+				frameEvents.emplace_back(b->events[r & (bufferSize - 1)]);
+			}
+			b->read.store(r, std::memory_order_release);
+			droppedEvents += b->dropped.exchange(0, std::memory_order_relaxed);
+		}
+	}
+	frameTimeMS = (now - frameStart) / 1000000.0f;
+
+	if (capturing) {
+		capturedFrames.emplace_back(frameStart);
+		capturedEvents.insert(capturedEvents.end(), frameEvents.begin(), frameEvents.end());
+		if (captureFramesLeft > 0 && --captureFramesLeft == 0) {
+			capturing = false;
+		}
+	}
+	BuildSummary(frameEvents);
+	frameStart = now;
+}
+
+/*
+Scopes are recorded as they end, so children come before their parents -
+sorting them by when they started puts every parent before its children,
+and then the depths are enough to know which parent each one belongs to.
+*/
+void Profiler::BuildSummary(std::vector<ProfileEvent>& events) {
+	std::sort(events.begin(), events.end(),
+		[](const ProfileEvent& a, const ProfileEvent& b) {
+			if (a.thread != b.thread) {
+				if (a.thread == mainThread || b.thread == mainThread) {
+					return a.thread == mainThread;
+				}
+				return a.thread < b.thread;
+			}
+			if (a.start != b.start) {
+				return a.start < b.start;
+			}
+			return a.depth < b.depth;
+		}
+	);
+
+	//None of the working out outlives the frame, so it all comes from the frame arena
+	struct SummaryNode {
+		const char*			name;
+		int					depth;
+		int					thread;
+		long long			total;
+		int					calls;
+		FrameVector<int>	children;
+	};
+	FrameVector<SummaryNode>	nodes;
+	FrameVector<int>			roots;
+	FrameVector<int>			path;	//The node for each depth of the current event's parents
+
+	int thread = -1;
+	for (const ProfileEvent& e : events) {
+		if (e.thread != thread) {
+			thread = e.thread;
+			path.clear();
+		}
+		//Scopes that were still open when the frame ended (or started before it)
+		//never got recorded, so anything inside them hangs off whatever is left
+		if ((int)path.size() > e.depth) {
+			path.resize(e.depth);
+		}
+		const int parent = path.empty() ? -1 : path.back();
+		const FrameVector<int>& siblings = parent < 0 ? roots : nodes[parent].children;
+
+		int node = -1;
+		for (int i : siblings) {
+			if (nodes[i].thread == e.thread && strcmp(nodes[i].name, e.name) == 0) {
+				node = i;
+				break;
+			}
+		}
+		if (node < 0) {
+			node = (int)nodes.size();
+			nodes.push_back({ e.name, (int)path.size(), e.thread, 0, 0, {} });
+			(parent < 0 ? roots : nodes[parent].children).emplace_back(node);
+		}
+		nodes[node].total += e.end - e.start;
+		nodes[node].calls++;
+		path.emplace_back(node);
+	}
+
+	summary.clear();
+	FrameVector<int> stack(roots.rbegin(), roots.rend());
+	while (!stack.empty()) {
+		const SummaryNode& n = nodes[stack.back()];
+		stack.pop_back();
+
+		summary.push_back({ n.name, n.depth, n.thread, n.total / 1000000.0f, n.calls });
+		stack.insert(stack.end(), n.children.rbegin(), n.children.rend());
+	}
+}
+
+void Profiler::StartCapture(int frames) {
+	capturedEvents.clear();
+	capturedFrames.clear();
+	capturing			= true;
+	captureFramesLeft	= frames;
+}
+
+void Profiler::StopCapture() {
+	capturing = false;
+}
+
+bool Profiler::WriteChromeTrace(const std::string& filename) {
+	std::ofstream file(filename);
+	if (!file) {
+		return false;
+	}
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	std::vector<int> threads;
+	for (const ProfileEvent& e : capturedEvents) {
+		if (std::find(threads.begin(), threads.end(), e.thread) == threads.end()) {
+			threads.emplace_back(e.thread);
+		}
+	}
+	if (std::find(threads.begin(), threads.end(), mainThread) == threads.end()) {
+		threads.emplace_back(mainThread);
+	}
+	for (int t : threads) {
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << t << ",\"args\":{\"name\":\"";
+		if (t == mainThread) {
+			file << "Main thread";
+		}
+		else {
+			file << "Thread " << t;
+		}
+		file << "\"}},\n";
+	}
+	for (long long frame : capturedFrames) {
+		file << "{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":" << mainThread
+			<< ",\"ts\":" << frame / 1000.0 << "},\n";
+	}
+	for (const ProfileEvent& e : capturedEvents) {
+		file << "{\"name\":";
+		WriteJSONString(file, e.name);
+		file << ",\"cat\":\"ncl\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.thread
+			<< ",\"ts\":" << e.start / 1000.0 << ",\"dur\":" << (e.end - e.start) / 1000.0 << "},\n";
+	}
+	//JSON doesn't allow a comma after the last entry, so finish with one more
+	file << "{\"name\":\"End\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":" << mainThread
+		<< ",\"ts\":" << frameStart / 1000.0 << "}\n";
+	file << "]}\n";
+	return true;
+}
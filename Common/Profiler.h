@@ -0,0 +1,149 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include <atomic>
+#include <string>
+#include <vector>
+
+/*
+Instrumentation for finding out where a frame's time goes. Put
+NCL_PROFILE_SCOPE("Name") (or NCL_PROFILE_FUNCTION()) at the top of a block
+to time it, and NCL_PROFILE_FRAME() once a frame, on the main thread, to
+collect up everything the threads recorded since the last one.
+
+Define NCL_NO_PROFILER to compile every macro out to nothing - the Profiler
+class itself is still there, it just never gets given anything.
+*/
+#ifndef NCL_NO_PROFILER
+	#define NCL_PROFILE_CONCAT_INNER(a, b)	a##b
+	#define NCL_PROFILE_CONCAT(a, b)		NCL_PROFILE_CONCAT_INNER(a, b)
+	#define NCL_PROFILE_SCOPE(name)			NCL::ProfileScope NCL_PROFILE_CONCAT(profileScope, __LINE__)(name)
+	#define NCL_PROFILE_FUNCTION()			NCL_PROFILE_SCOPE(__FUNCTION__)
+	#define NCL_PROFILE_FRAME()				NCL::Profiler::EndFrame()
+#else
+	#define NCL_PROFILE_SCOPE(name)
+	#define NCL_PROFILE_FUNCTION()
+	#define NCL_PROFILE_FRAME()
+#endif
+
+namespace NCL {
+	struct ProfileEvent {
+		const char*	name;	//Must be a string literal, or otherwise last forever
+		long long	start;	//Nanoseconds since the profiler started
+		long long	end;
+		int			depth;	//How many scopes this one is inside of, on its thread
+		int			thread;
+	};
+
+	//One line of the per frame summary - all of the calls to a scope from the
+	//same parent scope, on the same thread, added together
+	struct ProfileSummaryEntry {
+		const char*	name;
+		int			depth;
+		int			thread;
+		float		totalMS;
+		int			calls;
+	};
+
+	class Profiler {
+	public:
+		//Recording can be turned off at runtime too - the scopes then only check a flag
+		static void SetEnabled(bool state) {
+			enabled.store(state, std::memory_order_relaxed);
+		}
+		static bool IsEnabled() {
+			return enabled.load(std::memory_order_relaxed);
+		}
+
+		//Gathers up everything recorded since the last call, and builds the summary
+		static void EndFrame();
+
+		//What the last frame looked like, as a tree in depth first order
+		static const std::vector<ProfileSummaryEntry>& GetFrameSummary() {
+			return summary;
+		}
+		static float GetFrameTimeMS() {
+			return frameTimeMS;
+		}
+		//The thread EndFrame gets called from - the others have their own
+		//entries in the summary, after the main thread's
+		static int GetMainThread() {
+			return mainThread;
+		}
+		//Events lost as a thread's buffer filled up before the frame ended
+		static int GetDroppedEvents() {
+			return droppedEvents;
+		}
+
+		//Keeps every frame's events from now on (or for the next 'frames' frames
+		//if it's more than 0), until StopCapture, to write out as a trace
+		static void StartCapture(int frames = 0);
+		static void StopCapture();
+		static bool IsCapturing() {
+			return capturing;
+		}
+
+		//Writes the captured frames in the Chrome tracing JSON format, ready to
+		//open in chrome://tracing, edge://tracing or ui.perfetto.dev
+		static bool WriteChromeTrace(const std::string& filename);
+
+		static long long GetTime();
+
+		//Used by ProfileScope - EnterScope returns how deep the new scope is,
+		//and RecordEvent puts the thread back to that depth
+		static int	EnterScope();
+		static void RecordEvent(const char* name, long long start, long long end, int depth);
+
+	protected:
+		Profiler() {}
+		~Profiler() {}
+
+		static void BuildSummary(std::vector<ProfileEvent>& events);
+
+		static std::atomic<bool>	enabled;
+
+		static std::vector<ProfileSummaryEntry>	summary;
+		static std::vector<ProfileEvent>		frameEvents;
+		static std::vector<ProfileEvent>		capturedEvents;
+		static std::vector<long long>			capturedFrames;	//Start time of each captured frame
+
+		static long long	frameStart;
+		static float		frameTimeMS;
+		static int			mainThread;
+		static int			droppedEvents;
+		static bool			capturing;
+		static int			captureFramesLeft;
+	};
+
+	class ProfileScope {
+	public:
+		ProfileScope(const char* scopeName) {
+			if (!Profiler::IsEnabled()) {
+				name = nullptr;
+				return;
+			}
+			name	= scopeName;
+			depth	= Profiler::EnterScope();
+			start	= Profiler::GetTime();
+		}
+		~ProfileScope() {
+			if (name) {
+				Profiler::RecordEvent(name, start, Profiler::GetTime(), depth);
+			}
+		}
+
+	protected:
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+		const char*	name;
+		long long	start;
+		int			depth;
+	};
+}
@@ -76,10 +76,22 @@ Quaternion::~Quaternion(void)
 }
 
 float Quaternion::Dot(const Quaternion &a,const Quaternion &b){
+#if defined(NCL_SIMD_SSE2)
+	return _mm_cvtss_f32(SIMD::Dot4(a.ToSIMD(), b.ToSIMD()));
+#else
 	return (a.x * b.x) + (a.y * b.y) + (a.z * b.z) + (a.w * b.w);
+#endif
 }
 
 void Quaternion::Normalise(){
+#if defined(NCL_SIMD_SSE2)
+	__m128 q			= ToSIMD();
+	__m128 magnitude	= _mm_sqrt_ps(SIMD::Dot4(q, q));
+
+	if (_mm_cvtss_f32(magnitude) > 0.0f) {
+		SIMD::Store(array, _mm_mul_ps(q, _mm_div_ps(_mm_set1_ps(1.0f), magnitude)));
+	}
+#else
 	float magnitude = sqrt(x*x + y*y + z*z + w*w);
 
 	if(magnitude > 0.0f){
@@ -90,6 +102,7 @@ void Quaternion::Normalise(){
 		z *= t;
 		w *= t;
 	}
+#endif
 }
 
 void Quaternion::CalculateW()	{
@@ -104,7 +117,11 @@ void Quaternion::CalculateW()	{
 
 Quaternion Quaternion::Conjugate() const
 {
+#if defined(NCL_SIMD_SSE2)
+	return Quaternion(_mm_xor_ps(ToSIMD(), _mm_set_ps(0.0f, -0.0f, -0.0f, -0.0f)));
+#else
 	return Quaternion(-x,-y,-z,w);
+#endif
 }
 
 Quaternion Quaternion::Lerp(const Quaternion &from, const Quaternion &to, float by) {
@@ -128,7 +145,7 @@ Quaternion Quaternion::Slerp(const Quaternion &from, const Quaternion &to, float
 		temp = -to;
 	}
 
-	return (from * (cos(by))) + (to * (1.0f - cos(by)));
+	return (from * (Maths::Cos(by))) + (to * (1.0f - Maths::Cos(by)));
 }
 
 //http://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles
@@ -140,7 +157,7 @@ Vector3 Quaternion::ToEuler() const {
 
 	if (t > 0.4999) {
 		euler.z = Maths::RadiansToDegrees(Maths::PI / 2.0f);
-		euler.y = Maths::RadiansToDegrees(2.0f * atan2(x, w));
+		euler.y = Maths::RadiansToDegrees(2.0f * Maths::Atan2(x, w));
 		euler.x = 0.0f;
 
 		return euler;
@@ -148,7 +165,7 @@ Vector3 Quaternion::ToEuler() const {
 
 	if (t < -0.4999) {
 		euler.z = -Maths::RadiansToDegrees(Maths::PI / 2.0f);
-		euler.y = -Maths::RadiansToDegrees(2.0f * atan2(x, w));
+		euler.y = -Maths::RadiansToDegrees(2.0f * Maths::Atan2(x, w));
 		euler.x = 0.0f;
 		return euler;
 	}
@@ -157,9 +174,9 @@ Vector3 Quaternion::ToEuler() const {
 	float sqy = y*y;
 	float sqz = z*z;
 
-	euler.z = Maths::RadiansToDegrees(asin(2 * t));
-	euler.y = Maths::RadiansToDegrees(atan2(2 * y*w - 2 * x*z, 1.0f - 2 * sqy - 2 * sqz));
-	euler.x = Maths::RadiansToDegrees(atan2(2 * x*w - 2 * y*z, 1.0f - 2 * sqx - 2.0f*sqz));
+	euler.z = Maths::RadiansToDegrees(Maths::Asin(2 * t));
+	euler.y = Maths::RadiansToDegrees(Maths::Atan2(2 * y*w - 2 * x*z, 1.0f - 2 * sqy - 2 * sqz));
+	euler.x = Maths::RadiansToDegrees(Maths::Atan2(2 * x*w - 2 * y*z, 1.0f - 2 * sqx - 2.0f*sqz));
 
 	return euler;
 }
@@ -167,13 +184,13 @@ Vector3 Quaternion::ToEuler() const {
 //http://www.euclideanspace.com/maths/geometry/rotations/conversions/eulerToQuaternion/
 //VERIFIED AS CORRECT - Pitch and roll are changed around as the above uses x as 'forward', whereas we use -z
 Quaternion Quaternion::EulerAnglesToQuaternion(float roll, float yaw, float pitch) {
-	float cos1 = (float)cos(Maths::DegreesToRadians(yaw   * 0.5f));
-	float cos2 = (float)cos(Maths::DegreesToRadians(pitch * 0.5f));
-	float cos3 = (float)cos(Maths::DegreesToRadians(roll  * 0.5f));
+	float cos1 = (float)Maths::Cos(Maths::DegreesToRadians(yaw   * 0.5f));
+	float cos2 = (float)Maths::Cos(Maths::DegreesToRadians(pitch * 0.5f));
+	float cos3 = (float)Maths::Cos(Maths::DegreesToRadians(roll  * 0.5f));
 
-	float sin1 = (float)sin(Maths::DegreesToRadians(yaw   * 0.5f));
-	float sin2 = (float)sin(Maths::DegreesToRadians(pitch * 0.5f));
-	float sin3 = (float)sin(Maths::DegreesToRadians(roll  * 0.5f));
+	float sin1 = (float)Maths::Sin(Maths::DegreesToRadians(yaw   * 0.5f));
+	float sin2 = (float)Maths::Sin(Maths::DegreesToRadians(pitch * 0.5f));
+	float sin3 = (float)Maths::Sin(Maths::DegreesToRadians(roll  * 0.5f));
 
 	Quaternion q;
 
@@ -187,13 +204,23 @@ Quaternion Quaternion::EulerAnglesToQuaternion(float roll, float yaw, float pitc
 
 Quaternion Quaternion::AxisAngleToQuaterion(const Vector3& vector, float degrees) {
 	float theta		= (float)Maths::DegreesToRadians(degrees);
-	float result	= (float)sin(theta / 2.0f);
+	float result	= (float)Maths::Sin(theta / 2.0f);
 
-	return Quaternion((float)(vector.x * result), (float)(vector.y * result), (float)(vector.z * result), (float)cos(theta / 2.0f));
+	return Quaternion((float)(vector.x * result), (float)(vector.y * result), (float)(vector.z * result), (float)Maths::Cos(theta / 2.0f));
 }
 
 
 Vector3		Quaternion::operator *(const Vector3 &a)	const {
+#if defined(NCL_SIMD_SSE2)
+	__m128 q		= ToSIMD();
+	__m128 conj		= _mm_xor_ps(q, _mm_set_ps(0.0f, -0.0f, -0.0f, -0.0f));
+	__m128 newVec	= SIMD::QuaternionMultiply(SIMD::QuaternionMultiply(q, SIMD::Load3(a.array)), conj);
+
+	Vector3 result;
+	SIMD::Store3(result.array, newVec);
+	return result;
+#else
 	Quaternion newVec = *this * Quaternion(a.x, a.y, a.z, 0.0f) * Conjugate();
 	return Vector3(newVec.x, newVec.y, newVec.z);
+#endif
 }
\ No newline at end of file
@@ -8,6 +8,7 @@ https://research.ncl.ac.uk/game/
 */
 #pragma once
 #include <iostream>
+#include "SIMD.h"
 
 namespace NCL {
 	namespace Maths {
@@ -15,7 +16,7 @@ namespace NCL {
 		class Matrix4;
 		class Vector3;
 
-		class Quaternion {
+		class NCL_SIMD_ALIGN Quaternion {
 		public:
 			union {
 				struct {
@@ -36,6 +37,16 @@ namespace NCL {
 
 			~Quaternion(void);
 
+#if defined(NCL_SIMD_SSE2)
+			explicit Quaternion(__m128 v) {
+				SIMD::Store(array, v);
+			}
+
+			inline __m128 ToSIMD() const {
+				return SIMD::Load(array);
+			}
+#endif
+
 			void	Normalise();
 			
 			static float Dot(const Quaternion &a, const Quaternion &b);
@@ -64,6 +75,27 @@ namespace NCL {
 				return false;
 			}
 
+#if defined(NCL_SIMD_SSE2)
+			inline Quaternion  operator *(const Quaternion &b)	const {
+				return Quaternion(SIMD::QuaternionMultiply(ToSIMD(), b.ToSIMD()));
+			}
+
+			inline Quaternion  operator *(const float &a)		const {
+				return Quaternion(_mm_mul_ps(ToSIMD(), _mm_set1_ps(a)));
+			}
+
+			inline Quaternion  operator -()	const {
+				return Quaternion(_mm_xor_ps(ToSIMD(), _mm_set1_ps(-0.0f)));
+			}
+
+			inline Quaternion  operator -(const Quaternion &a)	const {
+				return Quaternion(_mm_sub_ps(ToSIMD(), a.ToSIMD()));
+			}
+
+			inline Quaternion  operator +(const Quaternion &a)	const {
+				return Quaternion(_mm_add_ps(ToSIMD(), a.ToSIMD()));
+			}
+#else
 			inline Quaternion  operator *(const Quaternion &b)	const {
 				return Quaternion(
 					(x * b.w) + (w * b.x) + (y * b.z) - (z * b.y),
@@ -73,17 +105,10 @@ namespace NCL {
 				);
 			}
 
-			Vector3		operator *(const Vector3 &a)	const;
-
 			inline Quaternion  operator *(const float &a)		const {
 				return Quaternion(x*a, y*a, z*a, w*a);
 			}
 
-			inline Quaternion  operator *=(const float &a) {
-				*this = *this * a;
-				return *this;
-			}
-
 			inline Quaternion  operator -()	const {
 				return Quaternion(-x, -y, -z, -w);
 			}
@@ -92,13 +117,21 @@ namespace NCL {
 				return Quaternion(x - a.x, y - a.y, z - a.z, w - a.w);
 			}
 
-			inline Quaternion  operator -=(const Quaternion &a) {
-				*this = *this - a;
+			inline Quaternion  operator +(const Quaternion &a)	const {
+				return Quaternion(x + a.x, y + a.y, z + a.z, w + a.w);
+			}
+#endif
+
+			Vector3		operator *(const Vector3 &a)	const;
+
+			inline Quaternion  operator *=(const float &a) {
+				*this = *this * a;
 				return *this;
 			}
 
-			inline Quaternion  operator +(const Quaternion &a)	const {
-				return Quaternion(x + a.x, y + a.y, z + a.z, w + a.w);
+			inline Quaternion  operator -=(const Quaternion &a) {
+				*this = *this - a;
+				return *this;
 			}
 
 			inline Quaternion  operator +=(const Quaternion &a) {
@@ -12,6 +12,10 @@ _-_-_-_-_-_-_-""  ""
 *//////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "Window.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include "FrameArena.h"
+#include <cstring>
 
 namespace NCL {
 	namespace Rendering {
@@ -42,9 +46,24 @@ namespace NCL {
 				return false;
 			}
 
+			//Debug text and lines - renderers that can't draw them can just ignore them.
+			//Text is copied into the frame arena, so it only has to last for the call
+			void DrawString(const std::string& text, const Vector2& pos, const Vector4& colour = Vector4(0.75f, 0.75f, 0.75f, 1), float size = 20.0f) {
+				AddDebugString(FrameString(text.c_str(), text.length()), pos, colour, size);
+			}
+			void DrawString(const char* text, const Vector2& pos, const Vector4& colour = Vector4(0.75f, 0.75f, 0.75f, 1), float size = 20.0f) {
+				AddDebugString(FrameString(text, strlen(text)), pos, colour, size);
+			}
+			void DrawString(const FrameString& text, const Vector2& pos, const Vector4& colour = Vector4(0.75f, 0.75f, 0.75f, 1), float size = 20.0f) {
+				AddDebugString(text, pos, colour, size);
+			}
+			virtual void DrawLine(const Vector3& start, const Vector3& end, const Vector4& colour) {}
+
 		protected:
 			virtual void OnWindowResize(int w, int h) = 0;
 			virtual void OnWindowDetach() {}; //Most renderers won't care about this
+
+			virtual void AddDebugString(const FrameString& text, const Vector2& pos, const Vector4& colour, float size) {}
 			
 			virtual void BeginFrame()	= 0;
 			virtual void RenderFrame()	= 0;
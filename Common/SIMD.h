@@ -0,0 +1,194 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+
+/*
+
+Picks which instruction set the maths classes are built with. This is all
+decided at compile time, from whatever the compiler has been told it can
+target:
+
+	NCL_SIMD_AVX2	- /arch:AVX2 or -mavx2 (-mfma too, to get fused multiply-adds)
+	NCL_SIMD_SSE4	- /arch:AVX or -msse4.1, gets a single instruction dot product
+	NCL_SIMD_SSE2	- every x64 compiler, so this is what a default build gets
+	neither			- plain C++, for anything that isn't x86
+
+Defining NCL_SIMD_SCALAR in the project settings forces the plain C++ path,
+which is handy for checking whether a bug is in the SIMD code or not.
+
+Defining NCL_DETERMINISTIC makes every backend give bit for bit the same
+results as the plain C++ path, for lockstep networking and replays: no fused
+multiply-adds (in the SIMD code or from the compiler), dot products summed
+in the same order as the scalar code, and the trig functions in Maths.h
+swapped for ones that don't depend on the C runtime. Build with /fp:precise
+(or /fp:strict) and never /fp:fast, or -ffp-contract=off and no -ffast-math.
+
+Loads and stores are always unaligned, so nothing breaks if a Vector4 ends up
+on an 8 byte boundary (32 bit builds, or anything packed into a struct by hand)
+- on anything newer than about 2010 they cost the same as aligned ones.
+
+*/
+#if !defined(NCL_SIMD_SCALAR)
+	#if defined(__AVX2__)
+		#define NCL_SIMD_AVX2
+	#endif
+	#if defined(NCL_SIMD_AVX2) || defined(__AVX__) || defined(__SSE4_1__)
+		#define NCL_SIMD_SSE4
+	#endif
+	#if defined(NCL_SIMD_SSE4) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define NCL_SIMD_SSE2
+	#endif
+#endif
+
+#if defined(NCL_SIMD_AVX2) && (defined(__FMA__) || defined(_MSC_VER)) && !defined(NCL_DETERMINISTIC)
+	#define NCL_SIMD_FMA
+#endif
+
+#if defined(NCL_DETERMINISTIC)
+	#if defined(__FAST_MATH__)
+		#error NCL_DETERMINISTIC does not work with -ffast-math
+	#endif
+	#if (defined(_M_IX86_FP) && _M_IX86_FP < 2) || (defined(__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ != 0)
+		#error NCL_DETERMINISTIC needs SSE2 floating point, x87 rounds differently
+	#endif
+	//Stops the compiler fusing a * b + c on its own, in anything using the maths classes
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#pragma fp_contract(off)
+	#elif defined(__clang__)
+		#pragma STDC FP_CONTRACT OFF
+	#endif
+#endif
+
+#if defined(NCL_SIMD_SSE4)
+	#include <smmintrin.h>
+#elif defined(NCL_SIMD_SSE2)
+	#include <emmintrin.h>
+#endif
+#if defined(NCL_SIMD_FMA)
+	#include <immintrin.h>
+#endif
+
+//Only 64 bit builds are guaranteed 16 byte aligned heap memory (and by-value
+//parameters), so that's the only place the vector types ask for it
+#if defined(NCL_SIMD_SSE2) && (defined(_M_X64) || defined(__x86_64__))
+	#define NCL_SIMD_ALIGN alignas(16)
+#else
+	#define NCL_SIMD_ALIGN
+#endif
+
+namespace NCL {
+	namespace Maths {
+		namespace SIMD {
+			inline const char* GetBackendName() {
+#if defined(NCL_SIMD_FMA)
+				return "AVX2+FMA";
+#elif defined(NCL_SIMD_AVX2)
+				return "AVX2";
+#elif defined(NCL_SIMD_SSE4)
+				return "SSE4.1";
+#elif defined(NCL_SIMD_SSE2)
+				return "SSE2";
+#else
+				return "Scalar";
+#endif
+			}
+
+#if defined(NCL_SIMD_SSE2)
+			inline __m128 Load(const float* f) {
+				return _mm_loadu_ps(f);
+			}
+
+			inline void Store(float* f, __m128 v) {
+				_mm_storeu_ps(f, v);
+			}
+
+			//For 3 component vectors, the w lane is set to 0
+			inline __m128 Load3(const float* f) {
+				return _mm_set_ps(0.0f, f[2], f[1], f[0]);
+			}
+
+			inline void Store3(float* f, __m128 v) {
+				_mm_storel_pi((__m64*)f, v);
+				_mm_store_ss(f + 2, _mm_movehl_ps(v, v));
+			}
+
+			template<int x, int y, int z, int w>
+			inline __m128 Swizzle(__m128 v) {
+				return _mm_shuffle_ps(v, v, _MM_SHUFFLE(w, z, y, x));
+			}
+
+			//a * b + c
+			inline __m128 MulAdd(__m128 a, __m128 b, __m128 c) {
+#if defined(NCL_SIMD_FMA)
+				return _mm_fmadd_ps(a, b, c);
+#else
+				return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+			}
+
+			//The dot product of all 4 lanes, in all 4 lanes
+			inline __m128 Dot4(__m128 a, __m128 b) {
+#if defined(NCL_DETERMINISTIC)
+				//((x + y) + z) + w, as the scalar code does it
+				__m128 m = _mm_mul_ps(a, b);
+				__m128 s = _mm_add_ss(m, Swizzle<1, 1, 1, 1>(m));
+				s = _mm_add_ss(s, Swizzle<2, 2, 2, 2>(m));
+				s = _mm_add_ss(s, Swizzle<3, 3, 3, 3>(m));
+				return Swizzle<0, 0, 0, 0>(s);
+#elif defined(NCL_SIMD_SSE4)
+				return _mm_dp_ps(a, b, 0xFF);
+#else
+				__m128 m = _mm_mul_ps(a, b);
+				m = _mm_add_ps(m, Swizzle<1, 0, 3, 2>(m));
+				return _mm_add_ps(m, Swizzle<2, 3, 0, 1>(m));
+#endif
+			}
+
+			//The dot product of x, y and z, in all 4 lanes
+			inline __m128 Dot3(__m128 a, __m128 b) {
+#if defined(NCL_SIMD_SSE4) && !defined(NCL_DETERMINISTIC)
+				return _mm_dp_ps(a, b, 0x7F);
+#else
+				__m128 m = _mm_mul_ps(a, b);
+				__m128 s = _mm_add_ss(m, Swizzle<1, 1, 1, 1>(m));
+				s = _mm_add_ss(s, Swizzle<2, 2, 2, 2>(m));
+				return Swizzle<0, 0, 0, 0>(s);
+#endif
+			}
+
+			//w comes out as 0, as long as a.w and b.w are finite
+			inline __m128 Cross3(__m128 a, __m128 b) {
+				__m128 l = _mm_mul_ps(Swizzle<1, 2, 0, 3>(a), Swizzle<2, 0, 1, 3>(b));
+				__m128 r = _mm_mul_ps(Swizzle<2, 0, 1, 3>(a), Swizzle<1, 2, 0, 3>(b));
+				return _mm_sub_ps(l, r);
+			}
+
+			/*
+			The Hamilton product, for xyzw quaternions. The terms are added up in
+			the same order as the scalar version, so (without FMA) the results
+			are bit for bit the same.
+			*/
+			inline __m128 QuaternionMultiply(__m128 a, __m128 b) {
+				const __m128 flipW = _mm_castsi128_ps(_mm_set_epi32((int)0x80000000, 0, 0, 0));
+
+				__m128 r = _mm_mul_ps(a, Swizzle<3, 3, 3, 3>(b));
+
+				__m128 t = _mm_mul_ps(Swizzle<3, 3, 3, 0>(a), Swizzle<0, 1, 2, 0>(b));
+				r = _mm_add_ps(r, _mm_xor_ps(t, flipW));
+
+				t = _mm_mul_ps(Swizzle<1, 2, 0, 1>(a), Swizzle<2, 0, 1, 1>(b));
+				r = _mm_add_ps(r, _mm_xor_ps(t, flipW));
+
+				t = _mm_mul_ps(Swizzle<2, 0, 1, 2>(a), Swizzle<1, 2, 0, 2>(b));
+				return _mm_sub_ps(r, t);
+			}
+#endif
+		}
+	}
+}
@@ -0,0 +1,638 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#include "SIMDKernels.h"
+#include <cmath>
+#include <cstring>
+
+/*
+Each instruction set's versions are compiled for just that instruction set,
+whatever the rest of the project is built with - MSVC lets any function use
+any intrinsic, GCC and Clang need to be told per function.
+*/
+#if defined(NCL_CPU_X86)
+	#include <immintrin.h>
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#define NCL_TARGET(isa)
+	#else
+		#define NCL_TARGET(isa) __attribute__((target(isa)))
+	#endif
+#endif
+
+//AVX-512 brings FMA along with it, and GCC would otherwise happily fuse the
+//multiplies and adds there, so that level would no longer match the others
+#if defined(__GNUC__) && !defined(__clang__)
+	#pragma GCC optimize("fp-contract=off")
+#endif
+
+using namespace NCL;
+using namespace NCL::Maths;
+using namespace NCL::Maths::SIMD;
+
+void AABBArray::Clear() {
+	posX.clear();
+	posY.clear();
+	posZ.clear();
+	halfX.clear();
+	halfY.clear();
+	halfZ.clear();
+}
+
+void AABBArray::Reserve(size_t count) {
+	posX.reserve(count);
+	posY.reserve(count);
+	posZ.reserve(count);
+	halfX.reserve(count);
+	halfY.reserve(count);
+	halfZ.reserve(count);
+}
+
+void AABBArray::Add(const Vector3& position, const Vector3& halfSize) {
+	posX.emplace_back(position.x);
+	posY.emplace_back(position.y);
+	posZ.emplace_back(position.z);
+	halfX.emplace_back(halfSize.x);
+	halfY.emplace_back(halfSize.y);
+	halfZ.emplace_back(halfSize.z);
+}
+
+namespace {
+	/*
+	The plain C++ versions. These also finish off whatever is left over at
+	the end of the arrays for the others, so everything else is written to
+	match them exactly.
+	*/
+
+	//As minps and maxps do it, so NaNs come out the same way
+	inline float Min(float a, float b) {
+		return a < b ? a : b;
+	}
+
+	inline float Max(float a, float b) {
+		return a > b ? a : b;
+	}
+
+	inline bool BoxOverlaps(const Vector3& p, const Vector3& h, const AABBArray& boxes, size_t i) {
+		return	std::abs(boxes.posX[i] - p.x) < boxes.halfX[i] + h.x &&
+				std::abs(boxes.posY[i] - p.y) < boxes.halfY[i] + h.y &&
+				std::abs(boxes.posZ[i] - p.z) < boxes.halfZ[i] + h.z;
+	}
+
+	struct SlabRay {
+		float pos[3];
+		float invDir[3];
+		float maxDistance;
+	};
+
+	SlabRay MakeRay(const Vector3& rayPos, const Vector3& rayDir, float maxDistance) {
+		SlabRay r;
+		for (int i = 0; i < 3; ++i) {
+			r.pos[i]	= rayPos[i];
+			//Big rather than infinite, so that 0 * it can't make a NaN
+			r.invDir[i] = rayDir[i] != 0.0f ? 1.0f / rayDir[i] : 1e30f;
+		}
+		r.maxDistance = maxDistance;
+		return r;
+	}
+
+	inline bool RayHitsBox(const SlabRay& r, const AABBArray& boxes, size_t i, float& distance) {
+		const float* pos[3]		= { boxes.posX.data(),  boxes.posY.data(),  boxes.posZ.data() };
+		const float* half[3]	= { boxes.halfX.data(), boxes.halfY.data(), boxes.halfZ.data() };
+
+		float tNear[3];
+		float tFar[3];
+		for (int a = 0; a < 3; ++a) {
+			float t1 = ((pos[a][i] - half[a][i]) - r.pos[a]) * r.invDir[a];
+			float t2 = ((pos[a][i] + half[a][i]) - r.pos[a]) * r.invDir[a];
+			tNear[a]	= Min(t1, t2);
+			tFar[a]		= Max(t1, t2);
+		}
+		float entry	= Max(Max(tNear[0], tNear[1]), tNear[2]);
+		float exit	= Min(Min(tFar[0], tFar[1]), tFar[2]);
+		distance	= Max(entry, 0.0f);
+		return exit >= distance && entry <= r.maxDistance;
+	}
+
+	void MultiplyMatricesScalar(const Matrix4& a, const Matrix4* b, Matrix4* out, size_t count) {
+		const float* m = a.array;
+		for (size_t i = 0; i < count; ++i) {
+			const float* in = b[i].array;
+			float result[16];
+			for (int c = 0; c < 4; ++c) {
+				for (int r = 0; r < 4; ++r) {
+					float v = m[r] * in[c * 4];
+					v = v + m[4 + r]	* in[c * 4 + 1];
+					v = v + m[8 + r]	* in[c * 4 + 2];
+					v = v + m[12 + r]	* in[c * 4 + 3];
+					result[c * 4 + r] = v;
+				}
+			}
+			memcpy(out[i].array, result, sizeof(result));
+		}
+	}
+
+	size_t OverlapAABBsScalar(const Vector3& p, const Vector3& h, const AABBArray& boxes, size_t first, int* results) {
+		size_t found = 0;
+		for (size_t i = first; i < boxes.Size(); ++i) {
+			if (BoxOverlaps(p, h, boxes, i)) {
+				results[found++] = (int)i;
+			}
+		}
+		return found;
+	}
+
+	size_t RayAABBsFrom(const SlabRay& r, const AABBArray& boxes, size_t first, int* hits, float* distances) {
+		size_t found = 0;
+		for (size_t i = first; i < boxes.Size(); ++i) {
+			float distance;
+			if (RayHitsBox(r, boxes, i, distance)) {
+				hits[found]			= (int)i;
+				distances[found]	= distance;
+				found++;
+			}
+		}
+		return found;
+	}
+
+	size_t RayAABBsScalar(const Vector3& rayPos, const Vector3& rayDir, float maxDistance, const AABBArray& boxes, int* hits, float* distances) {
+		return RayAABBsFrom(MakeRay(rayPos, rayDir, maxDistance), boxes, 0, hits, distances);
+	}
+
+	void IntegrateParticlesScalar(PaddedVector3* positions, PaddedVector3* previousPositions, PaddedVector3* velocities,
+		const float* inverseMasses, size_t count, const Vector3& gravityStep, float damping, float dt) {
+		for (size_t i = 0; i < count; ++i) {
+			previousPositions[i] = positions[i];
+			if (inverseMasses[i] == 0.0f) {
+				continue;
+			}
+			for (int a = 0; a < 3; ++a) {
+				float v = (velocities[i][a] + gravityStep[a]) * damping;
+				velocities[i][a]	= v;
+				positions[i][a]		= positions[i][a] + v * dt;
+			}
+		}
+	}
+
+#if defined(NCL_CPU_X86)
+	/*
+	SSE2 - every x64 CPU has it
+	*/
+	NCL_TARGET("sse2")
+	void MultiplyMatricesSSE2(const Matrix4& a, const Matrix4* b, Matrix4* out, size_t count) {
+		const __m128 c0 = _mm_loadu_ps(a.array);
+		const __m128 c1 = _mm_loadu_ps(a.array + 4);
+		const __m128 c2 = _mm_loadu_ps(a.array + 8);
+		const __m128 c3 = _mm_loadu_ps(a.array + 12);
+
+		for (size_t i = 0; i < count; ++i) {
+			const float* in = b[i].array;
+			__m128 result[4];
+			for (int c = 0; c < 4; ++c) {
+				__m128 v = _mm_mul_ps(c0, _mm_set1_ps(in[c * 4]));
+				v = _mm_add_ps(v, _mm_mul_ps(c1, _mm_set1_ps(in[c * 4 + 1])));
+				v = _mm_add_ps(v, _mm_mul_ps(c2, _mm_set1_ps(in[c * 4 + 2])));
+				result[c] = _mm_add_ps(v, _mm_mul_ps(c3, _mm_set1_ps(in[c * 4 + 3])));
+			}
+			for (int c = 0; c < 4; ++c) {
+				_mm_storeu_ps(out[i].array + c * 4, result[c]);
+			}
+		}
+	}
+
+	NCL_TARGET("sse2")
+	size_t OverlapAABBsSSE2(const Vector3& p, const Vector3& h, const AABBArray& boxes, size_t first, int* results) {
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		const __m128 px = _mm_set1_ps(p.x), py = _mm_set1_ps(p.y), pz = _mm_set1_ps(p.z);
+		const __m128 hx = _mm_set1_ps(h.x), hy = _mm_set1_ps(h.y), hz = _mm_set1_ps(h.z);
+
+		size_t found	= 0;
+		size_t i		= first;
+		for (; i + 4 <= boxes.Size(); i += 4) {
+			__m128 dx = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(&boxes.posX[i]), px), absMask);
+			__m128 dy = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(&boxes.posY[i]), py), absMask);
+			__m128 dz = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(&boxes.posZ[i]), pz), absMask);
+
+			__m128 overlap = _mm_cmplt_ps(dx, _mm_add_ps(_mm_loadu_ps(&boxes.halfX[i]), hx));
+			overlap = _mm_and_ps(overlap, _mm_cmplt_ps(dy, _mm_add_ps(_mm_loadu_ps(&boxes.halfY[i]), hy)));
+			overlap = _mm_and_ps(overlap, _mm_cmplt_ps(dz, _mm_add_ps(_mm_loadu_ps(&boxes.halfZ[i]), hz)));
+
+			for (int bits = _mm_movemask_ps(overlap); bits; bits &= bits - 1) {
+				int lane = 0;
+				while (!(bits & (1 << lane))) {
+					lane++;
+				}
+				results[found++] = (int)(i + lane);
+			}
+		}
+		return found + OverlapAABBsScalar(p, h, boxes, i, results + found);
+	}
+
+	NCL_TARGET("sse2")
+	size_t RayAABBsSSE2(const Vector3& rayPos, const Vector3& rayDir, float maxDistance, const AABBArray& boxes, int* hits, float* distances) {
+		const SlabRay r = MakeRay(rayPos, rayDir, maxDistance);
+		const float* pos[3]		= { boxes.posX.data(),  boxes.posY.data(),  boxes.posZ.data() };
+		const float* half[3]	= { boxes.halfX.data(), boxes.halfY.data(), boxes.halfZ.data() };
+		const __m128 zero		= _mm_setzero_ps();
+		const __m128 maxDist	= _mm_set1_ps(maxDistance);
+
+		size_t found	= 0;
+		size_t i		= 0;
+		for (; i + 4 <= boxes.Size(); i += 4) {
+			__m128 tNear[3];
+			__m128 tFar[3];
+			for (int a = 0; a < 3; ++a) {
+				__m128 p	= _mm_loadu_ps(pos[a] + i);
+				__m128 h	= _mm_loadu_ps(half[a] + i);
+				__m128 o	= _mm_set1_ps(r.pos[a]);
+				__m128 inv	= _mm_set1_ps(r.invDir[a]);
+				__m128 t1	= _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(p, h), o), inv);
+				__m128 t2	= _mm_mul_ps(_mm_sub_ps(_mm_add_ps(p, h), o), inv);
+				tNear[a]	= _mm_min_ps(t1, t2);
+				tFar[a]		= _mm_max_ps(t1, t2);
+			}
+			__m128 entry	= _mm_max_ps(_mm_max_ps(tNear[0], tNear[1]), tNear[2]);
+			__m128 exit		= _mm_min_ps(_mm_min_ps(tFar[0], tFar[1]), tFar[2]);
+			__m128 distance = _mm_max_ps(entry, zero);
+			__m128 hit		= _mm_and_ps(_mm_cmpge_ps(exit, distance), _mm_cmple_ps(entry, maxDist));
+
+			int bits = _mm_movemask_ps(hit);
+			if (bits) {
+				float d[4];
+				_mm_storeu_ps(d, distance);
+				for (int lane = 0; lane < 4; ++lane) {
+					if (bits & (1 << lane)) {
+						hits[found]			= (int)(i + lane);
+						distances[found]	= d[lane];
+						found++;
+					}
+				}
+			}
+		}
+		return found + RayAABBsFrom(r, boxes, i, hits + found, distances + found);
+	}
+
+	NCL_TARGET("sse2")
+	void IntegrateParticlesSSE2(PaddedVector3* positions, PaddedVector3* previousPositions, PaddedVector3* velocities,
+		const float* inverseMasses, size_t count, const Vector3& gravityStep, float damping, float dt) {
+		const __m128 g = _mm_set_ps(0.0f, gravityStep.z, gravityStep.y, gravityStep.x);
+		const __m128 d = _mm_set1_ps(damping);
+		const __m128 t = _mm_set1_ps(dt);
+
+		for (size_t i = 0; i < count; ++i) {
+			__m128 p = _mm_loadu_ps(positions[i].array);
+			_mm_storeu_ps(previousPositions[i].array, p);
+			if (inverseMasses[i] == 0.0f) {
+				continue;
+			}
+			__m128 v = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocities[i].array), g), d);
+			_mm_storeu_ps(velocities[i].array, v);
+			_mm_storeu_ps(positions[i].array, _mm_add_ps(p, _mm_mul_ps(v, t)));
+		}
+	}
+
+	/*
+	SSE4.1 - only the integration gains anything from it, as blendv lets it
+	skip the branch on the inverse mass; the others use the SSE2 versions
+	*/
+	NCL_TARGET("sse4.1")
+	void IntegrateParticlesSSE41(PaddedVector3* positions, PaddedVector3* previousPositions, PaddedVector3* velocities,
+		const float* inverseMasses, size_t count, const Vector3& gravityStep, float damping, float dt) {
+		const __m128 g		= _mm_set_ps(0.0f, gravityStep.z, gravityStep.y, gravityStep.x);
+		const __m128 d		= _mm_set1_ps(damping);
+		const __m128 t		= _mm_set1_ps(dt);
+		const __m128 zero	= _mm_setzero_ps();
+
+		for (size_t i = 0; i < count; ++i) {
+			__m128 p		= _mm_loadu_ps(positions[i].array);
+			__m128 oldV		= _mm_loadu_ps(velocities[i].array);
+			__m128 moving	= _mm_cmpneq_ps(_mm_set1_ps(inverseMasses[i]), zero);
+
+			__m128 v = _mm_mul_ps(_mm_add_ps(oldV, g), d);
+			_mm_storeu_ps(previousPositions[i].array, p);
+			_mm_storeu_ps(velocities[i].array, _mm_blendv_ps(oldV, v, moving));
+			_mm_storeu_ps(positions[i].array, _mm_blendv_ps(p, _mm_add_ps(p, _mm_mul_ps(v, t)), moving));
+		}
+	}
+
+	/*
+	AVX2 - 8 boxes, or 2 matrix columns / particles, at a time. Each of these
+	clears the upper halves of the registers before going back to code that
+	might still be using the older SSE instructions, as mixing the two is slow
+	*/
+	NCL_TARGET("avx2")
+	inline __m256 MultiplyColumnsAVX2(__m256 c0, __m256 c1, __m256 c2, __m256 c3, __m256 b) {
+		__m256 v = _mm256_mul_ps(c0, _mm256_permute_ps(b, 0x00));
+		v = _mm256_add_ps(v, _mm256_mul_ps(c1, _mm256_permute_ps(b, 0x55)));
+		v = _mm256_add_ps(v, _mm256_mul_ps(c2, _mm256_permute_ps(b, 0xAA)));
+		return _mm256_add_ps(v, _mm256_mul_ps(c3, _mm256_permute_ps(b, 0xFF)));
+	}
+
+	NCL_TARGET("avx2")
+	void MultiplyMatricesAVX2(const Matrix4& a, const Matrix4* b, Matrix4* out, size_t count) {
+		const __m256 c0 = _mm256_broadcast_ps((const __m128*)a.array);
+		const __m256 c1 = _mm256_broadcast_ps((const __m128*)(a.array + 4));
+		const __m256 c2 = _mm256_broadcast_ps((const __m128*)(a.array + 8));
+		const __m256 c3 = _mm256_broadcast_ps((const __m128*)(a.array + 12));
+
+		for (size_t i = 0; i < count; ++i) {
+			//Columns 0 and 1 in one register, 2 and 3 in the other
+			__m256 lo = MultiplyColumnsAVX2(c0, c1, c2, c3, _mm256_loadu_ps(b[i].array));
+			__m256 hi = MultiplyColumnsAVX2(c0, c1, c2, c3, _mm256_loadu_ps(b[i].array + 8));
+			_mm256_storeu_ps(out[i].array, lo);
+			_mm256_storeu_ps(out[i].array + 8, hi);
+		}
+		_mm256_zeroupper();
+	}
+
+	NCL_TARGET("avx2")
+	size_t OverlapAABBsAVX2(const Vector3& p, const Vector3& h, const AABBArray& boxes, size_t first, int* results) {
+		const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+		const __m256 px = _mm256_set1_ps(p.x), py = _mm256_set1_ps(p.y), pz = _mm256_set1_ps(p.z);
+		const __m256 hx = _mm256_set1_ps(h.x), hy = _mm256_set1_ps(h.y), hz = _mm256_set1_ps(h.z);
+
+		size_t found	= 0;
+		size_t i		= first;
+		for (; i + 8 <= boxes.Size(); i += 8) {
+			__m256 dx = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(&boxes.posX[i]), px), absMask);
+			__m256 dy = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(&boxes.posY[i]), py), absMask);
+			__m256 dz = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(&boxes.posZ[i]), pz), absMask);
+
+			__m256 overlap = _mm256_cmp_ps(dx, _mm256_add_ps(_mm256_loadu_ps(&boxes.halfX[i]), hx), _CMP_LT_OQ);
+			overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(dy, _mm256_add_ps(_mm256_loadu_ps(&boxes.halfY[i]), hy), _CMP_LT_OQ));
+			overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(dz, _mm256_add_ps(_mm256_loadu_ps(&boxes.halfZ[i]), hz), _CMP_LT_OQ));
+
+			for (int bits = _mm256_movemask_ps(overlap); bits; bits &= bits - 1) {
+				int lane = 0;
+				while (!(bits & (1 << lane))) {
+					lane++;
+				}
+				results[found++] = (int)(i + lane);
+			}
+		}
+		_mm256_zeroupper();
+		return found + OverlapAABBsScalar(p, h, boxes, i, results + found);
+	}
+
+	NCL_TARGET("avx2")
+	size_t RayAABBsAVX2(const Vector3& rayPos, const Vector3& rayDir, float maxDistance, const AABBArray& boxes, int* hits, float* distances) {
+		const SlabRay r = MakeRay(rayPos, rayDir, maxDistance);
+		const float* pos[3]		= { boxes.posX.data(),  boxes.posY.data(),  boxes.posZ.data() };
+		const float* half[3]	= { boxes.halfX.data(), boxes.halfY.data(), boxes.halfZ.data() };
+		const __m256 zero		= _mm256_setzero_ps();
+		const __m256 maxDist	= _mm256_set1_ps(maxDistance);
+
+		size_t found	= 0;
+		size_t i		= 0;
+		for (; i + 8 <= boxes.Size(); i += 8) {
+			__m256 tNear[3];
+			__m256 tFar[3];
+			for (int a = 0; a < 3; ++a) {
+				__m256 p	= _mm256_loadu_ps(pos[a] + i);
+				__m256 h	= _mm256_loadu_ps(half[a] + i);
+				__m256 o	= _mm256_set1_ps(r.pos[a]);
+				__m256 inv	= _mm256_set1_ps(r.invDir[a]);
+				__m256 t1	= _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(p, h), o), inv);
+				__m256 t2	= _mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(p, h), o), inv);
+				tNear[a]	= _mm256_min_ps(t1, t2);
+				tFar[a]		= _mm256_max_ps(t1, t2);
+			}
+			__m256 entry	= _mm256_max_ps(_mm256_max_ps(tNear[0], tNear[1]), tNear[2]);
+			__m256 exit		= _mm256_min_ps(_mm256_min_ps(tFar[0], tFar[1]), tFar[2]);
+			__m256 distance = _mm256_max_ps(entry, zero);
+			__m256 hit		= _mm256_and_ps(_mm256_cmp_ps(exit, distance, _CMP_GE_OQ), _mm256_cmp_ps(entry, maxDist, _CMP_LE_OQ));
+
+			int bits = _mm256_movemask_ps(hit);
+			if (bits) {
+				float d[8];
+				_mm256_storeu_ps(d, distance);
+				for (int lane = 0; lane < 8; ++lane) {
+					if (bits & (1 << lane)) {
+						hits[found]			= (int)(i + lane);
+						distances[found]	= d[lane];
+						found++;
+					}
+				}
+			}
+		}
+		_mm256_zeroupper();
+		return found + RayAABBsFrom(r, boxes, i, hits + found, distances + found);
+	}
+
+	NCL_TARGET("avx2")
+	void IntegrateParticlesAVX2(PaddedVector3* positions, PaddedVector3* previousPositions, PaddedVector3* velocities,
+		const float* inverseMasses, size_t count, const Vector3& gravityStep, float damping, float dt) {
+		const __m256 g		= _mm256_set_ps(0.0f, gravityStep.z, gravityStep.y, gravityStep.x, 0.0f, gravityStep.z, gravityStep.y, gravityStep.x);
+		const __m256 d		= _mm256_set1_ps(damping);
+		const __m256 t		= _mm256_set1_ps(dt);
+		const __m256 zero	= _mm256_setzero_ps();
+
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2) {
+			__m256 p		= _mm256_loadu_ps(positions[i].array);
+			__m256 oldV		= _mm256_loadu_ps(velocities[i].array);
+			__m256 masses	= _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(inverseMasses[i])), _mm_set1_ps(inverseMasses[i + 1]), 1);
+			__m256 moving	= _mm256_cmp_ps(masses, zero, _CMP_NEQ_UQ);
+
+			__m256 v = _mm256_mul_ps(_mm256_add_ps(oldV, g), d);
+			_mm256_storeu_ps(previousPositions[i].array, p);
+			_mm256_storeu_ps(velocities[i].array, _mm256_blendv_ps(oldV, v, moving));
+			_mm256_storeu_ps(positions[i].array, _mm256_blendv_ps(p, _mm256_add_ps(p, _mm256_mul_ps(v, t)), moving));
+		}
+		_mm256_zeroupper();
+		IntegrateParticlesScalar(positions + i, previousPositions + i, velocities + i, inverseMasses + i, count - i, gravityStep, damping, dt);
+	}
+
+	/*
+	AVX-512 - 16 boxes, or a whole matrix / 4 particles, at a time
+
+	GCC builds the unmasked broadcast, permute, min and max on top of the
+	masked instructions, with an undefined vector as the source, which -Wall
+	warns about. They're used through the zero-masked forms instead, with
+	every lane selected, which come out the same.
+	*/
+	const __mmask16 allLanes = 0xFFFF;
+
+	NCL_TARGET("avx512f")
+	void MultiplyMatricesAVX512(const Matrix4& a, const Matrix4* b, Matrix4* out, size_t count) {
+		const __m512 c0 = _mm512_maskz_broadcast_f32x4(allLanes, _mm_loadu_ps(a.array));
+		const __m512 c1 = _mm512_maskz_broadcast_f32x4(allLanes, _mm_loadu_ps(a.array + 4));
+		const __m512 c2 = _mm512_maskz_broadcast_f32x4(allLanes, _mm_loadu_ps(a.array + 8));
+		const __m512 c3 = _mm512_maskz_broadcast_f32x4(allLanes, _mm_loadu_ps(a.array + 12));
+
+		for (size_t i = 0; i < count; ++i) {
+			__m512 m = _mm512_loadu_ps(b[i].array);
+			__m512 v = _mm512_mul_ps(c0, _mm512_maskz_permute_ps(allLanes, m, 0x00));
+			v = _mm512_add_ps(v, _mm512_mul_ps(c1, _mm512_maskz_permute_ps(allLanes, m, 0x55)));
+			v = _mm512_add_ps(v, _mm512_mul_ps(c2, _mm512_maskz_permute_ps(allLanes, m, 0xAA)));
+			v = _mm512_add_ps(v, _mm512_mul_ps(c3, _mm512_maskz_permute_ps(allLanes, m, 0xFF)));
+			_mm512_storeu_ps(out[i].array, v);
+		}
+		_mm256_zeroupper();
+	}
+
+	NCL_TARGET("avx512f")
+	size_t OverlapAABBsAVX512(const Vector3& p, const Vector3& h, const AABBArray& boxes, size_t first, int* results) {
+		const __m512 px = _mm512_set1_ps(p.x), py = _mm512_set1_ps(p.y), pz = _mm512_set1_ps(p.z);
+		const __m512 hx = _mm512_set1_ps(h.x), hy = _mm512_set1_ps(h.y), hz = _mm512_set1_ps(h.z);
+
+		size_t found	= 0;
+		size_t i		= first;
+		for (; i + 16 <= boxes.Size(); i += 16) {
+			__m512 dx = _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(&boxes.posX[i]), px));
+			__m512 dy = _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(&boxes.posY[i]), py));
+			__m512 dz = _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(&boxes.posZ[i]), pz));
+
+			__mmask16 overlap = _mm512_cmp_ps_mask(dx, _mm512_add_ps(_mm512_loadu_ps(&boxes.halfX[i]), hx), _CMP_LT_OQ);
+			overlap &= _mm512_cmp_ps_mask(dy, _mm512_add_ps(_mm512_loadu_ps(&boxes.halfY[i]), hy), _CMP_LT_OQ);
+			overlap &= _mm512_cmp_ps_mask(dz, _mm512_add_ps(_mm512_loadu_ps(&boxes.halfZ[i]), hz), _CMP_LT_OQ);
+
+			for (int bits = overlap; bits; bits &= bits - 1) {
+				int lane = 0;
+				while (!(bits & (1 << lane))) {
+					lane++;
+				}
+				results[found++] = (int)(i + lane);
+			}
+		}
+		_mm256_zeroupper();
+		return found + OverlapAABBsScalar(p, h, boxes, i, results + found);
+	}
+
+	NCL_TARGET("avx512f")
+	size_t RayAABBsAVX512(const Vector3& rayPos, const Vector3& rayDir, float maxDistance, const AABBArray& boxes, int* hits, float* distances) {
+		const SlabRay r = MakeRay(rayPos, rayDir, maxDistance);
+		const float* pos[3]		= { boxes.posX.data(),  boxes.posY.data(),  boxes.posZ.data() };
+		const float* half[3]	= { boxes.halfX.data(), boxes.halfY.data(), boxes.halfZ.data() };
+		const __m512 zero		= _mm512_setzero_ps();
+		const __m512 maxDist	= _mm512_set1_ps(maxDistance);
+
+		size_t found	= 0;
+		size_t i		= 0;
+		for (; i + 16 <= boxes.Size(); i += 16) {
+			__m512 tNear[3];
+			__m512 tFar[3];
+			for (int a = 0; a < 3; ++a) {
+				__m512 p	= _mm512_loadu_ps(pos[a] + i);
+				__m512 h	= _mm512_loadu_ps(half[a] + i);
+				__m512 o	= _mm512_set1_ps(r.pos[a]);
+				__m512 inv	= _mm512_set1_ps(r.invDir[a]);
+				__m512 t1	= _mm512_mul_ps(_mm512_sub_ps(_mm512_sub_ps(p, h), o), inv);
+				__m512 t2	= _mm512_mul_ps(_mm512_sub_ps(_mm512_add_ps(p, h), o), inv);
+				tNear[a]	= _mm512_maskz_min_ps(allLanes, t1, t2);
+				tFar[a]		= _mm512_maskz_max_ps(allLanes, t1, t2);
+			}
+			__m512 entry	= _mm512_maskz_max_ps(allLanes, _mm512_maskz_max_ps(allLanes, tNear[0], tNear[1]), tNear[2]);
+			__m512 exit		= _mm512_maskz_min_ps(allLanes, _mm512_maskz_min_ps(allLanes, tFar[0], tFar[1]), tFar[2]);
+			__m512 distance = _mm512_maskz_max_ps(allLanes, entry, zero);
+			__mmask16 hit	= _mm512_cmp_ps_mask(exit, distance, _CMP_GE_OQ) & _mm512_cmp_ps_mask(entry, maxDist, _CMP_LE_OQ);
+
+			if (hit) {
+				float d[16];
+				_mm512_storeu_ps(d, distance);
+				for (int lane = 0; lane < 16; ++lane) {
+					if (hit & (1 << lane)) {
+						hits[found]			= (int)(i + lane);
+						distances[found]	= d[lane];
+						found++;
+					}
+				}
+			}
+		}
+		_mm256_zeroupper();
+		return found + RayAABBsFrom(r, boxes, i, hits + found, distances + found);
+	}
+
+	NCL_TARGET("avx512f")
+	void IntegrateParticlesAVX512(PaddedVector3* positions, PaddedVector3* previousPositions, PaddedVector3* velocities,
+		const float* inverseMasses, size_t count, const Vector3& gravityStep, float damping, float dt) {
+		const __m512 g		= _mm512_maskz_broadcast_f32x4(allLanes, _mm_set_ps(0.0f, gravityStep.z, gravityStep.y, gravityStep.x));
+		const __m512 d		= _mm512_set1_ps(damping);
+		const __m512 t		= _mm512_set1_ps(dt);
+		const __m128 zero	= _mm_setzero_ps();
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m512 p	= _mm512_loadu_ps(positions[i].array);
+			__m512 oldV	= _mm512_loadu_ps(velocities[i].array);
+
+			//One bit per particle, spread out to cover its 4 lanes
+			int movingBits = _mm_movemask_ps(_mm_cmpneq_ps(_mm_loadu_ps(inverseMasses + i), zero));
+			__mmask16 moving = 0;
+			for (int j = 0; j < 4; ++j) {
+				if (movingBits & (1 << j)) {
+					moving |= (__mmask16)(0xF << (j * 4));
+				}
+			}
+			__m512 v = _mm512_mul_ps(_mm512_add_ps(oldV, g), d);
+			_mm512_storeu_ps(previousPositions[i].array, p);
+			_mm512_storeu_ps(velocities[i].array, _mm512_mask_mov_ps(oldV, moving, v));
+			_mm512_storeu_ps(positions[i].array, _mm512_mask_mov_ps(p, moving, _mm512_add_ps(p, _mm512_mul_ps(v, t))));
+		}
+		_mm256_zeroupper();
+		IntegrateParticlesScalar(positions + i, previousPositions + i, velocities + i, inverseMasses + i, count - i, gravityStep, damping, dt);
+	}
+#endif
+
+	struct KernelTable {
+		void	(*multiplyMatrices)(const Matrix4&, const Matrix4*, Matrix4*, size_t);
+		size_t	(*overlapAABBs)(const Vector3&, const Vector3&, const AABBArray&, size_t, int*);
+		size_t	(*rayAABBs)(const Vector3&, const Vector3&, float, const AABBArray&, int*, float*);
+		void	(*integrateParticles)(PaddedVector3*, PaddedVector3*, PaddedVector3*, const float*, size_t, const Vector3&, float, float);
+	};
+
+	const KernelTable kernelTables[(int)Level::MAX_LEVELS] = {
+		{ MultiplyMatricesScalar,	OverlapAABBsScalar, RayAABBsScalar, IntegrateParticlesScalar	},
+#if defined(NCL_CPU_X86)
+		{ MultiplyMatricesSSE2,		OverlapAABBsSSE2,	RayAABBsSSE2,	IntegrateParticlesSSE2		},
+		{ MultiplyMatricesSSE2,		OverlapAABBsSSE2,	RayAABBsSSE2,	IntegrateParticlesSSE41		},
+		{ MultiplyMatricesAVX2,		OverlapAABBsAVX2,	RayAABBsAVX2,	IntegrateParticlesAVX2		},
+		{ MultiplyMatricesAVX512,	OverlapAABBsAVX512, RayAABBsAVX512, IntegrateParticlesAVX512	},
+#else
+		{ MultiplyMatricesScalar,	OverlapAABBsScalar, RayAABBsScalar, IntegrateParticlesScalar	},
+		{ MultiplyMatricesScalar,	OverlapAABBsScalar, RayAABBsScalar, IntegrateParticlesScalar	},
+		{ MultiplyMatricesScalar,	OverlapAABBsScalar, RayAABBsScalar, IntegrateParticlesScalar	},
+		{ MultiplyMatricesScalar,	OverlapAABBsScalar, RayAABBsScalar, IntegrateParticlesScalar	},
+#endif
+	};
+
+	Level& CurrentLevel() {
+		static Level level = GetStartupLevel();
+		return level;
+	}
+
+	const KernelTable& Kernels() {
+		return kernelTables[(int)CurrentLevel()];
+	}
+}
+
+Level SIMD::GetKernelLevel() {
+	return CurrentLevel();
+}
+
+Level SIMD::SetKernelLevel(Level level) {
+	Level detected = DetectLevel();
+	CurrentLevel() = level > detected ? detected : level;
+	return CurrentLevel();
+}
+
+void SIMD::MultiplyMatrices(const Matrix4& a, const Matrix4* b, Matrix4* out, size_t count) {
+	Kernels().multiplyMatrices(a, b, out, count);
+}
+
+size_t SIMD::OverlapAABBs(const Vector3& position, const Vector3& halfSize, const AABBArray& boxes, size_t first, int* results) {
+	return Kernels().overlapAABBs(position, halfSize, boxes, first, results);
+}
+
+size_t SIMD::RayAABBs(const Vector3& rayPos, const Vector3& rayDir, float maxDistance, const AABBArray& boxes, int* hits, float* distances) {
+	return Kernels().rayAABBs(rayPos, rayDir, maxDistance, boxes, hits, distances);
+}
+
+void SIMD::IntegrateParticles(PaddedVector3* positions, PaddedVector3* previousPositions, PaddedVector3* velocities,
+	const float* inverseMasses, size_t count, const Vector3& gravityStep, float damping, float dt) {
+	Kernels().integrateParticles(positions, previousPositions, velocities, inverseMasses, count, gravityStep, damping, dt);
+}
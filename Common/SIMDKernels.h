@@ -0,0 +1,80 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include "CPUFeatures.h"
+#include "Vector3.h"
+#include "PaddedVector3.h"
+#include "Matrix4.h"
+#include <vector>
+
+namespace NCL {
+	namespace Maths {
+		namespace SIMD {
+			/*
+			Axis aligned boxes, stored as one array per component, so that the
+			kernels below can load 4, 8 or 16 of them at a time.
+			*/
+			class AABBArray {
+			public:
+				void Clear();
+				void Reserve(size_t count);
+				void Add(const Vector3& position, const Vector3& halfSize);
+
+				size_t Size() const {
+					return posX.size();
+				}
+
+				std::vector<float> posX;
+				std::vector<float> posY;
+				std::vector<float> posZ;
+				std::vector<float> halfX;
+				std::vector<float> halfY;
+				std::vector<float> halfZ;
+			};
+
+			/*
+			Loops that are worth having a version of for each instruction set.
+			The version used is picked the first time any of them is called (see
+			GetStartupLevel), so a binary built for plain SSE2 still gets AVX2 or
+			AVX-512 here on machines that have it.
+
+			None of them use fused multiply-adds, and each adds things up in the
+			same order at every level, so every level gives the same results.
+			*/
+
+			//The level the kernels are currently using
+			Level	GetKernelLevel();
+
+			//Switches to another level - anything higher than the CPU has is
+			//capped at what it does have. Returns the level actually used
+			Level	SetKernelLevel(Level level);
+
+			//out[i] = a * b[i]. out can be the same array as b
+			void	MultiplyMatrices(const Matrix4& a, const Matrix4* b, Matrix4* out, size_t count);
+
+			//Writes the index of every box from 'first' onwards that overlaps the given
+			//one into 'results' (which needs room for all of them), and returns how many
+			size_t	OverlapAABBs(const Vector3& position, const Vector3& halfSize, const AABBArray& boxes, size_t first, int* results);
+
+			//Slab tests a ray against every box, and writes the index of every box it
+			//enters within maxDistance into 'hits', and how far along the ray it
+			//enters it (0 if it starts inside) into 'distances'. Returns how many
+			size_t	RayAABBs(const Vector3& rayPos, const Vector3& rayDir, float maxDistance, const AABBArray& boxes, int* hits, float* distances);
+
+			/*
+			The prediction step of a position based integrator: every position is
+			copied to previousPositions, and then everything with an inverse mass
+			moves on by its velocity, after gravityStep has been added to it and
+			the result scaled by damping.
+			*/
+			void	IntegrateParticles(PaddedVector3* positions, PaddedVector3* previousPositions, PaddedVector3* velocities,
+				const float* inverseMasses, size_t count, const Vector3& gravityStep, float damping, float dt);
+		}
+	}
+}
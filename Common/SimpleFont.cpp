@@ -57,7 +57,7 @@ SimpleFont::~SimpleFont()
 	delete		texture;
 }
 
-int SimpleFont::BuildVerticesForString(std::string &text, Vector2&startPos, Vector4&colour, float size, std::vector<Vector3>&positions, std::vector<Vector2>&texCoords, std::vector<Vector4>&colours) {
+int SimpleFont::BuildVerticesForString(const FrameString& text, const Vector2& startPos, const Vector4& colour, float size, FrameVector<Vector3>& positions, FrameVector<Vector2>& texCoords, FrameVector<Vector4>& colours) {
 	int vertsWritten = 0;
 
 	int endChar = startChar + numChars;
@@ -8,6 +8,7 @@ https://research.ncl.ac.uk/game/
 */
 #pragma once
 #include <iostream>
+#include <cmath>
 
 namespace NCL {
 	namespace Maths {
@@ -8,13 +8,15 @@ https://research.ncl.ac.uk/game/
 */
 #pragma once
 #include <iostream>
+#include <cmath>
+#include "SIMD.h"
 
 namespace NCL {
 	namespace Maths {
 		class Vector3;
 		class Vector2;
 
-		class Vector4 {
+		class NCL_SIMD_ALIGN Vector4 {
 
 		public:
 			union {
@@ -37,6 +39,16 @@ namespace NCL {
 
 			~Vector4(void) {}
 
+#if defined(NCL_SIMD_SSE2)
+			explicit Vector4(__m128 v) {
+				SIMD::Store(array, v);
+			}
+
+			inline __m128 ToSIMD() const {
+				return SIMD::Load(array);
+			}
+#endif
+
 			Vector4 Normalised() const {
 				Vector4 temp(x, y, z, w);
 				temp.Normalise();
@@ -44,6 +56,13 @@ namespace NCL {
 			}
 
 			void			Normalise() {
+#if defined(NCL_SIMD_SSE2)
+				__m128 v		= ToSIMD();
+				__m128 length	= _mm_sqrt_ps(SIMD::Dot4(v, v));
+				if (_mm_cvtss_f32(length) != 0.0f) {
+					SIMD::Store(array, _mm_mul_ps(v, _mm_div_ps(_mm_set1_ps(1.0f), length)));
+				}
+#else
 				float length = Length();
 
 				if (length != 0.0f) {
@@ -53,10 +72,16 @@ namespace NCL {
 					z = z * length;
 					w = w * length;
 				}
+#endif
 			}
 
 			float	Length() const {
+#if defined(NCL_SIMD_SSE2)
+				__m128 v = ToSIMD();
+				return _mm_cvtss_f32(_mm_sqrt_ss(SIMD::Dot4(v, v)));
+#else
 				return sqrt((x*x) + (y*y) + (z*z) + (w * w));
+#endif
 			}
 
 			constexpr float	LengthSquared() const {
@@ -92,9 +117,42 @@ namespace NCL {
 			}
 
 			static float	Dot(const Vector4 &a, const Vector4 &b) {
+#if defined(NCL_SIMD_SSE2)
+				return _mm_cvtss_f32(SIMD::Dot4(a.ToSIMD(), b.ToSIMD()));
+#else
 				return (a.x*b.x) + (a.y*b.y) + (a.z*b.z) + (a.w*b.w);
+#endif
 			}
 
+#if defined(NCL_SIMD_SSE2)
+			inline Vector4  operator+(const Vector4  &a) const {
+				return Vector4(_mm_add_ps(ToSIMD(), a.ToSIMD()));
+			}
+
+			inline Vector4  operator-(const Vector4  &a) const {
+				return Vector4(_mm_sub_ps(ToSIMD(), a.ToSIMD()));
+			}
+
+			inline Vector4  operator-() const {
+				return Vector4(_mm_xor_ps(ToSIMD(), _mm_set1_ps(-0.0f)));
+			}
+
+			inline Vector4  operator*(float a)	const {
+				return Vector4(_mm_mul_ps(ToSIMD(), _mm_set1_ps(a)));
+			}
+
+			inline Vector4  operator*(const Vector4  &a) const {
+				return Vector4(_mm_mul_ps(ToSIMD(), a.ToSIMD()));
+			}
+
+			inline Vector4  operator/(const Vector4  &a) const {
+				return Vector4(_mm_div_ps(ToSIMD(), a.ToSIMD()));
+			};
+
+			inline Vector4  operator/(float v) const {
+				return Vector4(_mm_div_ps(ToSIMD(), _mm_set1_ps(v)));
+			};
+#else
 			inline Vector4  operator+(const Vector4  &a) const {
 				return Vector4(x + a.x, y + a.y, z + a.z, w + a.w);
 			}
@@ -122,6 +180,7 @@ namespace NCL {
 			inline Vector4  operator/(float v) const {
 				return Vector4(x / v, y / v, z / v, w / v);
 			};
+#endif
 
 			inline constexpr void operator+=(const Vector4  &a) {
 				x += a.x;
@@ -1,4 +1,6 @@
 #include "Window.h"
+#include "Profiler.h"
+#include "FrameArena.h"
 #include <thread>
 
 #ifdef _WIN32
@@ -9,6 +11,8 @@
 #include "../Plugins/PlayStation4/PS4Window.h"
 #endif
 
+#include "NullWindow.h"
+
 #include "RendererBase.h"
 
 using namespace NCL;
@@ -43,6 +47,8 @@ Window* Window::CreateGameWindow(std::string title, int sizeX, int sizeY, bool f
 #ifdef __ORBIS__
 	return new PS4::PS4Window(title, sizeX, sizeY, fullScreen, offsetX, offsetY);
 #endif
+	//Nowhere to open a real window, but the game can still run without one
+	return new NullWindow(title, sizeX, sizeY, 1.0f / 60.0f);
 }
 
 void	Window::SetRenderer(RendererBase* r) {
@@ -57,6 +63,8 @@ void	Window::SetRenderer(RendererBase* r) {
 }
 
 bool	Window::UpdateWindow() {
+	NCL_PROFILE_FRAME();
+	FrameArena::EndFrame();
 	std::this_thread::yield();
 	timer->Tick();
 
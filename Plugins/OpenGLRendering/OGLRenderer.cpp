@@ -222,13 +222,13 @@ void OGLRenderer::BindTextureToShader(const TextureBase*t, const std::string& un
 	glUniform1i(slot, texUnit);
 }
 
-void OGLRenderer::DrawString(const std::string& text, const Vector2&pos, const Vector4& colour, float size) {
+void OGLRenderer::AddDebugString(const FrameString& text, const Vector2&pos, const Vector4& colour, float size) {
 	DebugString s;
 	s.colour	= colour;
 	s.pos		= pos;
 	s.size		= size;
 	s.text		= text;
-	debugStrings.emplace_back(s);
+	debugStrings.Get().emplace_back(std::move(s));
 }
 
 void OGLRenderer::DrawLine(const Vector3& start, const Vector3& end, const Vector4& colour) {
@@ -236,7 +236,7 @@ void OGLRenderer::DrawLine(const Vector3& start, const Vector3& end, const Vecto
 	l.start		= start;
 	l.end		= end;
 	l.colour	= colour;
-	debugLines.emplace_back(l);
+	debugLines.Get().emplace_back(l);
 }
 
 Matrix4 OGLRenderer::SetupDebugLineMatrix() const {
@@ -247,7 +247,7 @@ Matrix4 OGLRenderer::SetupDebugStringMatrix()const {
 }
 
 void OGLRenderer::DrawDebugData() {
-	if (debugStrings.empty() && debugLines.empty()) {
+	if (debugStrings.Get().empty() && debugLines.Get().empty()) {
 		return; //don't mess with OGL state if there's no point!
 	}
 	BindShader(debugShader);
@@ -265,14 +265,14 @@ void OGLRenderer::DrawDebugData() {
 
 	GLuint texSlot = glGetUniformLocation(boundShader->programID, "useTexture");
 
-	if (debugLines.size() > 0) {
+	if (debugLines.Get().size() > 0) {
 		pMat = SetupDebugLineMatrix();
 		glUniformMatrix4fv(matLocation, 1, false, pMat.array);
 		glUniform1i(texSlot, 0);
 		DrawDebugLines();
 	}
 
-	if (debugStrings.size() > 0) {
+	if (debugStrings.Get().size() > 0) {
 		pMat = SetupDebugStringMatrix();
 		glUniformMatrix4fv(matLocation, 1, false, pMat.array);
 		glUniform1i(texSlot, 1);
@@ -287,30 +287,43 @@ void OGLRenderer::DrawDebugData() {
 }
 
 void OGLRenderer::DrawDebugStrings() {
-	vector<Vector3> vertPos;
-	vector<Vector2> vertTex;
-	vector<Vector4> vertColours;
+	FrameVector<Vector3> vertPos;
+	FrameVector<Vector2> vertTex;
+	FrameVector<Vector4> vertColours;
+	FrameVector<DebugString>& strings = debugStrings.Get();
 
-	for (DebugString&s : debugStrings) {
+	//Arena memory isn't reused until the frame is over, so grow them just the once
+	size_t charCount = 0;
+	for (const DebugString& s : strings) {
+		charCount += s.text.length();
+	}
+	vertPos.reserve(charCount * 6);
+	vertTex.reserve(charCount * 6);
+	vertColours.reserve(charCount * 6);
+
+	for (DebugString&s : strings) {
 		font->BuildVerticesForString(s.text, s.pos, s.colour, s.size, vertPos, vertTex, vertColours);
 	}
 
-	debugTextMesh->SetVertexPositions(vertPos);
-	debugTextMesh->SetVertexTextureCoords(vertTex);
-	debugTextMesh->SetVertexColours(vertColours);
+	debugTextMesh->SetVertexPositions(vertPos.data(), vertPos.size());
+	debugTextMesh->SetVertexTextureCoords(vertTex.data(), vertTex.size());
+	debugTextMesh->SetVertexColours(vertColours.data(), vertColours.size());
 	debugTextMesh->UpdateGPUBuffers(0, vertPos.size());
 
 	BindMesh(debugTextMesh);
 	DrawBoundMesh();
 
-	debugStrings.clear();
+	strings.clear();
 }
 
 void OGLRenderer::DrawDebugLines() {
-	vector<Vector3> vertPos;
-	vector<Vector4> vertCol;
+	FrameVector<Vector3> vertPos;
+	FrameVector<Vector4> vertCol;
+	FrameVector<DebugLine>& lines = debugLines.Get();
+	vertPos.reserve(lines.size() * 2);
+	vertCol.reserve(lines.size() * 2);
 
-	for (DebugLine&s : debugLines) {
+	for (DebugLine&s : lines) {
 		vertPos.emplace_back(s.start);
 		vertPos.emplace_back(s.end);
 
@@ -318,14 +331,14 @@ void OGLRenderer::DrawDebugLines() {
 		vertCol.emplace_back(s.colour);
 	}
 
-	debugLinesMesh->SetVertexPositions(vertPos);
-	debugLinesMesh->SetVertexColours(vertCol);
+	debugLinesMesh->SetVertexPositions(vertPos.data(), vertPos.size());
+	debugLinesMesh->SetVertexColours(vertCol.data(), vertCol.size());
 	debugLinesMesh->UpdateGPUBuffers(0, vertPos.size());
 
 	BindMesh(debugLinesMesh);
 	DrawBoundMesh();
 
-	debugLines.clear();
+	lines.clear();
 }
 
 #ifdef _WIN32
@@ -59,8 +59,7 @@ namespace NCL {
 
 			virtual bool SetVerticalSync(VerticalSyncState s);
 
-			void DrawString(const std::string& text, const Vector2&pos, const Vector4& colour = Vector4(0.75f, 0.75f, 0.75f,1), float size = 20.0f );
-			void DrawLine(const Vector3& start, const Vector3& end, const Vector4& colour);
+			void DrawLine(const Vector3& start, const Vector3& end, const Vector4& colour) override;
 
 			virtual Matrix4 SetupDebugLineMatrix()	const;
 			virtual Matrix4 SetupDebugStringMatrix()const;
@@ -71,6 +70,8 @@ namespace NCL {
 			void EndFrame()		override;
 			void SwapBuffers()  override;
 
+			void AddDebugString(const FrameString& text, const Vector2& pos, const Vector4& colour, float size) override;
+
 			void DrawDebugData();
 			void DrawDebugStrings();
 			void DrawDebugLines();
@@ -90,7 +91,7 @@ namespace NCL {
 				Maths::Vector4 colour;
 				Maths::Vector2	pos;
 				float			size;
-				std::string		text;
+				FrameString		text;
 			};
 
 			struct DebugLine {
@@ -107,8 +108,9 @@ namespace NCL {
 
 			OGLShader*  debugShader;
 			SimpleFont* font;
-			std::vector<DebugString>	debugStrings;
-			std::vector<DebugLine>		debugLines;
+			//Both are filled and drawn in the same frame, so can live in the frame arena
+			FrameLocal<FrameVector<DebugString>>	debugStrings;
+			FrameLocal<FrameVector<DebugLine>>		debugLines;
 
 			bool initState;
 			bool forceValidDebugState;